@@ -0,0 +1,32 @@
+#ifndef ALIGNED_ALLOCATOR_H
+#define ALIGNED_ALLOCATOR_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace fuzzy_coco {
+
+using namespace std;
+
+// a minimal allocator returning ALIGNMENT-byte aligned memory, e.g. for SIMD-friendly vectors
+template <typename T, size_t ALIGNMENT = 64>
+struct AlignedAllocator {
+  using value_type = T;
+  template <typename U> struct rebind { using other = AlignedAllocator<U, ALIGNMENT>; };
+
+  AlignedAllocator() noexcept {}
+  template <typename U> AlignedAllocator(const AlignedAllocator<U, ALIGNMENT>&) noexcept {}
+
+  T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), align_val_t(ALIGNMENT))); }
+  void deallocate(T* p, size_t) noexcept { ::operator delete(p, align_val_t(ALIGNMENT)); }
+
+  template <typename U> bool operator==(const AlignedAllocator<U, ALIGNMENT>&) const noexcept { return true; }
+  template <typename U> bool operator!=(const AlignedAllocator<U, ALIGNMENT>&) const noexcept { return false; }
+};
+
+template <typename T, size_t ALIGNMENT = 64>
+using AlignedVector = vector<T, AlignedAllocator<T, ALIGNMENT>>;
+
+}
+#endif // ALIGNED_ALLOCATOR_H
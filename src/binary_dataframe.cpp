@@ -0,0 +1,169 @@
+#include "binary_dataframe.h"
+#include <fstream>
+#include <cstring>
+#include <climits>
+#include <memory>
+
+#include "mapped_file.h"
+
+using namespace fuzzy_coco;
+
+static_assert(sizeof(BinaryDataFrame::Header) == 64, "the binary header must be 64 bytes");
+
+static uint64_t align64(uint64_t offset) { return (offset + 63) / 64 * 64; }
+
+// a * b + c, or throws a runtime_error if it overflows
+static uint64_t checked_mul_add(uint64_t a, uint64_t b, uint64_t c = 0) {
+  if (b != 0 && a > (UINT64_MAX - c) / b)
+    THROW_WITH_LOCATION("Error in BinaryDataFrame::load(): bad layout (overflow)");
+  return a * b + c;
+}
+
+static uint64_t names_size(const vector<string>& names) {
+  uint64_t size = 0;
+  for (const auto& name : names) size += sizeof(uint32_t) + name.size();
+  return size;
+}
+
+static void write_names(ostream& out, const vector<string>& names) {
+  for (const auto& name : names) {
+    const uint32_t len = name.size();
+    out.write(reinterpret_cast<const char*>(&len), sizeof(len));
+    out.write(name.data(), len);
+  }
+}
+
+static void write_zeros(ostream& out, uint64_t nb) {
+  static const char ZEROS[64] = {0};
+  while (nb > 0) {
+    const uint64_t n = min(nb, uint64_t(sizeof(ZEROS)));
+    out.write(ZEROS, n);
+    nb -= n;
+  }
+}
+
+bool BinaryDataFrame::isBinary(const path& filename) {
+  ifstream in(filename, ios::binary);
+  char magic[sizeof(MAGIC)];
+  return in.read(magic, sizeof(magic)) && memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+void BinaryDataFrame::save(const DataFrame& df, ostream& out) {
+  const uint64_t nbrows = df.nbrows();
+  const uint64_t nbcols = df.nbcols();
+  const size_t elt_size = df.isFloat() ? sizeof(float) : sizeof(double);
+  const uint64_t stride = df.isFloat() ? DataFrame::paddedStride<float>(nbrows) : DataFrame::paddedStride<double>(nbrows);
+
+  Header header;
+  memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.endian_marker = ENDIAN_MARKER;
+  header.storage = df.getStorage();
+  header.has_rownames = df.hasRowNames();
+  header.nbrows = nbrows;
+  header.nbcols = nbcols;
+  header.stride = stride;
+  const uint64_t names_end = sizeof(Header) + names_size(df.colnames()) + names_size(df.rownames());
+  header.values_offset = align64(names_end);
+  header.bitmap_offset = header.values_offset + nbcols * stride * elt_size;
+
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  write_names(out, df.colnames());
+  write_names(out, df.rownames());
+  write_zeros(out, header.values_offset - names_end);
+
+  // values
+  for (uint64_t col = 0; col < nbcols; col++) {
+    const auto column = df[col];
+    if (df.isFloat())
+      out.write(reinterpret_cast<const char*>(column.floatData()), nbrows * elt_size);
+    else
+      out.write(reinterpret_cast<const char*>(column.data()), nbrows * elt_size);
+    write_zeros(out, (stride - nbrows) * elt_size);
+  }
+
+  // NA bitmap
+  vector<uint64_t> words((nbrows + 63) / 64);
+  for (uint64_t col = 0; col < nbcols; col++) {
+    fill(words.begin(), words.end(), 0);
+    for (uint64_t row = 0; row < nbrows; row++)
+      if (df.missing(row, col)) words[row / 64] |= uint64_t(1) << (row % 64);
+    out.write(reinterpret_cast<const char*>(words.data()), words.size() * sizeof(uint64_t));
+  }
+
+  if (!out) THROW_WITH_LOCATION("Error in BinaryDataFrame::save(): write error");
+}
+
+void BinaryDataFrame::save(const DataFrame& df, const path& filename) {
+  ofstream out(filename, ios::binary);
+  if (!out.is_open())
+    throw filesystem_error("error opening file", filename, error_code());
+  save(df, out);
+}
+
+// read nb names at offset, and return the offset after them
+static uint64_t read_names(const MappedFile& file, uint64_t offset, uint64_t nb, vector<string>& names) {
+  // N.B: each name takes at least its length
+  if (offset > file.size() || nb > (file.size() - offset) / sizeof(uint32_t))
+    THROW_WITH_LOCATION("Error in BinaryDataFrame::load(): truncated names");
+  names.resize(nb);
+  for (auto& name : names) {
+    uint32_t len;
+    if (offset + sizeof(len) > file.size())
+      THROW_WITH_LOCATION("Error in BinaryDataFrame::load(): truncated names");
+    memcpy(&len, file.data() + offset, sizeof(len));
+    offset += sizeof(len);
+    if (offset + len > file.size())
+      THROW_WITH_LOCATION("Error in BinaryDataFrame::load(): truncated names");
+    name.assign(file.data() + offset, len);
+    offset += len;
+  }
+  return offset;
+}
+
+DataFrame BinaryDataFrame::load(const path& filename) {
+  auto file = make_shared<MappedFile>(filename);
+
+  Header header;
+  if (file->size() < sizeof(header))
+    THROW_WITH_LOCATION("Error in BinaryDataFrame::load(): truncated header");
+  memcpy(&header, file->data(), sizeof(header));
+  if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+    THROW_WITH_LOCATION("Error in BinaryDataFrame::load(): not a binary dataframe");
+  if (header.version != VERSION)
+    THROW_WITH_LOCATION("Error in BinaryDataFrame::load(): unsupported version " + to_string(header.version));
+  if (header.endian_marker != ENDIAN_MARKER)
+    THROW_WITH_LOCATION("Error in BinaryDataFrame::load(): bad byte order");
+  if (header.storage != DataFrame::FLOAT64 && header.storage != DataFrame::FLOAT32)
+    THROW_WITH_LOCATION("Error in BinaryDataFrame::load(): bad storage");
+
+  // N.B: the DataFrame dimensions are ints, and so must be the padded stride
+  if (header.nbrows > uint64_t(INT_MAX - DataFrame::ALIGNMENT) || header.nbcols > uint64_t(INT_MAX))
+    THROW_WITH_LOCATION("Error in BinaryDataFrame::load(): too many rows or columns");
+
+  const auto storage = DataFrame::Storage(header.storage);
+  const size_t elt_size = storage == DataFrame::FLOAT32 ? sizeof(float) : sizeof(double);
+  const uint64_t stride = storage == DataFrame::FLOAT32 ?
+    DataFrame::paddedStride<float>(header.nbrows) : DataFrame::paddedStride<double>(header.nbrows);
+  if (header.stride != stride || header.values_offset % 64 != 0)
+    THROW_WITH_LOCATION("Error in BinaryDataFrame::load(): bad layout");
+  const uint64_t bitmap_offset = checked_mul_add(header.nbcols, stride * elt_size, header.values_offset);
+  const uint64_t end = checked_mul_add(header.nbcols, ((header.nbrows + 63) / 64) * sizeof(uint64_t), bitmap_offset);
+  if (header.bitmap_offset != bitmap_offset || end > file->size())
+    THROW_WITH_LOCATION("Error in BinaryDataFrame::load(): bad layout");
+
+  vector<string> colnames, rownames;
+  uint64_t offset = read_names(*file, sizeof(header), header.nbcols, colnames);
+  offset = read_names(*file, offset, header.has_rownames ? header.nbrows : 0, rownames);
+  if (offset > header.values_offset)
+    THROW_WITH_LOCATION("Error in BinaryDataFrame::load(): bad layout");
+
+  // N.B: zero-copy: the DataFrame keeps the file mapped
+  DataFrame df;
+  const char* values = file->data() + header.values_offset;
+  df.adoptValues(storage, header.nbrows, header.nbcols, values, file);
+  df.colnames(colnames);
+  df.rownames(rownames);
+
+  return df;
+}
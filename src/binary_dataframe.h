@@ -0,0 +1,59 @@
+#ifndef BINARY_DATAFRAME_H
+#define BINARY_DATAFRAME_H
+
+#include <string>
+#include <cstdint>
+#include <ostream>
+#include <filesystem>
+#include "dataframe.h"
+
+namespace fuzzy_coco {
+
+using namespace std;
+using namespace std::filesystem;
+
+// a native binary columnar format for the DataFrames, that is memory-mapped on load without copying the values:
+// loading is then almost instantaneous, whatever the size of the dataset. cf DataFrame::load()
+// The layout (little-endian) is:
+//   - a 64-byte header (cf Header)
+//   - the column names, then the row names if any: each as a uint32 length followed by the characters
+//   - at values_offset (a multiple of 64): the columns, as in a DataFrame: nbcols blocks of stride doubles
+//     or floats, according to storage, so that each column is 64-byte aligned. N.B: the missing values
+//     are stored as MISSING_DATA_DOUBLE or MISSING_DATA_FLOAT, and the padding values are 0
+//   - at bitmap_offset: the NA bitmap, for the other readers: for each column, (nbrows + 63) / 64 uint64 words,
+//     where the bit row % 64 of the word row / 64 is set iff the value is missing
+namespace BinaryDataFrame {
+
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    // to check the byte order, cf ENDIAN_MARKER
+    uint32_t endian_marker;
+    // cf DataFrame::Storage
+    uint32_t storage;
+    uint32_t has_rownames;
+    uint64_t nbrows;
+    uint64_t nbcols;
+    uint64_t stride;
+    uint64_t values_offset;
+    uint64_t bitmap_offset;
+  };
+
+  constexpr char MAGIC[8] = {'F', 'Z', 'C', 'O', 'C', 'O', 'D', 'F'};
+  constexpr uint32_t VERSION = 1;
+  constexpr uint32_t ENDIAN_MARKER = 0x01020304;
+
+  // whether filename is in the binary format (according to its magic)
+  bool isBinary(const path& filename);
+
+  void save(const DataFrame& df, ostream& out);
+  void save(const DataFrame& df, const path& filename);
+
+  // N.B: the values are shared with the memory mapping of the file (cf DataFrame::adoptValues()).
+  // Throws a runtime_error if the file is not valid
+  DataFrame load(const path& filename);
+
+};
+
+}
+#endif // BINARY_DATAFRAME_H
@@ -0,0 +1,243 @@
+#include "binary_fuzzy_system.h"
+#include <fstream>
+#include <cstring>
+
+#include "mapped_file.h"
+#include "digest.h"
+
+using namespace fuzzy_coco;
+
+static_assert(sizeof(BinaryFuzzySystem::Header) == 64, "the binary header must be 64 bytes");
+
+template <typename T>
+static void append(string& buffer, const T& value) {
+  buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void append_name(string& buffer, const string& name) {
+  append(buffer, uint32_t(name.size()));
+  buffer += name;
+}
+
+static void append_positions(string& buffer, const vector<FuzzyVariable>& vars) {
+  for (const auto& var : vars)
+    for (const auto& set : var.getSets())
+      append(buffer, set.getPosition());
+}
+
+static void append_names(string& buffer, const vector<FuzzyVariable>& vars) {
+  for (const auto& var : vars) {
+    append_name(buffer, var.getName());
+    for (const auto& set : var.getSets())
+      append_name(buffer, set.getName());
+  }
+}
+
+// the checksum of the header, with its checksum field zeroed, followed by the payload
+static uint64_t checksum(BinaryFuzzySystem::Header header, const char* payload, size_t size) {
+  header.checksum = 0;
+  const uint64_t hash = Digest::fnv1a64(reinterpret_cast<const uint8_t*>(&header), sizeof(header));
+  return Digest::fnv1a64(reinterpret_cast<const uint8_t*>(payload), size, hash);
+}
+
+bool BinaryFuzzySystem::isBinary(const path& filename) {
+  ifstream in(filename, ios::binary);
+  char magic[sizeof(MAGIC)];
+  return in.read(magic, sizeof(magic)) && memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+void BinaryFuzzySystem::save(const FuzzySystem& fs, ostream& out) {
+  const auto& db = fs.getDB();
+  const auto& table = fs.getRulesTable();
+  const int nb_rules = table.getNbRules();
+
+  string payload;
+  append_positions(payload, db.getInputVariables());
+  append_positions(payload, db.getOutputVariables());
+
+  // rules: N.B: the offsets are rebuilt from the ranges, so that the table layout does not matter
+  uint32_t nb_input_conditions = 0, nb_output_conditions = 0;
+  for (bool input : {true, false}) {
+    int32_t offset = 0;
+    append(payload, offset);
+    for (int i = 0; i < nb_rules; i++) {
+      offset += input ? table.getInputConditions(i).size() : table.getOutputConditions(i).size();
+      append(payload, offset);
+    }
+    for (int i = 0; i < nb_rules; i++) {
+      for (const auto& ci : input ? table.getInputConditions(i) : table.getOutputConditions(i)) {
+        append(payload, int32_t(ci.var_idx));
+        append(payload, int32_t(ci.set_idx));
+      }
+    }
+    (input ? nb_input_conditions : nb_output_conditions) = offset;
+  }
+
+  for (int set_idx : fs.getDefaultRulesOutputSets())
+    append(payload, int32_t(set_idx));
+
+  append_names(payload, db.getInputVariables());
+  append_names(payload, db.getOutputVariables());
+
+  Header header;
+  memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.endian_marker = ENDIAN_MARKER;
+  header.tnorm = uint32_t(fs.getTNorm());
+  header.nb_input_vars = db.getNbInputVars();
+  header.nb_input_sets = db.getNbInputSets();
+  header.nb_output_vars = db.getNbOutputVars();
+  header.nb_output_sets = db.getNbOutputSets();
+  header.nb_rules = nb_rules;
+  header.nb_input_conditions = nb_input_conditions;
+  header.nb_output_conditions = nb_output_conditions;
+  header.payload_size = payload.size();
+  header.checksum = checksum(header, payload.data(), payload.size());
+
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(payload.data(), payload.size());
+
+  if (!out) THROW_WITH_LOCATION("Error in BinaryFuzzySystem::save(): write error");
+}
+
+void BinaryFuzzySystem::save(const FuzzySystem& fs, const path& filename) {
+  ofstream out(filename, ios::binary);
+  if (!out.is_open())
+    throw filesystem_error("error opening file", filename, error_code());
+  save(fs, out);
+}
+
+namespace {
+  // a bounds-checked sequential reader of the payload
+  struct PayloadReader {
+    const char* p;
+    const char* end;
+
+    void check(size_t size) const {
+      if (size > size_t(end - p))
+        THROW_WITH_LOCATION("Error in BinaryFuzzySystem::load(): truncated payload");
+    }
+
+    template <typename T>
+    T read() {
+      check(sizeof(T));
+      T value;
+      memcpy(&value, p, sizeof(T));
+      p += sizeof(T);
+      return value;
+    }
+
+    template <typename T>
+    void read(vector<T>& values, size_t nb) {
+      check(nb * sizeof(T));
+      values.resize(nb);
+      if (nb > 0) memcpy(values.data(), p, nb * sizeof(T));
+      p += nb * sizeof(T);
+    }
+
+    string readName() {
+      const uint32_t len = read<uint32_t>();
+      check(len);
+      string name(p, len);
+      p += len;
+      return name;
+    }
+  };
+}
+
+static vector<FuzzyVariable> read_variables(PayloadReader& reader, int nb_vars, int nb_sets, const vector<double>& positions) {
+  vector<FuzzyVariable> vars;
+  vars.reserve(nb_vars);
+  for (int var_idx = 0; var_idx < nb_vars; var_idx++) {
+    string name = reader.readName();
+    vector<FuzzySet> sets;
+    sets.reserve(nb_sets);
+    for (int set_idx = 0; set_idx < nb_sets; set_idx++)
+      sets.emplace_back(reader.readName(), positions[var_idx * nb_sets + set_idx]);
+    vars.emplace_back(std::move(name), std::move(sets));
+  }
+  return vars;
+}
+
+// check the CSR offsets and the conditions indexes, and convert them to a ConditionIndexes
+static ConditionIndexes check_conditions(const vector<int32_t>& offsets, const vector<int32_t>& conds, int nb_vars, int nb_sets) {
+  const int nb = conds.size() / 2;
+  if (offsets.front() != 0 || offsets.back() != nb)
+    THROW_WITH_LOCATION("Error in BinaryFuzzySystem::load(): bad rules offsets");
+  for (size_t i = 1; i < offsets.size(); i++)
+    if (offsets[i] < offsets[i - 1])
+      THROW_WITH_LOCATION("Error in BinaryFuzzySystem::load(): bad rules offsets");
+
+  ConditionIndexes cis;
+  cis.reserve(nb);
+  for (int i = 0; i < nb; i++) {
+    const int var_idx = conds[2 * i], set_idx = conds[2 * i + 1];
+    if (var_idx < 0 || var_idx >= nb_vars || set_idx < 0 || set_idx >= nb_sets)
+      THROW_WITH_LOCATION("Error in BinaryFuzzySystem::load(): bad rule condition");
+    cis.emplace_back(var_idx, set_idx);
+  }
+  return cis;
+}
+
+FuzzySystem BinaryFuzzySystem::load(string_view content) {
+  Header header;
+  if (content.size() < sizeof(header))
+    THROW_WITH_LOCATION("Error in BinaryFuzzySystem::load(): truncated header");
+  memcpy(&header, content.data(), sizeof(header));
+  if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+    THROW_WITH_LOCATION("Error in BinaryFuzzySystem::load(): not a binary fuzzy system");
+  if (header.version != VERSION)
+    THROW_WITH_LOCATION("Error in BinaryFuzzySystem::load(): unsupported version " + to_string(header.version));
+  if (header.endian_marker != ENDIAN_MARKER)
+    THROW_WITH_LOCATION("Error in BinaryFuzzySystem::load(): bad byte order");
+  if (header.payload_size != content.size() - sizeof(header))
+    THROW_WITH_LOCATION("Error in BinaryFuzzySystem::load(): truncated payload");
+  const char* payload = content.data() + sizeof(header);
+  if (checksum(header, payload, header.payload_size) != header.checksum)
+    THROW_WITH_LOCATION("Error in BinaryFuzzySystem::load(): bad checksum");
+  if (header.tnorm > uint32_t(TNorm::LUKASIEWICZ))
+    THROW_WITH_LOCATION("Error in BinaryFuzzySystem::load(): bad t-norm");
+  if (header.nb_input_vars == 0 || header.nb_input_sets == 0 || header.nb_output_vars == 0 || header.nb_output_sets == 0)
+    THROW_WITH_LOCATION("Error in BinaryFuzzySystem::load(): bad dimensions");
+
+  PayloadReader reader{payload, payload + header.payload_size};
+  vector<double> in_positions, out_positions;
+  reader.read(in_positions, size_t(header.nb_input_vars) * header.nb_input_sets);
+  reader.read(out_positions, size_t(header.nb_output_vars) * header.nb_output_sets);
+
+  vector<int32_t> in_offsets, in_conds, out_offsets, out_conds;
+  reader.read(in_offsets, size_t(header.nb_rules) + 1);
+  reader.read(in_conds, size_t(header.nb_input_conditions) * 2);
+  reader.read(out_offsets, size_t(header.nb_rules) + 1);
+  reader.read(out_conds, size_t(header.nb_output_conditions) * 2);
+  vector<int32_t> default_rules;
+  reader.read(default_rules, header.nb_output_vars);
+
+  auto input_vars = read_variables(reader, header.nb_input_vars, header.nb_input_sets, in_positions);
+  auto output_vars = read_variables(reader, header.nb_output_vars, header.nb_output_sets, out_positions);
+  if (reader.p != reader.end)
+    THROW_WITH_LOCATION("Error in BinaryFuzzySystem::load(): bad payload size");
+
+  const auto in_cis = check_conditions(in_offsets, in_conds, header.nb_input_vars, header.nb_input_sets);
+  const auto out_cis = check_conditions(out_offsets, out_conds, header.nb_output_vars, header.nb_output_sets);
+
+  FuzzySystem fs(FuzzyVariablesDB(std::move(input_vars), std::move(output_vars)));
+  fs.resetRules(header.nb_rules);
+  for (uint32_t i = 0; i < header.nb_rules; i++)
+    fs.addRule(
+      {in_cis.data() + in_offsets[i], in_cis.data() + in_offsets[i + 1]},
+      {out_cis.data() + out_offsets[i], out_cis.data() + out_offsets[i + 1]});
+
+  for (int32_t set_idx : default_rules)
+    if (set_idx < 0 || set_idx >= int32_t(header.nb_output_sets))
+      THROW_WITH_LOCATION("Error in BinaryFuzzySystem::load(): bad default rule");
+  fs.setDefaultRulesConditions(vector<int>(default_rules.begin(), default_rules.end()));
+  fs.setTNorm(TNorm(header.tnorm));
+
+  return fs;
+}
+
+FuzzySystem BinaryFuzzySystem::load(const path& filename) {
+  MappedFile file(filename);
+  return load(file.view());
+}
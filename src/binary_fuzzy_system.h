@@ -0,0 +1,69 @@
+#ifndef BINARY_FUZZY_SYSTEM_H
+#define BINARY_FUZZY_SYSTEM_H
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <ostream>
+#include <filesystem>
+#include "fuzzy_system.h"
+
+namespace fuzzy_coco {
+
+using namespace std;
+using namespace std::filesystem;
+
+// a compact binary format for the fuzzy systems, that loads without any parsing: the tables are read
+// directly into the FuzzySystem (positions, rules conditions table, default rules).
+// It stores only the fuzzy system, i.e. what is needed for the predictions, not the fit results nor the params.
+// N.B: save() reads the tables directly rather than going through FuzzySystem::describe(), which would mean
+// parsing the descriptions back; the round trip is checked against describe() by the tests.
+// The layout (little-endian) is:
+//   - a 64-byte header (cf Header)
+//   - the payload. The header (with its checksum field zeroed) and the payload are checksummed
+//     (FNV-1a, cf Digest::fnv1a64()):
+//     - the input sets positions, nb_input_vars x nb_input_sets doubles, then the output ones
+//     - the rules, as in a FuzzyRulesTable: nb_rules + 1 int32 input offsets, then the input conditions
+//       as (var_idx, set_idx) int32 pairs, then the same for the output conditions
+//     - the default rules: nb_output_vars int32 set indexes
+//     - the names: for each input variable, its name then its sets names, then the same for the output
+//       variables. Each name is a uint32 length followed by the characters
+namespace BinaryFuzzySystem {
+
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    // to check the byte order, cf ENDIAN_MARKER
+    uint32_t endian_marker;
+    // cf TNorm
+    uint32_t tnorm;
+    uint32_t nb_input_vars;
+    uint32_t nb_input_sets;
+    uint32_t nb_output_vars;
+    uint32_t nb_output_sets;
+    uint32_t nb_rules;
+    uint32_t nb_input_conditions;
+    uint32_t nb_output_conditions;
+    uint64_t payload_size;
+    uint64_t checksum;
+  };
+
+  constexpr char MAGIC[8] = {'F', 'Z', 'C', 'O', 'C', 'O', 'F', 'S'};
+  // N.B: version 2 also checksums the header
+  constexpr uint32_t VERSION = 2;
+  constexpr uint32_t ENDIAN_MARKER = 0x01020304;
+
+  // whether filename is in the binary format (according to its magic)
+  bool isBinary(const path& filename);
+
+  void save(const FuzzySystem& fs, ostream& out);
+  void save(const FuzzySystem& fs, const path& filename);
+
+  // Throws a runtime_error if the content is not valid (e.g. truncated, or bad checksum)
+  FuzzySystem load(string_view content);
+  FuzzySystem load(const path& filename);
+
+};
+
+}
+#endif // BINARY_FUZZY_SYSTEM_H
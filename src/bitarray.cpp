@@ -3,21 +3,77 @@
 
 using namespace fuzzy_coco;
 
-int BitArrayUtils::decode_number(BitArray::const_iterator it, int nb_bits) {
-    int decoded = 0;
-    for (int i = 0; i < nb_bits; i++) {
-        decoded += (*it) << i;
-        it++;
+BitArray::BitArray(initializer_list<bool> values) : BitArray(values.size()) {
+    size_t pos = 0;
+    for (bool value : values) set(pos++, value);
+}
+
+void BitArray::resize(size_t nb, bool value) {
+    const size_t old_size = _size;
+    _words.resize((nb + WORD_BITS - 1) / WORD_BITS, 0);
+    _size = nb;
+    if (nb < old_size) {
+        trim();
+        return;
     }
-    return decoded;
+    if (!value) return;
+
+    // set the new bits: first the end of the old last word, then whole words
+    size_t pos = old_size;
+    for (; pos < nb && pos % WORD_BITS; pos++) set(pos, true);
+    for (size_t w = pos / WORD_BITS; w < _words.size(); w++) _words[w] = ~word_t(0);
+    trim();
+}
+
+// N.B: the words after the one containing from are swapped as a whole, the first one using a mask
+void BitArray::swapTail(BitArray& other, size_t from) {
+    assert(other.size() == size());
+    assert(from <= size());
+    if (from == size()) return;
+
+    size_t w = from / WORD_BITS;
+    const word_t mask = ~lowMask(from % WORD_BITS);
+    const word_t diff = (_words[w] ^ other._words[w]) & mask;
+    _words[w] ^= diff;
+    other._words[w] ^= diff;
+
+    const size_t nb_words = _words.size();
+    for (w++; w < nb_words; w++) swap(_words[w], other._words[w]);
+}
+
+int BitArray::popcount(word_t w) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(w);
+#else
+    // cf https://en.wikipedia.org/wiki/Hamming_weight
+    w = w - ((w >> 1) & 0x5555555555555555ULL);
+    w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+    w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return int((w * 0x0101010101010101ULL) >> 56);
+#endif
 }
 
+size_t BitArray::count() const {
+    size_t nb = 0;
+    for (word_t w : _words) nb += popcount(w);
+    return nb;
+}
+
+size_t BitArray::hamming(const BitArray& other) const {
+    assert(other.size() == size());
+    const size_t nb_words = _words.size();
+    size_t nb = 0;
+    for (size_t w = 0; w < nb_words; w++) nb += popcount(_words[w] ^ other._words[w]);
+    return nb;
+}
+
+int BitArrayUtils::decode_number(BitArray::const_iterator it, int nb_bits) {
+    return int(it.array()->getField(it.pos(), nb_bits));
+}
+
+// N.B: the nb_bits least significant bits of number are stored, as before for negative numbers
 void BitArrayUtils::encode_number(int number, BitArray::iterator it, int nb_bits) {
-    int remainder = number;
-    for (int i = 0; i < nb_bits; i++) {
-        *it++ = remainder & 1;
-        remainder >>= 1;
-    }
+    it.array()->setField(it.pos(), nb_bits, BitArray::word_t(int64_t(number)));
 }
 
 void BitArrayUtils::randomize(BitArray& bits, RandomGenerator& rng) {
@@ -27,7 +83,7 @@ void BitArrayUtils::randomize(BitArray& bits, RandomGenerator& rng) {
     rng.random(0, 1, int(nb), probs); // batch
 
     for (size_t i = 0; i < nb; i++) {
-      bits[i] = probs[i];
+      bits.set(i, probs[i]);
     }
 }
 
@@ -38,3 +94,11 @@ namespace fuzzy_coco {
     return out;
   }
 }//KCOV IGNORE
+
+// cf boost::hash_combine
+size_t std::hash<BitArray>::operator()(const BitArray& bits) const {
+    uint64_t seed = bits.size();
+    for (auto w : bits.words())
+      seed ^= w + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    return size_t(seed);
+}
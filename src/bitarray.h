@@ -3,22 +3,196 @@
 
 #include <vector>
 #include <iostream>
+#include <iterator>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include <initializer_list>
 #include "random_generator.h"
 
 namespace fuzzy_coco {
 
 using namespace std;
-using BitArray = std::vector<bool>;
 
-// decode a number encoded as bits (actually on bools)
+// a fixed-size array of bits, packed in 64-bit words
+// N.B: bit i is stored in word i / 64, at bit position i % 64. This is the same logical layout as
+// the std::vector<bool> it replaces: bit i is the i-th bit, so the codecs encoding is unchanged.
+// It behaves mostly like a vector<bool> (proxy references, iterators on bit positions), but also
+// provides word-level operations: fixed-width fields, tail swapping, popcount...
+// N.B: the unused bits of the last word are always 0
+class BitArray {
+public:
+  using word_t = uint64_t;
+  static constexpr int WORD_BITS = 64;
+
+  // a proxy reference on a bit
+  class reference {
+  public:
+    reference(BitArray& bits, size_t pos) : _bits(bits), _pos(pos) {}
+    operator bool() const { return _bits.test(_pos); }
+    reference& operator=(bool value) { _bits.set(_pos, value); return *this; }
+    reference& operator=(const reference& ref) { return *this = bool(ref); }
+    void flip() { _bits.flip(_pos); }
+  private:
+    BitArray& _bits;
+    size_t _pos;
+  };
+
+  // an iterator on the bit positions
+  template <bool CONST>
+  class base_iterator {
+  public:
+    using array_type = conditional_t<CONST, const BitArray, BitArray>;
+    using iterator_category = random_access_iterator_tag;
+    using value_type = bool;
+    using difference_type = ptrdiff_t;
+    using pointer = void;
+    using reference = conditional_t<CONST, bool, BitArray::reference>;
+
+    base_iterator() {}
+    base_iterator(array_type* bits, size_t pos) : _bits(bits), _pos(pos) {}
+    // iterator --> const_iterator
+    template <bool C = CONST, typename = enable_if_t<C>>
+    base_iterator(const base_iterator<false>& it) : _bits(it.array()), _pos(it.pos()) {}
+
+    reference operator*() const { return (*_bits)[_pos]; }
+    reference operator[](difference_type n) const { return (*_bits)[_pos + n]; }
+
+    base_iterator& operator++() { _pos++; return *this; }
+    base_iterator operator++(int) { auto it = *this; _pos++; return it; }
+    base_iterator& operator--() { _pos--; return *this; }
+    base_iterator operator--(int) { auto it = *this; _pos--; return it; }
+    base_iterator& operator+=(difference_type n) { _pos += n; return *this; }
+    base_iterator& operator-=(difference_type n) { _pos -= n; return *this; }
+    base_iterator operator+(difference_type n) const { return {_bits, _pos + n}; }
+    base_iterator operator-(difference_type n) const { return {_bits, _pos - n}; }
+    difference_type operator-(const base_iterator& it) const { return difference_type(_pos) - difference_type(it._pos); }
+
+    bool operator==(const base_iterator& it) const { return _pos == it._pos && _bits == it._bits; }
+    bool operator!=(const base_iterator& it) const { return !(*this == it); }
+    bool operator<(const base_iterator& it) const { return _pos < it._pos; }
+
+    // the underlying array and bit position: for word-level access
+    array_type* array() const { return _bits; }
+    size_t pos() const { return _pos; }
+
+  private:
+    array_type* _bits = nullptr;
+    size_t _pos = 0;
+  };
+  using iterator = base_iterator<false>;
+  using const_iterator = base_iterator<true>;
+
+public:
+  BitArray() {}
+  BitArray(size_t nb, bool value = false) { resize(nb, value); }
+  BitArray(initializer_list<bool> values);
+
+  size_t size() const { return _size; }
+  bool empty() const { return _size == 0; }
+  void resize(size_t nb, bool value = false);
+  void clear() { _words.clear(); _size = 0; }
+
+  // ========== bit access ==========
+  bool test(size_t pos) const {
+    assert(pos < _size);
+    return (_words[pos / WORD_BITS] >> (pos % WORD_BITS)) & 1;
+  }
+  void set(size_t pos, bool value) {
+    assert(pos < _size);
+    const word_t mask = word_t(1) << (pos % WORD_BITS);
+    if (value) _words[pos / WORD_BITS] |= mask;
+    else _words[pos / WORD_BITS] &= ~mask;
+  }
+  void flip(size_t pos) {
+    assert(pos < _size);
+    _words[pos / WORD_BITS] ^= word_t(1) << (pos % WORD_BITS);
+  }
+  bool operator[](size_t pos) const { return test(pos); }
+  reference operator[](size_t pos) { return {*this, pos}; }
+
+  iterator begin() { return {this, 0}; }
+  iterator end() { return {this, _size}; }
+  const_iterator begin() const { return {this, 0}; }
+  const_iterator end() const { return {this, _size}; }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  // ========== word-level operations ==========
+
+  // the nb_bits (<= 64) bits starting at pos, bit pos being the least significant bit
+  word_t getField(size_t pos, int nb_bits) const {
+    assert(nb_bits >= 0 && nb_bits <= WORD_BITS && pos + nb_bits <= _size);
+    if (nb_bits == 0) return 0;
+    const size_t w = pos / WORD_BITS;
+    const int offset = pos % WORD_BITS;
+    word_t value = _words[w] >> offset;
+    // the field spans two words
+    if (offset + nb_bits > WORD_BITS) value |= _words[w + 1] << (WORD_BITS - offset);
+    return value & lowMask(nb_bits);
+  }
+
+  // store the nb_bits (<= 64) least significant bits of value starting at pos
+  void setField(size_t pos, int nb_bits, word_t value) {
+    assert(nb_bits >= 0 && nb_bits <= WORD_BITS && pos + nb_bits <= _size);
+    if (nb_bits == 0) return;
+    const word_t mask = lowMask(nb_bits);
+    value &= mask;
+    const size_t w = pos / WORD_BITS;
+    const int offset = pos % WORD_BITS;
+    _words[w] = (_words[w] & ~(mask << offset)) | (value << offset);
+    if (offset + nb_bits > WORD_BITS) {
+      const int shift = WORD_BITS - offset;
+      _words[w + 1] = (_words[w + 1] & ~(mask >> shift)) | (value >> shift);
+    }
+  }
+
+  // swap the bits [from, size()[ with those of other, that must have the same size
+  void swapTail(BitArray& other, size_t from);
+
+  // the number of bits set
+  size_t count() const;
+  // the number of differing bits with other, that must have the same size
+  size_t hamming(const BitArray& other) const;
+
+  const vector<word_t>& words() const { return _words; }
+
+  bool operator==(const BitArray& other) const { return _size == other._size && _words == other._words; }
+  bool operator!=(const BitArray& other) const { return !(*this == other); }
+
+  // a mask with the nb_bits (<= 64) least significant bits set
+  static word_t lowMask(int nb_bits) { return nb_bits >= WORD_BITS ? ~word_t(0) : (word_t(1) << nb_bits) - 1; }
+  static int popcount(word_t w);
+
+private:
+  // reset the unused bits of the last word
+  void trim() {
+    const int nb_used = _size % WORD_BITS;
+    if (nb_used) _words.back() &= lowMask(nb_used);
+  }
+
+private:
+  vector<word_t> _words;
+  size_t _size = 0;
+};
+
+// decode a number encoded as bits
 namespace BitArrayUtils {
-    
+
     int decode_number(BitArray::const_iterator bits, int nb_bits);
     void encode_number(int number, BitArray::iterator bits, int nb_bits);
     void randomize(BitArray& bits, RandomGenerator& rng);
+    // cf BitArray::hamming()
+    inline size_t hamming_distance(const BitArray& a, const BitArray& b) { return a.hamming(b); }
 };
 
 ostream& operator<<(ostream& out, const BitArray& bits);
 
 }
+
+namespace std {
+  template <> struct hash<fuzzy_coco::BitArray> {
+    size_t operator()(const fuzzy_coco::BitArray& bits) const;
+  };
+}
 #endif // BITARRAY_H
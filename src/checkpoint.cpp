@@ -0,0 +1,230 @@
+#include "checkpoint.h"
+#include <fstream>
+#include <sstream>
+#include <cstring>
+
+#include "mapped_file.h"
+#include "digest.h"
+
+using namespace fuzzy_coco;
+
+static_assert(sizeof(Checkpoint::Header) == 64, "the checkpoint header must be 64 bytes");
+
+template <typename T>
+static void append(string& buffer, const T& value) {
+  buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static void append_string(string& buffer, const string& s) {
+  append(buffer, uint32_t(s.size()));
+  buffer += s;
+}
+
+static void append_genome(string& buffer, const Genome& genome) {
+  append(buffer, uint64_t(genome.size()));
+  for (auto word : genome.words())
+    append(buffer, uint64_t(word));
+}
+
+static void append_genomes(string& buffer, const Genomes& genomes) {
+  append(buffer, uint32_t(genomes.size()));
+  for (const auto& genome : genomes)
+    append_genome(buffer, genome);
+}
+
+static void append_generation(string& buffer, const Generation& gen) {
+  assert(gen.fitnesses.size() == gen.individuals.size());
+  append(buffer, int32_t(gen._elite_size));
+  append(buffer, gen.fitness);
+  append_genomes(buffer, gen.individuals);
+  for (double fitness : gen.fitnesses)
+    append(buffer, fitness);
+  append_genomes(buffer, gen.elite);
+}
+
+static uint64_t checksum(const char* data, size_t size) {
+  return Digest::fnv1a64(reinterpret_cast<const uint8_t*>(data), size);
+}
+
+string Checkpoint::describeParams(const FuzzyCocoParams& params) {
+  FuzzyCocoParams p = params;
+  p.global_params.nb_threads = 1;
+  // the stopping criteria
+  auto& gp = p.global_params;
+  gp.max_generations = 0;
+  gp.max_fitness = 0;
+  gp.max_seconds = 0;
+  gp.max_evaluations = 0;
+  gp.stagnation_generations = 0;
+  ostringstream out;
+  out << p.describe();
+  return out.str();
+}
+
+void Checkpoint::checkParams(const State& state, const FuzzyCocoParams& params) {
+  if (state.params != describeParams(params))
+    THROW_WITH_LOCATION("Error in Checkpoint::checkParams(): the checkpoint was made with different params");
+}
+
+void Checkpoint::save(const State& state, ostream& out) {
+  string payload;
+  append_string(payload, state.params);
+  append_string(payload, state.rng_state);
+  append(payload, state.elapsed_seconds);
+  append(payload, int32_t(state.last_improvement));
+  for (const auto& coev : state.coevolutions) {
+    append_string(payload, coev.rng_state);
+    append(payload, int64_t(coev.nb_evaluations));
+    append(payload, coev.best_fitness);
+    append_genome(payload, coev.best.first);
+    append_genome(payload, coev.best.second);
+    append(payload, int32_t(coev.generation.generation_number));
+    append(payload, coev.generation.fitness);
+    append_generation(payload, coev.generation.left_gen);
+    append_generation(payload, coev.generation.right_gen);
+  }
+
+  Header header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.endian_marker = ENDIAN_MARKER;
+  header.nb_coevolutions = state.coevolutions.size();
+  header.generation_number = state.coevolutions.empty() ? 0 : state.coevolutions.front().generation.generation_number;
+  header.payload_size = payload.size();
+  header.checksum = checksum(payload.data(), payload.size());
+
+  out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out.write(payload.data(), payload.size());
+
+  if (!out) THROW_WITH_LOCATION("Error in Checkpoint::save(): write error");
+}
+
+void Checkpoint::save(const State& state, const path& filename) {
+  path tmp = filename;
+  tmp += ".tmp";
+  {
+    ofstream out(tmp, ios::binary);
+    if (!out.is_open())
+      throw filesystem_error("error opening file", tmp, error_code());
+    save(state, out);
+    out.close();
+    if (!out) THROW_WITH_LOCATION("Error in Checkpoint::save(): write error");
+  }
+  // N.B: the previous checkpoint is only replaced by a complete one
+  filesystem::rename(tmp, filename);
+}
+
+namespace {
+  // a bounds-checked sequential reader of the payload
+  struct PayloadReader {
+    const char* p;
+    const char* end;
+
+    void check(size_t size) const {
+      if (size > size_t(end - p))
+        THROW_WITH_LOCATION("Error in Checkpoint::load(): truncated payload");
+    }
+
+    template <typename T>
+    T read() {
+      check(sizeof(T));
+      T value;
+      memcpy(&value, p, sizeof(T));
+      p += sizeof(T);
+      return value;
+    }
+
+    string readString() {
+      const uint32_t len = read<uint32_t>();
+      check(len);
+      string s(p, len);
+      p += len;
+      return s;
+    }
+
+    Genome readGenome() {
+      const uint64_t nb_bits = read<uint64_t>();
+      const uint64_t nb_words = (nb_bits + 63) / 64;
+      check(nb_words * sizeof(uint64_t));
+      Genome genome(nb_bits);
+      for (uint64_t i = 0; i < nb_words; i++)
+        genome.setField(i * 64, min<uint64_t>(64, nb_bits - i * 64), read<uint64_t>());
+      return genome;
+    }
+
+    Genomes readGenomes() {
+      const uint32_t nb = read<uint32_t>();
+      // N.B: a genome takes at least 8 bytes
+      check(size_t(nb) * sizeof(uint64_t));
+      Genomes genomes;
+      genomes.reserve(nb);
+      for (uint32_t i = 0; i < nb; i++)
+        genomes.push_back(readGenome());
+      return genomes;
+    }
+
+    Generation readGeneration() {
+      Generation gen(read<int32_t>());
+      gen.fitness = read<double>();
+      gen.individuals = readGenomes();
+      gen.fitnesses.resize(gen.individuals.size());
+      for (auto& fitness : gen.fitnesses)
+        fitness = read<double>();
+      gen.elite = readGenomes();
+      if (gen._elite_size < 0 || size_t(gen._elite_size) != gen.elite.size() || gen.elite.size() > gen.individuals.size())
+        THROW_WITH_LOCATION("Error in Checkpoint::load(): bad elite");
+      return gen;
+    }
+  };
+}
+
+Checkpoint::State Checkpoint::load(string_view content) {
+  Header header;
+  if (content.size() < sizeof(header))
+    THROW_WITH_LOCATION("Error in Checkpoint::load(): truncated header");
+  memcpy(&header, content.data(), sizeof(header));
+  if (memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0)
+    THROW_WITH_LOCATION("Error in Checkpoint::load(): not a checkpoint");
+  if (header.version != VERSION)
+    THROW_WITH_LOCATION("Error in Checkpoint::load(): unsupported version " + to_string(header.version));
+  if (header.endian_marker != ENDIAN_MARKER)
+    THROW_WITH_LOCATION("Error in Checkpoint::load(): bad byte order");
+  if (header.payload_size != content.size() - sizeof(header))
+    THROW_WITH_LOCATION("Error in Checkpoint::load(): truncated payload");
+  const char* payload = content.data() + sizeof(header);
+  if (checksum(payload, header.payload_size) != header.checksum)
+    THROW_WITH_LOCATION("Error in Checkpoint::load(): bad checksum");
+
+  // N.B: a coevolution takes more than 8 bytes
+  if (header.nb_coevolutions > header.payload_size / 8)
+    THROW_WITH_LOCATION("Error in Checkpoint::load(): bad number of coevolutions");
+
+  PayloadReader reader{payload, payload + header.payload_size};
+  State state;
+  state.params = reader.readString();
+  state.rng_state = reader.readString();
+  state.elapsed_seconds = reader.read<double>();
+  state.last_improvement = reader.read<int32_t>();
+  state.coevolutions.resize(header.nb_coevolutions);
+  for (auto& coev : state.coevolutions) {
+    coev.rng_state = reader.readString();
+    coev.nb_evaluations = reader.read<int64_t>();
+    coev.best_fitness = reader.read<double>();
+    coev.best.first = reader.readGenome();
+    coev.best.second = reader.readGenome();
+    coev.generation.generation_number = reader.read<int32_t>();
+    coev.generation.fitness = reader.read<double>();
+    coev.generation.left_gen = reader.readGeneration();
+    coev.generation.right_gen = reader.readGeneration();
+  }
+  if (reader.p != reader.end)
+    THROW_WITH_LOCATION("Error in Checkpoint::load(): bad payload size");
+
+  return state;
+}
+
+Checkpoint::State Checkpoint::load(const path& filename) {
+  MappedFile file(filename);
+  return load(file.view());
+}
@@ -0,0 +1,101 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <vector>
+#include <filesystem>
+#include "coevolution_engine.h"
+#include "fuzzy_coco_params.h"
+
+namespace fuzzy_coco {
+
+using namespace std;
+using namespace std::filesystem;
+
+// binary checkpoints of the coevolution runs, to resume a run so that its results are identical to those of an
+// uninterrupted run. A checkpoint holds the full state of each coevolution (one, or one per island, cf IslandModel):
+// both populations with their fitnesses and elites, the best pair found so far and the state of its RandomGenerator.
+// The layout (little-endian) is:
+//   - a 64-byte header (cf Header)
+//   - the payload, checksummed (FNV-1a, cf Digest::fnv1a64()):
+//     - the params and the master random generator state, as strings (a uint32 length followed by the characters)
+//     - the elapsed seconds (double) and the generation of the last improvement of the best fitness (int32)
+//     - for each coevolution: its random generator state, its number of evaluations (int64),
+//       its best fitness (double) and best pair (2 genomes),
+//       its generation number (int32) and fitness (double), then the rules generation and the MFs generation.
+//       A generation is its elite size (int32), its fitness (double), the individuals (a uint32 count then
+//       the genomes), their fitnesses (doubles) and the elite (a uint32 count then the genomes).
+//       A genome is its number of bits (uint64) followed by its 64-bit words
+namespace Checkpoint {
+
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    // to check the byte order, cf ENDIAN_MARKER
+    uint32_t endian_marker;
+    uint32_t nb_coevolutions;
+    // the generation number of the first coevolution, for information
+    int32_t generation_number;
+    uint64_t payload_size;
+    uint64_t checksum;
+    char reserved[24];
+  };
+
+  constexpr char MAGIC[8] = {'F', 'Z', 'C', 'O', 'C', 'O', 'C', 'K'};
+  constexpr uint32_t VERSION = 2;
+  constexpr uint32_t ENDIAN_MARKER = 0x01020304;
+
+  // the state of a coevolution
+  struct CoevolutionState {
+    CoevGeneration generation;
+    pair<Genome, Genome> best;
+    double best_fitness = 0;
+    // cf CoevolutionFitnessMethod::getNbEvaluations()
+    long nb_evaluations = 0;
+    // cf RandomGenerator::getState()
+    string rng_state;
+  };
+
+  struct State {
+    // the params of the run, cf describeParams()
+    string params;
+    // the state of the master random generator, for the island model
+    string rng_state;
+    // cf StoppingCriteria
+    double elapsed_seconds = 0;
+    int last_improvement = 0;
+    vector<CoevolutionState> coevolutions;
+  };
+
+  // how to checkpoint a run
+  struct Options {
+    // the checkpoint file. Empty to disable the checkpoints
+    string filename;
+    // the number of generations between two checkpoints
+    int interval = 10;
+    // whether to resume the run from the checkpoint file, if it exists
+    bool resume = false;
+
+    bool enabled() const { return !filename.empty(); }
+  };
+
+  // the params that determine the results of a run, as a string, to check that a run is resumed with the same params
+  // N.B: the number of threads is ignored since the results do not depend on it, and the stopping criteria too
+  // (e.g. max_generations), so that a run can be resumed with a larger budget
+  string describeParams(const FuzzyCocoParams& params);
+  // N.B: throws a runtime_error if the state was not computed with these params
+  void checkParams(const State& state, const FuzzyCocoParams& params);
+
+  void save(const State& state, ostream& out);
+  // N.B: atomic: the state is written to a temporary file that is then renamed to filename
+  void save(const State& state, const path& filename);
+
+  // Throws a runtime_error if the content is not valid (e.g. truncated, or bad checksum)
+  State load(string_view content);
+  State load(const path& filename);
+}
+
+}
+#endif // CHECKPOINT_H
@@ -1,5 +1,6 @@
 #include "coevolution_fitness.h"
 #include "logging_logger.h"
+#include <unordered_map>
 
 using namespace fuzzy_coco;
 using namespace logging;
@@ -17,6 +18,81 @@ double CoopCoevolutionFitnessMethod::coopFitness(bool left, const Genome& genome
   return max_fitness;
 }
 
+void CoopCoevolutionFitnessMethod::coopFitnesses(bool left, const Genomes& genomes, const Genomes& cooperators, vector<double>& fitnesses) {
+  const int nb = genomes.size();
+  const int nb_coops = cooperators.size();
+  vector<GenomePair> pairs;
+  pairs.reserve(nb * nb_coops);
+  for (const auto& genome : genomes) 
+    for (const auto& coop : cooperators) 
+      pairs.push_back(left ? GenomePair{genome, coop} : GenomePair{coop, genome});
+
+  vector<double> fits;
+  CoevolutionFitnessMethod::fitnesses(pairs, fits);
+
+  fitnesses.resize(nb);
+  for (int i = 0; i < nb; i++) {
+    double max_fitness = numeric_limits<double>::lowest();
+    for (int j = 0; j < nb_coops; j++)
+      max_fitness = max(max_fitness, fits[i * nb_coops + j]);
+    fitnesses[i] = max_fitness;
+  }
+}
+
+void CoevolutionFitnessMethod::fitnessImplBatch(const vector<GenomePair>& pairs, vector<double>& fitnesses) {
+  const int nb = pairs.size();
+  fitnesses.resize(nb);
+  for (int i = 0; i < nb; i++)
+    fitnesses[i] = fitnessImpl(pairs[i].left, pairs[i].right);
+}
+
+void CoevolutionFitnessMethod::fitnesses(const vector<GenomePair>& pairs, vector<double>& fitnesses) {
+  const int nb = pairs.size();
+  fitnesses.resize(nb);
+
+  // lookup the cache, and collect the distinct pairs to evaluate
+  vector<GenomePair> to_evaluate;
+  // for each pair, its index in to_evaluate, or -1 if cached
+  vector<int> evaluated_idx(nb, -1);
+  unordered_multimap<size_t, int> pending;
+  for (int i = 0; i < nb; i++) {
+    const auto& p = pairs[i];
+    if (_cache.lookup(p.left, p.right, fitnesses[i])) continue;
+    const size_t h = FitnessCache::hash(p.left, p.right);
+    auto range = pending.equal_range(h);
+    for (auto it = range.first; it != range.second; ++it) {
+      const auto& q = to_evaluate[it->second];
+      if (q.left == p.left && q.right == p.right) {
+        evaluated_idx[i] = it->second;
+        break;
+      }
+    }
+    if (evaluated_idx[i] < 0) {
+      evaluated_idx[i] = to_evaluate.size();
+      pending.emplace(h, evaluated_idx[i]);
+      to_evaluate.push_back(p);
+    }
+  }
+
+  vector<double> evaluated;
+  fitnessImplBatch(to_evaluate, evaluated);
+
+  // N.B: in order, as fitness() would do
+  vector<bool> inserted(to_evaluate.size(), false);
+  for (int i = 0; i < nb; i++) {
+    const auto& p = pairs[i];
+    const int idx = evaluated_idx[i];
+    if (idx >= 0) {
+      fitnesses[i] = evaluated[idx];
+      if (!inserted[idx]) {
+        _cache.insert(p.left, p.right, fitnesses[i]);
+        inserted[idx] = true;
+      }
+    }
+    updateBest(p.left, p.right, fitnesses[i]);
+  }
+  _nb_evaluations += nb;
+}
 
 // vector<double> CoopCoevolutionFitnessMethod::coopFitness(bool left, const Genomes& genomes, const Genomes& cooperators)
 // {
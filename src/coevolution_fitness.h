@@ -3,38 +3,77 @@
 
 #include <memory>
 #include "evolution_engine.h"
+#include "fitness_cache.h"
 #include "logging_logger.h"
 
 namespace fuzzy_coco {
 
+// a (left, right) pair of genomes to evaluate. N.B: only references
+struct GenomePair {
+  const Genome& left;
+  const Genome& right;
+};
+
 class CoevolutionFitnessMethod 
 {
 public:
   CoevolutionFitnessMethod() {}
   virtual ~CoevolutionFitnessMethod() {}
 
+  // N.B: the fitnesses are cached (cf FitnessCache), so fitnessImpl() must only depend on the genomes
   double fitness(const Genome& left_genome, const Genome& right_genome) {
-    double fit = fitnessImpl(left_genome, right_genome);
-
-    if (fit > _best_fitness) {
-      _best_fitness = fit;
-      _best.first = left_genome;
-      _best.second = right_genome;
-
-      logging::logger() << "CoevolutionFitnessMethod::fitness(): " << "_best_fitness=" << _best_fitness  << endl;
+    double fit;
+    if (!_cache.lookup(left_genome, right_genome, fit)) {
+      fit = fitnessImpl(left_genome, right_genome);
+      _cache.insert(left_genome, right_genome, fit);
     }
+    updateBest(left_genome, right_genome, fit);
+    _nb_evaluations++;
     return fit;
   }
 
+  // compute the fitnesses of a batch of pairs: the fitnesses and the best pair are the same as when calling fitness()
+  // on each pair in order. The pairs that are not cached are evaluated using fitnessImplBatch()
+  void fitnesses(const vector<GenomePair>& pairs, vector<double>& fitnesses);
+
   // best so far
   pair<Genome, Genome> getBest() const { return _best; }
   double getBestFitness() const { return _best_fitness; }
+  // the number of (left, right) pairs evaluated so far, cached or not
+  long getNbEvaluations() const { return _nb_evaluations; }
+  void setNbEvaluations(long nb) { _nb_evaluations = nb; }
+
+  // restore the best so far, e.g. from a checkpoint
+  void setBest(const pair<Genome, Genome>& best, double best_fitness) {
+    _best = best;
+    _best_fitness = best_fitness;
+  }
+
+  FitnessCache& getFitnessCache() { return _cache; }
+  const FitnessCache& getFitnessCache() const { return _cache; }
+
   // this is the main method to implement
   virtual double fitnessImpl(const Genome& left_genome, const Genome& right_genome) = 0;
+  // evaluate a batch of pairs. N.B: by default calls fitnessImpl() on each pair.
+  // Can be overriden, e.g. to evaluate them in parallel
+  virtual void fitnessImplBatch(const vector<GenomePair>& pairs, vector<double>& fitnesses);
+
+  private:
+    void updateBest(const Genome& left_genome, const Genome& right_genome, double fit) {
+      if (fit > _best_fitness) {
+        _best_fitness = fit;
+        _best.first = left_genome;
+        _best.second = right_genome;
+
+        logging::logger() << "CoevolutionFitnessMethod::fitness(): " << "_best_fitness=" << _best_fitness  << endl;
+      }
+    }
 
   private:
     double _best_fitness = numeric_limits<double>::lowest();
     pair<Genome, Genome> _best;
+    long _nb_evaluations = 0;
+    FitnessCache _cache;
 };
 
 class CoopCoevolutionFitnessMethod : public CoevolutionFitnessMethod {
@@ -42,6 +81,8 @@ public:
   CoopCoevolutionFitnessMethod() {}
 
   virtual double coopFitness(bool left, const Genome& genome, const Genomes& cooperators);
+  // same as coopFitness() for each genome, but evaluates all (genome, cooperator) pairs as a batch
+  void coopFitnesses(bool left, const Genomes& genomes, const Genomes& cooperators, vector<double>& fitnesses);
   // virtual vector<double> coopFitness(bool left, const Genomes& genomes, const Genomes& cooperators);
   // virtual vector<double> fitnesses(const Genome& genome1);
 };
@@ -50,6 +91,9 @@ class CoopCoevolutionFitnessMethodAdaptor : public EvolutionFitnessMethod {
     CoopCoevolutionFitnessMethodAdaptor(bool left, CoopCoevolutionFitnessMethod& fit, const Genomes& cooperators) 
       : _left(left), _fit(fit), _cooperators(cooperators) {}
     double fitness(const Genome& genome) override { return _fit.coopFitness(_left, genome, _cooperators);}
+    void fitnesses(const Genomes& genomes, vector<double>& fitnesses) override {
+      _fit.coopFitnesses(_left, genomes, _cooperators, fitnesses);
+    }
   private:
     bool _left;
     CoopCoevolutionFitnessMethod& _fit;
@@ -1,4 +1,5 @@
 #include "crossover_method.h"
+#include "profiler.h"
 
 using namespace fuzzy_coco;
 
@@ -12,12 +13,13 @@ void OnePointCrossoverMethod::reproducePairOf(Genome& gen1, Genome& gen2) {
         // Never exchange the whole genome, must be at least 1bit of the other part.
         // Karl: why ?
         int cutPoint = _rng.random(1, nb - 2);
-        for (size_t i = cutPoint; i < nb; i++)
-            swap(gen1[i], gen2[i]);
+        // N.B: word-level swap of the bits [cutPoint, nb[
+        gen1.swapTail(gen2, cutPoint);
     }
 }
 
 void OnePointCrossoverMethod::reproduceAllPairsOf(vector<Genome>& genomes) {
+    PROFILE_PHASE(CROSSOVER);
     // process all consecutive pairs. If odd, the last one is not processed
     const int nb_minus_one = genomes.size() - 1;
     for (int i = 0; i < nb_minus_one; i += 2) {
@@ -0,0 +1,212 @@
+#include "csv_loader.h"
+#include <charconv>
+#include <cstring>
+#include <cctype>
+#include <fstream>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "mapped_file.h"
+#include "thread_pool.h"
+
+using namespace fuzzy_coco;
+
+const char* CsvLoader::findSeparator(const char* p, const char* end, char delim) {
+#ifdef __SSE2__
+  const __m128i d = _mm_set1_epi8(delim);
+  const __m128i nl = _mm_set1_epi8('\n');
+  for (; p + 16 <= end; p += 16) {
+    const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, d), _mm_cmpeq_epi8(block, nl)));
+    if (mask) return p + __builtin_ctz(mask);
+  }
+#endif
+  for (; p < end; p++)
+    if (*p == delim || *p == '\n') return p;
+  return end;
+}
+
+// split the line starting at p into tokens, and return the start of the next line
+// N.B: the trailing '\r' (windows line endings) and the trailing empty token are dropped: the tokens
+// are empty for an empty line
+static const char* split_next_line(const char* p, const char* end, char delim, vector<string_view>& tokens) {
+  tokens.clear();
+  const char* next = end;
+  while (true) {
+    const char* q = CsvLoader::findSeparator(p, end, delim);
+    tokens.emplace_back(p, q - p);
+    if (q == end || *q == '\n') {
+      if (q != end) next = q + 1;
+      break;
+    }
+    p = q + 1;
+  }
+
+  auto& last = tokens.back();
+  if (!last.empty() && last.back() == '\r') last.remove_suffix(1);
+  if (last.empty()) tokens.pop_back();
+  return next;
+}
+
+void CsvLoader::splitLine(string_view line, char delim, vector<string_view>& tokens) {
+  split_next_line(line.data(), line.data() + line.size(), delim, tokens);
+}
+
+double CsvLoader::parseNumber(string_view token) {
+  const char* p = token.data();
+  const char* end = p + token.size();
+  while (p < end && isspace(static_cast<unsigned char>(*p))) p++;
+  // N.B: from_chars() does not accept a leading +
+  if (p < end && *p == '+') {
+    p++;
+    if (p < end && *p == '-') return MISSING_DATA_DOUBLE;
+  }
+
+  double value;
+  auto [ptr, ec] = from_chars(p, end, value);
+  return ec == errc() ? value : MISSING_DATA_DOUBLE;
+}
+
+// the number of non-empty lines in [p, end[
+static int count_lines(const char* p, const char* end) {
+  int nb = 0;
+  while (p < end) {
+    const char* eol = static_cast<const char*>(memchr(p, '\n', end - p));
+    if (!eol) eol = end;
+    const size_t len = eol - p;
+    if (len > 1 || (len == 1 && *p != '\r')) nb++;
+    p = eol + 1;
+  }
+  return nb;
+}
+
+// parse the header: the first non-empty line, and return the start of the next line
+static const char* parse_header(const char* p, const char* end, char delim, vector<string_view>& header) {
+  header.clear();
+  while (p < end && header.empty())
+    p = split_next_line(p, end, delim, header);
+  if (header.empty())
+    THROW_WITH_LOCATION("Error in CsvLoader::parse(): no rows");
+  return p;
+}
+
+// parse the lines in [p, end[ into a DataFrame
+static DataFrame parse_rows(const char* p, const char* end, const vector<string_view>& header, bool rownames, char delim, int nb_threads) {
+  const int first_col = rownames ? 1 : 0;
+  const size_t nbtokens = header.size();
+  const int nbcols = int(nbtokens) - first_col;
+
+  // split the body in chunks of whole lines
+  if (nb_threads <= 0) nb_threads = ThreadPool::hardware_concurrency();
+  const int nb_chunks = nb_threads;
+  vector<const char*> bounds(nb_chunks + 1, end);
+  bounds[0] = p;
+  for (int k = 1; k < nb_chunks; k++) {
+    const char* b = max(bounds[k - 1], p + (end - p) * k / nb_chunks);
+    // N.B: a chunk starts just after a newline
+    if (b > p && b < end && b[-1] != '\n') {
+      b = static_cast<const char*>(memchr(b, '\n', end - b));
+      b = b ? b + 1 : end;
+    }
+    bounds[k] = b;
+  }
+
+  ThreadPool pool(nb_threads);
+
+  // first pass: the number of rows of each chunk --> their first row
+  vector<int> first_rows(nb_chunks + 1, 0);
+  pool.run(nb_chunks, [&](int k, int) { first_rows[k + 1] = count_lines(bounds[k], bounds[k + 1]); });
+  for (int k = 0; k < nb_chunks; k++)
+    first_rows[k + 1] += first_rows[k];
+  const int nbrows = first_rows[nb_chunks];
+
+  DataFrame df(nbrows, nbcols);
+  df.colnames(vector<string>(header.begin() + first_col, header.end()));
+  StrColumn names(rownames ? nbrows : 0);
+
+  // second pass: parse the values directly into the DataFrame
+  pool.run(nb_chunks, [&](int k, int) {
+    vector<string_view> tokens;
+    tokens.reserve(nbtokens);
+    const char* q = bounds[k];
+    int row = first_rows[k];
+    while (q < bounds[k + 1]) {
+      q = split_next_line(q, bounds[k + 1], delim, tokens);
+      if (tokens.empty()) continue;
+      if (tokens.size() != nbtokens)
+        THROW_WITH_LOCATION(string("Error in CsvLoader::parse(): bad number of columns:") + to_string(tokens.size()) + " at row " + to_string(row + 1));
+      if (rownames) names[row] = string(tokens[0]);
+      for (int col = 0; col < nbcols; col++)
+        df.set(row, col, CsvLoader::parseNumber(tokens[col + first_col]));
+      row++;
+    }
+  });
+
+  if (rownames) df.rownames(names);
+  return df;
+}
+
+DataFrame CsvLoader::parse(string_view content, bool rownames, char delim, int nb_threads) {
+  const char* end = content.data() + content.size();
+  vector<string_view> header;
+  const char* p = parse_header(content.data(), end, delim, header);
+  return parse_rows(p, end, header, rownames, delim, nb_threads);
+}
+
+DataFrame CsvLoader::parseRows(string_view rows, const vector<string>& header, bool rownames, char delim, int nb_threads) {
+  vector<string_view> header_views(header.begin(), header.end());
+  return parse_rows(rows.data(), rows.data() + rows.size(), header_views, rownames, delim, nb_threads);
+}
+
+DataFrame CsvLoader::load(const path& filename, bool rownames, char delim, int nb_threads) {
+  MappedFile file(filename);
+  return parse(file.view(), rownames, delim, nb_threads);
+}
+
+CsvChunkReader::CsvChunkReader(const path& filename, bool rownames, char delim) 
+  : _file(make_unique<ifstream>(filename)), _in(*_file), _rownames(rownames), _delim(delim) 
+{
+  if (!_file->is_open())
+    throw filesystem_error("error opening file", filename, error_code());
+  readHeader();
+}
+
+CsvChunkReader::CsvChunkReader(istream& in, bool rownames, char delim) 
+  : _in(in), _rownames(rownames), _delim(delim) 
+{
+  readHeader();
+}
+
+void CsvChunkReader::readHeader() {
+  vector<string_view> tokens;
+  while (tokens.empty() && getline(_in, _line))
+    CsvLoader::splitLine(_line, _delim, tokens);
+  if (tokens.empty())
+    THROW_WITH_LOCATION("Error in CsvChunkReader: no rows");
+  _header.assign(tokens.begin(), tokens.end());
+}
+
+vector<string> CsvChunkReader::colnames() const {
+  return vector<string>(_header.begin() + (_rownames ? 1 : 0), _header.end());
+}
+
+bool CsvChunkReader::next(int nb_rows, DataFrame& chunk) {
+  assert(nb_rows > 0);
+  _buffer.clear();
+  int nb = 0;
+  while (nb < nb_rows && getline(_in, _line)) {
+    // N.B: ignore any empty line
+    if (_line.empty() || _line == "\r") continue;
+    _buffer += _line;
+    _buffer += '\n';
+    nb++;
+  }
+  if (nb == 0) return false;
+
+  chunk = CsvLoader::parseRows(_buffer, _header, _rownames, _delim);
+  if (_storage != DataFrame::FLOAT64) chunk.setStorage(_storage);
+  _nb_rows_read += nb;
+  return true;
+}
@@ -0,0 +1,86 @@
+#ifndef CSV_LOADER_H
+#define CSV_LOADER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include "dataframe.h"
+
+namespace fuzzy_coco {
+
+using namespace std;
+using namespace std::filesystem;
+
+// a fast CSV loader, that parses the values directly into the DataFrame columns, without
+// building the intermediate table of strings of FileUtils::parseCSV():
+//   - the file is memory-mapped (cf MappedFile)
+//   - the separators are scanned 16 bytes at a time (SSE2)
+//   - the numbers are parsed by from_chars(), the non-numbers are missing values, without exceptions
+//   - the lines can be parsed in parallel, by chunks
+// It follows the same conventions as FileUtils::parseCSV() + DataFrame::assign(): the first line
+// contains the column names, the empty lines are ignored, and the values that can not be parsed as
+// a number (e.g. "NA") are missing values.
+namespace CsvLoader {
+
+  // parse content into a DataFrame, using nb_threads threads (0 for all cores)
+  // rownames: if TRUE, consider the first column as the rownames
+  DataFrame parse(string_view content, bool rownames, char delim = ';', int nb_threads = 1);
+  DataFrame load(const path& filename, bool rownames, char delim = ';', int nb_threads = 1);
+  // parse rows (without the header line) into a DataFrame
+  // header: all the column names, including the rownames one if any
+  DataFrame parseRows(string_view rows, const vector<string>& header, bool rownames, char delim = ';', int nb_threads = 1);
+
+  // parse a number like stod() (leading whitespace, trailing characters ignored), but without exceptions:
+  // returns MISSING_DATA_DOUBLE if the token is not a number
+  double parseNumber(string_view token);
+
+  // split a line into tokens, like the former regex-based FileUtils::parseCSV(): N.B: a trailing empty token is dropped
+  void splitLine(string_view line, char delim, vector<string_view>& tokens);
+
+  // the position of the first delim or newline in [p, end[, or end if none
+  const char* findSeparator(const char* p, const char* end, char delim);
+
+};
+
+// reads a CSV by chunks of rows, to process files that do not fit in memory: only one chunk is
+// in memory at a time. Same conventions as CsvLoader
+class CsvChunkReader
+{
+public:
+  // N.B: the header is read by the constructor. Throws if there is none or if the file can not be opened
+  CsvChunkReader(const path& filename, bool rownames, char delim = ';');
+  // N.B: in must outlive the reader
+  CsvChunkReader(istream& in, bool rownames, char delim = ';');
+
+  // the column names (excluding the rownames one)
+  vector<string> colnames() const;
+  // the number of rows read so far
+  long getNbRowsRead() const { return _nb_rows_read; }
+  // the storage of the chunks (cf DataFrame::setStorage()), FLOAT64 by default
+  DataFrame::Storage getStorage() const { return _storage; }
+  void setStorage(DataFrame::Storage storage) { _storage = storage; }
+
+  // read the next (at most) nb_rows rows into chunk. Returns false if there are no more rows
+  bool next(int nb_rows, DataFrame& chunk);
+
+private:
+  void readHeader();
+
+private:
+  unique_ptr<ifstream> _file;
+  istream& _in;
+  bool _rownames;
+  char _delim;
+  vector<string> _header;
+  long _nb_rows_read = 0;
+  DataFrame::Storage _storage = DataFrame::FLOAT64;
+  // reusable buffers
+  string _line;
+  string _buffer;
+};
+
+}
+#endif // CSV_LOADER_H
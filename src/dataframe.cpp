@@ -6,13 +6,33 @@
 #include <cassert>
 #include <unordered_map>
 #include "file_utils.h"
+#include "csv_loader.h"
+#include "binary_dataframe.h"
 
 using namespace fuzzy_coco;
 
 DataFrame::DataFrame(const string& csv, bool rownames) {
-  vector<vector<string>> tokens;
-  FileUtils::parseCSV(csv, tokens);
-  assign(tokens, rownames);
+  *this = CsvLoader::parse(csv, rownames);
+}
+
+NumColumn ColumnView::toVector() const {
+  NumColumn values(_size);
+  if (isFloat()) {
+    for (int i = 0; i < _size; i++) values[i] = toDouble(_fvalues[i]);
+  } else {
+    copy(_values, _values + _size, values.begin());
+  }
+  return values;
+}//KCOV IGNORE
+
+namespace fuzzy_coco {
+  bool operator==(const ColumnView& a, const ColumnView& b) {
+    if (a.size() != b.size()) return false;
+    const int nb = a.size();
+    for (int i = 0; i < nb; i++)
+      if (a[i] != b[i]) return false;
+    return true;
+  }
 }
 
 void DataFrame::reset(int nbrows, int nbcols) {
@@ -21,13 +41,69 @@ void DataFrame::reset(int nbrows, int nbcols) {
   _rownames.resize(0);
   _colnames.resize(0);
   _colnames.resize(nbcols);
-  _cols.resize(nbcols);
-  for (auto& col : _cols) {
-    col.resize(0);
-    col.resize(nbrows, 0);
+
+  _data.clear();
+  _fdata.clear();
+  _shared_values = nullptr;
+  _shared_owner.reset();
+  if (isFloat()) {
+    _stride = paddedStride<float>(nbrows);
+    _fdata.resize(size_t(_stride) * nbcols, 0);
+  } else {
+    _stride = paddedStride<double>(nbrows);
+    _data.resize(size_t(_stride) * nbcols, 0);
   }
 }
 
+void DataFrame::setStorage(Storage storage) {
+  if (storage == _storage) return;
+  DataFrame df;
+  df._storage = storage;
+  df.reset(_nbrows, _nbcols);
+  for (int col = 0; col < _nbcols; col++)
+    for (int row = 0; row < _nbrows; row++)
+      df.set(row, col, at(row, col));
+
+  _storage = storage;
+  _stride = df._stride;
+  _data.swap(df._data);
+  _fdata.swap(df._fdata);
+  _shared_values = nullptr;
+  _shared_owner.reset();
+}
+
+void DataFrame::adoptValues(Storage storage, int nbrows, int nbcols, const void* values, shared_ptr<const void> owner) {
+  _storage = storage;
+  reset();
+  _nbrows = nbrows;
+  _nbcols = nbcols;
+  _colnames.resize(nbcols);
+  _stride = isFloat() ? paddedStride<float>(nbrows) : paddedStride<double>(nbrows);
+  _shared_values = values;
+  _shared_owner = move(owner);
+}
+
+void DataFrame::detach() {
+  const size_t nb = size_t(_stride) * _nbcols;
+  if (isFloat()) {
+    const float* values = floatValues();
+    _fdata.assign(values, values + nb);
+  } else {
+    const double* values = doubleValues();
+    _data.assign(values, values + nb);
+  }
+  _shared_values = nullptr;
+  _shared_owner.reset();
+}
+
+bool DataFrame::operator==(const DataFrame& df) const {
+  if (_nbrows != df._nbrows || _nbcols != df._nbcols || _rownames != df._rownames || _colnames != df._colnames) 
+    return false;
+  for (int col = 0; col < _nbcols; col++)
+    if (getColumn(col) != df.getColumn(col)) return false;
+  return true;
+}
+
 void DataFrame::assign(const vector<vector<string>>& rows, bool rownames) {
   int first_col = rownames ? 1 : 0;
 
@@ -66,11 +142,7 @@ void DataFrame::assign(const vector<vector<string>>& rows, bool rownames) {
           THROW_WITH_LOCATION(string("Error in DataFrame::assign(): bad number of columns:") + std::to_string(rows[i].size()) + " at row " + std::to_string(i) );
       }
       row = i - 1;
-      try {
-        _cols[col][row] = stod(rows[i][j]);
-      } catch(...) {
-        _cols[col][row] = MISSING_DATA_DOUBLE;
-      }
+      set(row, col, CsvLoader::parseNumber(rows[i][j]));
     }
   }
 }
@@ -93,7 +165,7 @@ NumColumn DataFrame::fetchRow(int row) const {
   NumColumn values;
   values.resize(nbcols());
   for (int col = 0; col < _nbcols; col++) {
-    values[col] = _cols[col][row];
+    values[col] = at(row, col);
   }
   return values;
 }//KCOV IGNORE
@@ -101,13 +173,19 @@ NumColumn DataFrame::fetchRow(int row) const {
 void DataFrame::fillRow(int row, const vector<double>& values) {
   assert(row >= 0 && row < _nbrows);
   for (int col = 0; col < _nbcols; col++) {
-    _cols[col][row] = values[col];
+    set(row, col, values[col]);
   }
 }
 
 void DataFrame::fillCol(int col, const NumColumn& values) {
   assert(col >= 0 && col < _nbcols);
-  _cols[col] = values;
+  assert(values.size() == (size_t)_nbrows);
+  if (isShared()) detach();
+  if (isFloat()) {
+    for (int row = 0; row < _nbrows; row++) set(row, col, values[row]);
+  } else {
+    copy(values.begin(), values.end(), _data.begin() + size_t(col) * _stride);
+  }
 }
 
 DataFrame DataFrame::subsetColumns(int col1, int col2) const {
@@ -126,6 +204,7 @@ DataFrame DataFrame::subsetColumns(int col1, int col2) const {
 
 DataFrame DataFrame::subsetColumns(const vector<int>& col_idx) const {
   DataFrame df;
+  df._storage = _storage;
   df.reset(nbrows(), col_idx.size());
   df._rownames = _rownames;
 
@@ -134,7 +213,11 @@ DataFrame DataFrame::subsetColumns(const vector<int>& col_idx) const {
       THROW_WITH_LOCATION("bad column index " + std::to_string(col_idx[i]));
     int col = col_idx[i];
     df._colnames[i] = _colnames[col];
-    df._cols[i] = _cols[col];
+    // N.B: same storage and stride
+    if (isFloat())
+      copy_n(floatValues() + size_t(col) * _stride, _stride, df._fdata.begin() + size_t(i) * _stride);
+    else
+      copy_n(doubleValues() + size_t(col) * _stride, _stride, df._data.begin() + size_t(i) * _stride);
   }
 
   return df;
@@ -162,14 +245,11 @@ DataFrame DataFrame::subsetColumns(const vector<string>& col_names)  const{
   return subsetColumns(col_idx);
 }
 
-DataFrame DataFrame::load(const string& filename, bool rownames)
+DataFrame DataFrame::load(const string& filename, bool rownames, int nb_threads)
 {
-  vector<vector<string>> tokens;
-  tokens.reserve(1000);
-  FileUtils::parseCSV(path(filename), tokens);
-  DataFrame df(tokens, rownames);
-  // cerr << df;
-  return df;
+  if (BinaryDataFrame::isBinary(filename))
+    return BinaryDataFrame::load(filename);
+  return CsvLoader::load(path(filename), rownames, ';', nb_threads);
 }
 
 namespace fuzzy_coco {
@@ -14,8 +14,10 @@
 #include <vector>
 #include <string>
 #include <cassert>
+#include <memory>
 
 #include "types.h"  // for MISSING_DATA_DOUBLE
+#include "aligned_allocator.h"
 
 namespace fuzzy_coco {
 using namespace std;
@@ -24,8 +26,56 @@ typedef vector<double> NumColumn;
 typedef vector<bool> BoolColumn;
 typedef vector<string> StrColumn;
 
+// sentinel value to encode for missing data in the float32 storage, cf DataFrame::FLOAT32
+const float MISSING_DATA_FLOAT = numeric_limits<float>::lowest();
+
+// a read-only view on a DataFrame column, stored either as doubles or as floats (cf DataFrame::Storage)
+// N.B: the values are always read as doubles, with MISSING_DATA_FLOAT converted to MISSING_DATA_DOUBLE
+class ColumnView {
+public:
+  ColumnView(const double* values, int nb) : _values(values), _size(nb) {}
+  ColumnView(const float* values, int nb) : _fvalues(values), _size(nb) {}
+  ColumnView(const NumColumn& values) : ColumnView(values.data(), values.size()) {}
+
+  int size() const { return _size; }
+  bool empty() const { return _size == 0; }
+  bool isFloat() const { return _fvalues != nullptr; }
+  // the raw values, according to the storage
+  const double* data() const { assert(!isFloat()); return _values; }
+  const float* floatData() const { assert(isFloat()); return _fvalues; }
+
+  double operator[](int i) const { 
+    assert(i >= 0 && i < _size);
+    return isFloat() ? toDouble(_fvalues[i]) : _values[i]; 
+  }
+
+  NumColumn toVector() const;
+  operator NumColumn() const { return toVector(); }
+
+  // N.B: friends so that a NumColumn can be compared with a ColumnView, in both orders
+  friend bool operator==(const ColumnView& a, const ColumnView& b);
+  friend bool operator!=(const ColumnView& a, const ColumnView& b) { return !(a == b); }
+
+  static double toDouble(float value) { return value == MISSING_DATA_FLOAT ? MISSING_DATA_DOUBLE : double(value); }
+  static float toFloat(double value) { return is_na(value) ? MISSING_DATA_FLOAT : float(value); }
+
+private:
+  const double* _values = nullptr;
+  const float* _fvalues = nullptr;
+  int _size = 0;
+};
+
+// N.B: the values are stored column-major in a single 64-byte aligned buffer, each column starting
+// on a 64-byte boundary (the column stride is padded), so that the columns can be streamed by SIMD kernels.
+// The values are stored as doubles, or optionally as floats (cf setStorage()) to halve the memory bandwidth 
+// on wide datasets. N.B: in that case the values are rounded to the float precision.
+// The values may also be shared read-only, e.g. memory-mapped from a binary file (cf adoptValues()),
+// in which case they are copied on the first modification.
 class DataFrame {
 public:
+  enum Storage { FLOAT64, FLOAT32 };
+  static constexpr int ALIGNMENT = 64;
+
   // empty dataframe
   DataFrame(int nbrows = 0, int nbcols = 0) { reset(nbrows, nbcols); }
 
@@ -40,8 +90,21 @@ public:
   // rownames: if TRUE, consider the first column as the rownames
   void assign(const vector<vector<string>>& rows, bool rownames);
 
+  // N.B: keeps the storage, and sets all the values to 0
   void reset(int nbrows = 0, int nbcols = 0);
 
+  Storage getStorage() const { return _storage; }
+  bool isFloat() const { return _storage == FLOAT32; }
+  // convert the values in place to the given storage
+  void setStorage(Storage storage);
+
+  // use the given values without copying them, e.g. memory-mapped from a file (cf BinaryDataFrame): nbcols
+  // columns of paddedStride(nbrows) values stored according to storage, that must stay valid as long as owner.
+  // N.B: the names are reset. The values are copied on the first modification
+  void adoptValues(Storage storage, int nbrows, int nbcols, const void* values, shared_ptr<const void> owner);
+  // whether the values are shared, i.e. not owned
+  bool isShared() const { return _shared_values != nullptr; }
+
   // extract a dataframe from this one with only columns from col1 --> col2. All columns from col1 
   DataFrame subsetColumns(int col1, int col2) const;
   // to col2 (included) are in the returned dataframe
@@ -60,43 +123,77 @@ public:
   void colnames(const vector<string>& names);
   void rownames(const vector<string>& names);
 
-  const NumColumn& getColumn(int col) const { return _cols[col]; }
-  const NumColumn& operator[](int col) const { return getColumn(col); }
+  ColumnView getColumn(int col) const { 
+    assert(col >= 0 && col < _nbcols);
+    const size_t offset = cellOffset(0, col, _stride);
+    return isFloat() ? ColumnView(floatValues() + offset, _nbrows) : ColumnView(doubleValues() + offset, _nbrows);
+  }
+  ColumnView operator[](int col) const { return getColumn(col); }
   
   NumColumn fetchRow(int row) const; 
 
   double at(int row, int col) const {
     check_indexes(row, col);
-    return _cols[col][row]; 
+    const size_t idx = cellOffset(row, col, _stride);
+    return isFloat() ? ColumnView::toDouble(floatValues()[idx]) : doubleValues()[idx];
   }
   bool missing(int row, int col) const {
     check_indexes(row, col);
     return is_na(at(row, col));
   }
 
-  void set(int row, int col, double value) { _cols[col][row] = value; }
+  void set(int row, int col, double value) { 
+    check_indexes(row, col);
+    if (isShared()) detach();
+    const size_t idx = cellOffset(row, col, _stride);
+    if (isFloat()) _fdata[idx] = ColumnView::toFloat(value);
+    else _data[idx] = value;
+  }
   void fillRow(int row, const vector<double>& values);
   void fillCol(int col, const NumColumn& values);
 
+  // the number of values between the starts of two consecutive columns (>= nbrows())
+  int stride() const { return _stride; }
+  // the index of the value (row, col) in the column-major values. N.B: in size_t, since it may exceed an int
+  static size_t cellOffset(int row, int col, int stride) { return size_t(col) * stride + row; }
+  // the stride for nbrows rows stored as T, so that the columns are ALIGNMENT-byte aligned
+  template <typename T>
+  static int paddedStride(int nbrows) { 
+    const int nb = ALIGNMENT / sizeof(T);
+    return (nbrows + nb - 1) / nb * nb;
+  }
+
   void check_indexes(int row, int col) const { 
     assert(row >=0 && row < _nbrows && col >=0 && col < _nbcols);
   }
 
   bool operator!=(const DataFrame& df) const { return ! (*this == df); }
-  bool operator==(const DataFrame& df) const {
-    return _cols == df._cols && 
-    _rownames == df._rownames &&
-    _colnames == df._colnames;
-  }
+  bool operator==(const DataFrame& df) const;
 
-  static DataFrame load(const string& filename, bool rownames);
+  // load a CSV file, cf CsvLoader::load(). nb_threads: the number of threads used to parse it, 0 for all cores
+  // N.B: a file in the binary format (cf BinaryDataFrame) is detected and memory-mapped instead: rownames and
+  // nb_threads are then not used
+  static DataFrame load(const string& filename, bool rownames, int nb_threads = 1);
 
   friend ostream& operator<<(ostream& out, const DataFrame&);
 
+private:
+  const double* doubleValues() const { return isShared() ? static_cast<const double*>(_shared_values) : _data.data(); }
+  const float* floatValues() const { return isShared() ? static_cast<const float*>(_shared_values) : _fdata.data(); }
+  // copy the shared values so that they are owned
+  void detach();
+
 private:
   int _nbcols = 0;
   int _nbrows = 0;
-  vector<NumColumn> _cols;
+  Storage _storage = FLOAT64;
+  int _stride = 0;
+  // the values, column-major: only one is used, according to the storage. N.B: the padding values are 0
+  AlignedVector<double, ALIGNMENT> _data;
+  AlignedVector<float, ALIGNMENT> _fdata;
+  // the shared values if any, that are then used instead of _data or _fdata, and kept valid by _shared_owner
+  const void* _shared_values = nullptr;
+  shared_ptr<const void> _shared_owner;
   StrColumn _rownames;
   StrColumn _colnames;
 };
@@ -61,9 +61,8 @@ namespace fuzzy_coco {
       return uint64_to_double(hex_to_uint64(hex));
     }
 
-    // FNV-1a 64-bit hash for arbitrary data
-    inline uint64_t fnv1a64(const uint8_t* data, size_t size) {
-      uint64_t hash = FNV1A_64_OFFSET_BASIS;
+    // FNV-1a 64-bit hash for arbitrary data. N.B: pass the hash of the preceding data to hash several blocks
+    inline uint64_t fnv1a64(const uint8_t* data, size_t size, uint64_t hash = FNV1A_64_OFFSET_BASIS) {
       for (size_t i = 0; i < size; ++i) {
         hash ^= data[i]; // Bitwise XOR 
         hash *= FNV1A_64_PRIME; // * by FNV prime
@@ -119,13 +118,9 @@ namespace fuzzy_coco {
 
       ostringstream oss;
       for (size_t byte_idx = 0; byte_idx < byte_count; ++byte_idx) {
-        uint8_t byte = 0;
-        for (size_t bit = 0; bit < 8; ++bit) {
-          size_t idx = byte_idx * 8 + bit;
-          if (idx < n && genome[idx]) {
-              byte |= (1u << bit); // pack bit (LSB first)
-          }
-        }
+        // pack bits (LSB first)
+        const size_t pos = byte_idx * 8;
+        const uint8_t byte = uint8_t(genome.getField(pos, int(min<size_t>(8, n - pos))));
         oss << std::hex << std::setw(2) << std::setfill('0') << (int)byte;
       }
       return oss.str();
@@ -1,8 +1,15 @@
 #include "evolution_engine.h"
 #include <algorithm>
+#include "profiler.h"
 
 using namespace fuzzy_coco;
 
+void EvolutionFitnessMethod::fitnesses(const Genomes& genomes, vector<double>& fitnesses) {
+    const int nb = genomes.size();
+    fitnesses.resize(nb);
+    for (int k = 0; k < nb; k++) fitnesses[k] = fitness(genomes[k]);
+}
+
 double EvolutionFitnessMethod::globalFitness(const vector<double>& fitnesses) {
     return *max_element(fitnesses.begin(), fitnesses.end());
 }
@@ -10,7 +17,7 @@ double EvolutionFitnessMethod::globalFitness(const vector<double>& fitnesses) {
 EvolutionEngine::EvolutionEngine(const EvolutionParams& params, RandomGenerator& rng) :
         _params(params),
         _crossover_method(rng, params.cx_prob),
-        _mutation_method(rng, params.mut_flip_genome, params.mut_flip_bit),
+        _mutation_method(rng, params.mut_flip_genome, params.mut_flip_bit, params.mut_geometric_sampling),
         _elite_selection_method(rng),
         _individuals_selection_method(rng)
 {}
@@ -37,10 +44,7 @@ pair<Generation, vector<double>> EvolutionEngine::evolve(const Genomes& genomes,
 void EvolutionEngine::updateGeneration(Generation& generation, EvolutionFitnessMethod& fitness_method)
 {
     const auto& genos = generation.individuals;
-    const int nb = genos.size();
-    generation.fitnesses.resize(nb);
-
-    for (int k = 0; k < nb; k++) generation.fitnesses[k] = fitness_method.fitness(genos[k]);
+    fitness_method.fitnesses(genos, generation.fitnesses);
 
     generation.fitness = fitness_method.globalFitness(generation.fitnesses);
     generation.elite = selectElite(genos, generation.fitnesses);
@@ -88,6 +92,7 @@ Generation EvolutionEngine::nextGeneration(const Generation& generation, Evoluti
 
 Genomes EvolutionEngine::selectElite(const Genomes& genomes, const vector<double>& fitnesses)
 {
+  PROFILE_PHASE(SELECTION);
 
   const int nb_elite = _params.elite_size;
   vector<int> indexes; // TODO: put in instance state
@@ -101,6 +106,7 @@ Genomes EvolutionEngine::selectElite(const Genomes& genomes, const vector<double
 
 Genomes EvolutionEngine::selectEvolvers(int nb, const Genomes& genomes, const vector<double>& fitnesses)
 {
+    PROFILE_PHASE(SELECTION);
     vector<int> indexes; // TODO: put in instance state 
     indexes.reserve(nb);
     indexes.clear();
@@ -63,6 +63,9 @@ public:
   virtual ~EvolutionFitnessMethod() {}
 
   virtual double fitness(const Genome& genome) = 0;
+  // compute the fitnesses of all the genomes. N.B: by default, calls fitness() on each genome
+  // may be overriden, e.g. to evaluate the genomes in parallel, but must give the same results
+  virtual void fitnesses(const Genomes& genomes, vector<double>& fitnesses);
   virtual double globalFitness(const vector<double>& fitnesses);
 };
 
@@ -18,6 +18,7 @@ struct EvolutionParams
     cx_prob = desc.get_double("cx_prob", cx_prob);
     mut_flip_genome = desc.get_double("mut_flip_genome", mut_flip_genome);
     mut_flip_bit = desc.get_double("mut_flip_bit", mut_flip_bit);
+    mut_geometric_sampling = desc.get_bool("mut_geometric_sampling", mut_geometric_sampling);
   }
 
   // the size (nb of genomes) of the population to evolve
@@ -30,6 +31,9 @@ struct EvolutionParams
   double mut_flip_genome = 0.5;
   // the probability that a bit of a genome is mutated
   double mut_flip_bit = 0.025;
+  // whether to sample the mutated bits using the geometric skip-sampling, that is much faster for long genomes
+  // N.B: false by default, to reproduce the results of previous versions
+  bool mut_geometric_sampling = false;
 
   bool has_missing() const { 
       return is_na(pop_size) || is_na(elite_size) || is_na(cx_prob) || is_na(mut_flip_genome) ||  is_na(mut_flip_bit); 
@@ -45,7 +49,8 @@ struct EvolutionParams
         // nb_evolvers == p.nb_evolvers &&
         cx_prob == p.cx_prob &&
         mut_flip_genome == p.mut_flip_genome &&
-        mut_flip_bit == p.mut_flip_bit;
+        mut_flip_bit == p.mut_flip_bit &&
+        mut_geometric_sampling == p.mut_geometric_sampling;
   }
 
   NamedList describe() const {
@@ -55,14 +60,15 @@ struct EvolutionParams
     desc.add("cx_prob", cx_prob);
     desc.add("mut_flip_genome", mut_flip_genome);
     desc.add("mut_flip_bit", mut_flip_bit);
+    desc.add("mut_geometric_sampling", mut_geometric_sampling);
     return desc;
   }
 
   inline friend ostream& operator<<(ostream& out, const EvolutionParams& p) {
-      DataFrame df(1, 5);
-      df.colnames({"pop_size", "elite_size", "cx_prob", "mut_flip_genome", "mut_flip_bit"});
+      DataFrame df(1, 6);
+      df.colnames({"pop_size", "elite_size", "cx_prob", "mut_flip_genome", "mut_flip_bit", "mut_geometric_sampling"});
       auto D = [](int i) { return is_na(i) ? MISSING_DATA_DOUBLE : double(i); };
-      vector<double> row = {D(p.pop_size), D(p.elite_size), p.cx_prob, p.mut_flip_genome, p.mut_flip_bit};
+      vector<double> row = {D(p.pop_size), D(p.elite_size), p.cx_prob, p.mut_flip_genome, p.mut_flip_bit, double(p.mut_geometric_sampling)};
       df.fillRow(0, row);
       out << df;
 
@@ -2,6 +2,11 @@
 #include "fuzzy_coco.h"
 #include "logging_logger.h"
 #include "file_utils.h"
+#include "binary_dataframe.h"
+#include "binary_fuzzy_system.h"
+#include "prediction_server.h"
+#include "profiler.h"
+#include "synthetic_dataset.h"
 
 using namespace fuzzy_coco;
 using namespace logging;
@@ -12,12 +17,31 @@ struct Params
   string paramsFile;
   string fuzzyFile;
   string ouputPath;
+  string socketPath;
+  string checkpointFile;
 
   bool verbose = false;
   bool eval = false;
   bool predict = false;
+  bool float32 = false;
+  bool convert = false;
+  bool serve = false;
+  bool resume = false;
+  bool profile = false;
+  bool generate = false;
+  bool regression = false;
   int seed = -1;
   int nb_output_vars = 1;
+  int nb_threads = MISSING_DATA_INT;
+  int chunk_size = 0;
+  int checkpoint_interval = 10;
+  double max_seconds = MISSING_DATA_DOUBLE;
+  double max_evaluations = MISSING_DATA_DOUBLE;
+  int stagnation_generations = MISSING_DATA_INT;
+  int nb_rows = 1000;
+  int nb_vars = 10;
+  double na_rate = 0;
+  double class_balance = 0.5;
 };
 
 /**
@@ -30,9 +54,30 @@ Valid parameters are :
 
  --evaluate   : Perform an evaluation of the given fuzzy system on the specified database
  --predict    : Perform a prediction of the given fuzzy system on the specified database
+ --convert    : Convert the dataset (or, without a dataset, the fuzzy system) to the binary format, written to the output path
+ --serve      : Run a prediction server, reading the requests from stdin (or from --socket), cf USAGE.md
+ --generate   : Generate a synthetic dataset (seeded by --seed), written to the output path (defaults to stdout), cf USAGE.md
  --verbose    : Verbose output
+ --float32    : store the dataset values as floats (less memory, values rounded to float precision)
  --seed value : seed for the random generator
  --nbout nb   : number of output variables (defaults to 1)
+ --threads nb : number of threads to use to compute the fitnesses, 0 for all cores (overrides the nb_threads param)
+ --chunk nb   : with --predict, stream the dataset by chunks of nb rows, in constant memory.
+                With --serve, the maximum number of rows of a micro-batch
+ --socket path: with --serve, listen on that Unix socket instead of stdin
+ --checkpoint path : save a checkpoint of the fuzzy system inference in that file periodically
+ --checkpoint-interval nb : the number of generations between two checkpoints (defaults to 10)
+ --resume     : resume the fuzzy system inference from the --checkpoint file, if it exists
+ --profile    : profile the hot phases of the fuzzy system inference, reported in the "profile" section of the output
+ --max-seconds s : stop the fuzzy system inference after s seconds of wall-clock time (overrides the max_seconds param)
+ --max-evaluations nb : stop the fuzzy system inference after nb fitness evaluations (overrides the max_evaluations param)
+ --stagnation nb : stop the fuzzy system inference after nb generations without improvement of the best fitness
+                (overrides the stagnation_generations param)
+ --rows nb    : with --generate, the number of rows (defaults to 1000)
+ --vars nb    : with --generate, the number of input variables (defaults to 10)
+ --na-rate r  : with --generate, the probability of an input value to be missing (defaults to 0)
+ --balance r  : with --generate, the probability of the class 1 (defaults to 0.5)
+ --regression : with --generate, generate a regression dataset instead of a classification one
 
  -d path : Dataset  (REQUIRED)
  -p path : JSON parameters file (REQUIRED for fuzzy system inference)
@@ -118,12 +163,50 @@ Params parseArguments(const vector<string> &args)
       params.eval = true;
     } else if (arg == "--predict") {
       params.predict = true;
+    } else if (arg == "--float32") {
+      params.float32 = true;
+    } else if (arg == "--convert") {
+      params.convert = true;
+    } else if (arg == "--serve") {
+      params.serve = true;
+    } else if (arg == "--resume") {
+      params.resume = true;
+    } else if (arg == "--profile") {
+      params.profile = true;
+    } else if (arg == "--generate") {
+      params.generate = true;
+    } else if (arg == "--regression") {
+      params.regression = true;
     } else { // from there  we need a value
       if (i >= nb - 1)
         missingParamValue(arg);
 
       if (arg == "--nbout") {
         params.nb_output_vars = stoi(args.at(i + 1));
+      } else if (arg == "--chunk") {
+        params.chunk_size = stoi(args.at(i + 1));
+      } else if (arg == "--socket") {
+        params.socketPath = args.at(i + 1);
+      } else if (arg == "--checkpoint") {
+        params.checkpointFile = args.at(i + 1);
+      } else if (arg == "--checkpoint-interval") {
+        params.checkpoint_interval = stoi(args.at(i + 1));
+      } else if (arg == "--max-seconds") {
+        params.max_seconds = stod(args.at(i + 1));
+      } else if (arg == "--max-evaluations") {
+        params.max_evaluations = stod(args.at(i + 1));
+      } else if (arg == "--stagnation") {
+        params.stagnation_generations = stoi(args.at(i + 1));
+      } else if (arg == "--rows") {
+        params.nb_rows = stoi(args.at(i + 1));
+      } else if (arg == "--vars") {
+        params.nb_vars = stoi(args.at(i + 1));
+      } else if (arg == "--na-rate") {
+        params.na_rate = stod(args.at(i + 1));
+      } else if (arg == "--balance") {
+        params.class_balance = stod(args.at(i + 1));
+      } else if (arg == "--threads") {
+        params.nb_threads = stoi(args.at(i + 1));
       } else if (arg.at(1) == 'd')  {
         params.datasetFile = args[i + 1];
       } else if (arg.at(1) == 'p') {
@@ -158,7 +241,29 @@ void check_file(const string &filename)
 
 void check_params(const Params &params)
 {
-  if (params.eval || params.predict) {
+  if (params.generate) {
+    if (params.serve || params.convert || params.eval || params.predict)
+      error("--generate cannot be combined with --serve, --convert, --evaluate or --predict !");
+    if (!params.datasetFile.empty() || !params.paramsFile.empty() || !params.fuzzyFile.empty())
+      error("--generate does not use a dataset, a params file or a fuzzy system !");
+    if (params.nb_rows < 1 || params.nb_vars < 1)
+      error("the numbers of rows and variables must be >= 1");
+    if (!(params.na_rate >= 0 && params.na_rate < 1))
+      error("the NA rate must be in [0, 1[");
+    if (!(params.class_balance >= 0 && params.class_balance <= 1))
+      error("the class balance must be in [0, 1]");
+  }
+  else if (params.serve) {
+    if (params.eval || params.predict || params.convert)
+      error("--serve cannot be combined with --evaluate, --predict or --convert !");
+  }
+  else if (params.convert) {
+    if (params.eval || params.predict)
+      error("you cannot perform both a conversion and a evaluation/prediction !");
+    if ((params.datasetFile.empty() && params.fuzzyFile.empty()) || params.ouputPath.empty())
+      error("you must specify a dataset or a fuzzy system, and an output path to perform a conversion !");
+  }
+  else if (params.eval || params.predict) {
     if (params.eval && params.predict)
       error("you cannot perform both a prediction and a evaluation !");
     if (params.fuzzyFile.empty())
@@ -171,6 +276,32 @@ void check_params(const Params &params)
       error("you must load a dataset AND a params file to compute a FuzzySystem");
     }
   }
+  if (!is_na(params.nb_threads) && params.nb_threads < 0)
+    error("the number of threads must be >= 0");
+  if (params.chunk_size < 0)
+    error("the chunk size must be >= 0");
+  if (params.chunk_size > 0 && !params.predict && !params.serve)
+    error("--chunk can only be used with --predict or --serve");
+  if (!params.socketPath.empty() && !params.serve)
+    error("--socket can only be used with --serve");
+  if (!params.checkpointFile.empty() && (params.generate || params.serve || params.convert || params.eval || params.predict))
+    error("--checkpoint can only be used to compute a FuzzySystem");
+  if (params.resume && params.checkpointFile.empty())
+    error("--resume needs a --checkpoint file");
+  if (params.regression && !params.generate)
+    error("--regression can only be used with --generate");
+  if (params.checkpoint_interval < 1)
+    error("the checkpoint interval must be >= 1");
+  if (params.profile && (params.generate || params.serve || params.convert || params.eval || params.predict))
+    error("--profile can only be used to compute a FuzzySystem");
+  if (params.profile && !Profiler::available())
+    error("--profile: fuzzycoco was built without the profiler (cf the FUZZYCOCO_PROFILE cmake option)");
+  if (!is_na(params.max_seconds) && params.max_seconds < 0)
+    error("the maximum number of seconds must be >= 0");
+  if (!is_na(params.max_evaluations) && params.max_evaluations < 0)
+    error("the maximum number of evaluations must be >= 0");
+  if (!is_na(params.stagnation_generations) && params.stagnation_generations < 0)
+    error("the number of stagnation generations must be >= 0");
 
   check_file(params.datasetFile);
   check_file(params.paramsFile);
@@ -181,8 +312,59 @@ void check_params(const Params &params)
 
 void launch(const Params &params)
 {
+  if (params.generate) {
+    SyntheticDataset::Options options;
+    options.nb_rows = params.nb_rows;
+    options.nb_vars = params.nb_vars;
+    options.na_rate = params.na_rate;
+    options.class_balance = params.class_balance;
+    options.regression = params.regression;
+    if (params.seed >= 0) options.seed = params.seed;
+    if (params.ouputPath.empty()) {
+      SyntheticDataset::write(options, cout);
+    } else {
+      logger() << L_time << "saving synthetic dataset in " << params.ouputPath << endl;
+      SyntheticDataset::write(options, path(params.ouputPath));
+    }
+    return;
+  }
+  if (params.serve) {
+    PredictionServer::Options options;
+    if (!is_na(params.nb_threads)) options.nb_workers = params.nb_threads;
+    if (params.chunk_size > 0) options.max_batch_rows = params.chunk_size;
+    PredictionServer server(options);
+    if (params.socketPath.empty())
+      server.serve(cin, cout);
+    else
+      server.serveUnixSocket(params.socketPath);
+    logger() << L_time << "prediction server stats:\n" << server.stats();
+    return;
+  }
+  if (params.convert && params.datasetFile.empty()) {
+    logger() << L_time << "saving binary fuzzy system in " << params.ouputPath << endl;
+    FuzzySystem fs = FuzzyCoco::loadFuzzySystem(params.fuzzyFile);
+    FileUtils::mkdir_if_needed(params.ouputPath);
+    BinaryFuzzySystem::save(fs, path(params.ouputPath));
+    return;
+  }
   // read dataset
-  DataFrame df = DataFrame::load(params.datasetFile, true);
+  // N.B: the dataset is parsed using the same number of threads as the fitnesses
+  const int nb_load_threads = is_na(params.nb_threads) ? 1 : params.nb_threads;
+  if (params.predict && params.chunk_size > 0) {
+    // N.B: the dataset is never fully loaded
+    FuzzyCoco::loadAndPredictByChunks(params.datasetFile, params.fuzzyFile, cout, params.chunk_size, nb_load_threads,
+      params.float32 ? DataFrame::FLOAT32 : DataFrame::FLOAT64);
+    return;
+  }
+  DataFrame df = DataFrame::load(params.datasetFile, true, nb_load_threads);
+  if (params.float32)
+    df.setStorage(DataFrame::FLOAT32);
+  if (params.convert) {
+    logger() << L_time << "saving binary dataset in " << params.ouputPath << endl;
+    FileUtils::mkdir_if_needed(params.ouputPath);
+    BinaryDataFrame::save(df, path(params.ouputPath));
+    return;
+  }
   if (params.predict) {
     auto predicted = FuzzyCoco::loadAndPredict(df, params.fuzzyFile);
     FileUtils::writeCSV(cout, predicted);
@@ -195,11 +377,28 @@ void launch(const Params &params)
 
   auto input_params = NamedList::parse(StringUtils::stripComments(FileUtils::slurp(params.paramsFile)));
   FuzzyCocoParams coco_params(input_params);
+  if (!is_na(params.nb_threads))
+    coco_params.global_params.nb_threads = params.nb_threads;
+  if (!is_na(params.max_seconds))
+    coco_params.global_params.max_seconds = params.max_seconds;
+  if (!is_na(params.max_evaluations))
+    coco_params.global_params.max_evaluations = params.max_evaluations;
+  if (!is_na(params.stagnation_generations))
+    coco_params.global_params.stagnation_generations = params.stagnation_generations;
   // cerr << StringUtils::stripComments(FileUtils::slurp(params.paramsFile));
   // cerr << input_params;
 
   logger() << L_time << "FuzzyCoco::searchBestFuzzySystem()...\n";
-  auto results = FuzzyCoco::searchBestFuzzySystem(df, params.nb_output_vars, coco_params, params.seed);
+  Checkpoint::Options checkpoint;
+  checkpoint.filename = params.checkpointFile;
+  checkpoint.interval = params.checkpoint_interval;
+  checkpoint.resume = params.resume;
+  if (params.profile) Profiler::enable();
+  auto results = FuzzyCoco::searchBestFuzzySystem(df, params.nb_output_vars, coco_params, params.seed, checkpoint);
+  if (params.profile) {
+    Profiler::enable(false);
+    if (!results.empty()) results.add("profile", Profiler::describe());
+  }
 
   if (results.empty()) {
     cerr << "No results found\n";
@@ -235,5 +434,5 @@ int main(int argc, char *argv[])
     logger().activate();
   logger() << L_allwaysFlush << L_time << "Fuzzy Coco started\n";
 
-  launch(params);
+  ::launch(params);
 }
@@ -1,9 +1,9 @@
 #include "file_utils.h"
 #include <sstream>
 #include <fstream>
-#include <regex>
 
 #include "types.h"
+#include "csv_loader.h"
 
 using namespace fuzzy_coco;
 using namespace std;
@@ -20,30 +20,22 @@ void FileUtils::parseCSV(const path& filename, vector<vector<string>>& tokens, c
   
   if (!in.is_open())
     throw std::filesystem::filesystem_error("error opening file", filename, error_code());
-  return parseCSV(in, tokens);
+  return parseCSV(in, tokens, delim);
 }
 
 void FileUtils::parseCSV(const string& content, vector<vector<string>>& tokens, char delim) {
   istringstream str = istringstream(content);
-  return parseCSV(str, tokens);
+  return parseCSV(str, tokens, delim);
 }
 
 void FileUtils::parseCSV(istream& in, vector<vector<string>>& tokens, char delim) {
   string line;
-  vector<string> line_tokens;
-  string token;
-  const regex semicolon(string{delim});
+  vector<string_view> line_tokens;
   while(getline(in, line, '\n')) {
+    CsvLoader::splitLine(line, delim, line_tokens);
     // N.B: ignore any empty line
-    if (line.length()) {
-      copy(
-        sregex_token_iterator(line.begin(), line.end(), semicolon, -1),
-        sregex_token_iterator(),
-        back_inserter(line_tokens));
-
-        tokens.push_back(line_tokens);
-        line_tokens.resize(0);
-    }
+    if (!line_tokens.empty())
+      tokens.emplace_back(line_tokens.begin(), line_tokens.end());
   }
 }
 
@@ -56,15 +48,18 @@ void print_na(ostream& out, double v) {
   }
 }
 
-void FileUtils::writeCSV(ostream& out, const DataFrame& df, char delim) {
+// N.B: no endl, to avoid flushing the stream on each row
+void FileUtils::writeCSV(ostream& out, const DataFrame& df, char delim, bool header) {
   const auto& colnames = df.colnames();
   const int nbcols = df.nbcols();
-  for(int i = 0; i < nbcols; i++) {
-    out << colnames[i];
-    if (i != nbcols - 1) 
-      out << delim;
+  if (header) {
+    for(int i = 0; i < nbcols; i++) {
+      out << colnames[i];
+      if (i != nbcols - 1) 
+        out << delim;
+    }
+    out << '\n';
   }
-  out << endl;
 
   const int nbrows = df.nbrows();
   for(int i = 0; i < nbrows; i++) {
@@ -73,7 +68,7 @@ void FileUtils::writeCSV(ostream& out, const DataFrame& df, char delim) {
       if (j != nbcols - 1)
         out << delim;
     }
-    out << endl;
+    out << '\n';
   }
 }
 
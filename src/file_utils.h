@@ -20,8 +20,8 @@ namespace FileUtils
   void parseCSV(istream& in, vector<vector<string>>& tokens, char delim = ';');
   void parseCSV(const path& filename, vector<vector<string>>& tokens, char delim = ';');
 
-  // N.B: do not write the rownames
-  void writeCSV(ostream& out, const DataFrame& df, char delim = ';');
+  // N.B: do not write the rownames. header: whether to write the column names line
+  void writeCSV(ostream& out, const DataFrame& df, char delim = ';', bool header = true);
 
   string slurp(const path& filename);
 
@@ -0,0 +1,59 @@
+#include "fitness_cache.h"
+#include "digest.h"
+
+using namespace fuzzy_coco;
+
+size_t FitnessCache::hash(const Genome& left, const Genome& right) {
+  std::hash<Genome> hasher;
+  return Digest::hash_combine(hasher(left), hasher(right));
+}
+
+bool FitnessCache::lookup(const Genome& left, const Genome& right, double& fit) {
+  if (!enabled()) return false;
+  const size_t h = hash(left, right);
+  auto range = _index.equal_range(h);
+  for (auto it = range.first; it != range.second; ++it) {
+    auto entry = it->second;
+    if (entry->left == left && entry->right == right) {
+      // move to front: most recently used
+      _entries.splice(_entries.begin(), _entries, entry);
+      fit = entry->fitness;
+      _nb_hits++;
+      return true;
+    }
+  }
+  _nb_misses++;
+  return false;
+}
+
+void FitnessCache::insert(const Genome& left, const Genome& right, double fit) {
+  if (!enabled()) return;
+  const size_t h = hash(left, right);
+  _entries.push_front({h, left, right, fit});
+  _index.emplace(h, _entries.begin());
+  evict();
+}
+
+void FitnessCache::evict() {
+  while (size() > _capacity) {
+    auto last = prev(_entries.end());
+    auto range = _index.equal_range(last->hash);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == last) {
+        _index.erase(it);
+        break;
+      }
+    }
+    _entries.pop_back();
+  }
+}
+
+void FitnessCache::setCapacity(int capacity) {
+  _capacity = max(capacity, 0);
+  evict();
+}
+
+void FitnessCache::clear() {
+  _entries.clear();
+  _index.clear();
+}
@@ -0,0 +1,63 @@
+#ifndef FITNESS_CACHE_H
+#define FITNESS_CACHE_H
+
+#include <list>
+#include <unordered_map>
+#include "genome.h"
+
+namespace fuzzy_coco {
+
+using namespace std;
+
+// a bounded LRU (least recently used) cache of the fitness of (left, right) pairs of genomes
+// used to avoid re-evaluating the same pairs, e.g. the elite individuals or unchanged offspring
+// that are evaluated again with the same cooperators
+// N.B: the entries are indexed by a hash of both genomes, but the genomes are also stored and compared
+// so that hash collisions can not give wrong fitnesses
+class FitnessCache
+{
+public:
+  // N.B: a capacity of 0 disables the cache
+  FitnessCache(int capacity = 0) : _capacity(capacity) {}
+
+  // lookup the pair. If found, store its fitness in fit and return true
+  bool lookup(const Genome& left, const Genome& right, double& fit);
+  // N.B: the pair must not already be in the cache
+  void insert(const Genome& left, const Genome& right, double fit);
+
+  void clear();
+
+  // ========== accessors ===============
+  bool enabled() const { return _capacity > 0; }
+  int capacity() const { return _capacity; }
+  // N.B: evict the least recently used entries if needed
+  void setCapacity(int capacity);
+  int size() const { return _entries.size(); }
+
+  long getNbHits() const { return _nb_hits; }
+  long getNbMisses() const { return _nb_misses; }
+  void resetCounters() { _nb_hits = _nb_misses = 0; }
+
+  static size_t hash(const Genome& left, const Genome& right);
+
+private:
+  struct Entry {
+    size_t hash;
+    Genome left;
+    Genome right;
+    double fitness;
+  };
+  using Entries = list<Entry>;
+  void evict();
+
+private:
+  int _capacity;
+  // most recently used first
+  Entries _entries;
+  unordered_multimap<size_t, Entries::iterator> _index;
+  long _nb_hits = 0;
+  long _nb_misses = 0;
+};
+
+}
+#endif // FITNESS_CACHE_H
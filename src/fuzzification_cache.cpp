@@ -0,0 +1,66 @@
+#include "fuzzification_cache.h"
+
+using namespace fuzzy_coco;
+
+void FuzzificationCache::init(int nb_sets) {
+  const int nb_vars = _df.nbcols();
+  _nb_sets = nb_sets;
+  _columns.clear();
+  _columns.resize(nb_vars * nb_sets);
+  _computed.assign(nb_vars * nb_sets, false);
+  _positions.assign(nb_vars, vector<double>(nb_sets, MISSING_DATA_DOUBLE));
+  _nb_cached = 0;
+}
+
+void FuzzificationCache::invalidate() {
+  // N.B: keep the columns allocated for reuse
+  if (_nb_cached > 0) {
+    _computed.assign(_computed.size(), false);
+    _nb_cached = 0;
+  }
+}
+
+void FuzzificationCache::checkPositions(const FuzzyVariable& var, int var_idx) {
+  auto& positions = _positions[var_idx];
+  bool same = true;
+  for (int set_idx = 0; set_idx < _nb_sets; set_idx++) {
+    const double pos = var.getSet(set_idx).getPosition();
+    if (pos != positions[set_idx]) {
+      positions[set_idx] = pos;
+      same = false;
+    }
+  }
+  if (same) return;
+
+  for (int set_idx = 0; set_idx < _nb_sets; set_idx++) {
+    const int idx = var_idx * _nb_sets + set_idx;
+    if (_computed[idx]) {
+      _computed[idx] = false;
+      _nb_cached--;
+    }
+  }
+}
+
+const NumColumn& FuzzificationCache::fetch(const FuzzyVariablesDB& db, int var_idx, int set_idx) {
+  assert(db.getNbInputVars() == _df.nbcols());
+  assert(var_idx >= 0 && var_idx < _df.nbcols());
+  if (db.getNbInputSets() != _nb_sets) init(db.getNbInputSets());
+  assert(set_idx >= 0 && set_idx < _nb_sets);
+
+  const auto& var = db.getInputVariable(var_idx);
+  checkPositions(var, var_idx);
+
+  const int idx = var_idx * _nb_sets + set_idx;
+  auto& col = _columns[idx];
+  if (!_computed[idx]) {
+    fuzzify(var, set_idx, _df[var_idx], col);
+    _computed[idx] = true;
+    _nb_cached++;
+    _nb_computed++;
+  }
+  return col;
+}
+
+void FuzzificationCache::fuzzify(const FuzzyVariable& var, int set_idx, const ColumnView& values, NumColumn& res) {
+  var.fuzzify(set_idx, values, res);
+}
@@ -0,0 +1,62 @@
+#ifndef FUZZIFICATION_CACHE_H
+#define FUZZIFICATION_CACHE_H
+
+#include <vector>
+#include "dataframe.h"
+#include "fuzzy_variables_db.h"
+
+namespace fuzzy_coco {
+
+using namespace std;
+
+// a cache of the fuzzified input data columns
+// it stores, for a given input dataframe, the fuzzified values (i.e. membership values) of its columns
+// for each (input variable, set) pair. The columns are computed lazily, only when requested, so that
+// only the (var, set) pairs actually used by the current rules are computed.
+// The cached columns depend on the set positions of the input variables: these are recorded for each variable,
+// and the columns of a variable are recomputed as soon as its positions differ from the recorded ones.
+class FuzzificationCache
+{
+public:
+  // N.B: the dataframe is NOT copied, it must outlive the cache
+  FuzzificationCache(const DataFrame& df) : _df(df) {}
+  // N.B: a copy shares the dataframe but not the computed columns
+  FuzzificationCache(const FuzzificationCache& cache) : FuzzificationCache(cache.getData()) {}
+  ~FuzzificationCache() {}
+
+  // the fuzzified values of the input var var_idx for set set_idx. N.B: computed if needed.
+  // missing data (cf is_na()) is fuzzified to MISSING_DATA_DOUBLE
+  const NumColumn& fetch(const FuzzyVariablesDB& db, int var_idx, int set_idx);
+
+  // forget all cached columns
+  void invalidate();
+
+  // ========== accessors ===============
+  const DataFrame& getData() const { return _df; }
+  // number of currently computed columns
+  int getNbCachedColumns() const { return _nb_cached; }
+  // number of columns computed since the creation of the cache
+  long getNbComputedColumns() const { return _nb_computed; }
+
+  // fuzzify all the values of the column for the set set_idx of the variable var
+  static void fuzzify(const FuzzyVariable& var, int set_idx, const ColumnView& values, NumColumn& res);
+
+private:
+  void init(int nb_sets);
+  // check that the positions of var are the recorded ones, otherwise invalidate its columns
+  void checkPositions(const FuzzyVariable& var, int var_idx);
+
+private:
+  const DataFrame& _df;
+  int _nb_sets = 0;
+  // _columns[var_idx * _nb_sets + set_idx]
+  vector<NumColumn> _columns;
+  vector<bool> _computed;
+  // the set positions used to compute the columns, by var
+  vector<vector<double>> _positions;
+  int _nb_cached = 0;
+  long _nb_computed = 0;
+};
+
+}
+#endif // FUZZIFICATION_CACHE_H
@@ -0,0 +1,190 @@
+#include "fuzzify_kernels.h"
+#include "types.h"
+#include "dataframe.h" // for MISSING_DATA_FLOAT
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define FUZZIFY_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+using namespace fuzzy_coco;
+using namespace FuzzifyKernels;
+
+// N.B: the formulas and their evaluation order MUST be exactly the same as in FuzzyVariable::fuzzify()
+// Since all the branches are computed then selected, intermediate divisions by zero may happen, but their
+// results are always discarded
+static inline double fuzzify_one(SetKind kind, double before, double pos, double after, double value) {
+  if (is_na(value)) return MISSING_DATA_DOUBLE;
+  if (value == pos) return 1.0;
+  if (kind == LAST_SET || (kind == MIDDLE_SET && value < pos)) {
+    if (value > pos) return 1.0;
+    if (value <= before) return 0.0;
+    return (value - before) / (pos - before);
+  }
+  if (value < pos) return 1.0;
+  if (value >= after) return 0.0;
+  return 1.0 - ((value - pos) / (after - pos));
+}
+
+// N.B: float values are converted to double, with MISSING_DATA_FLOAT --> MISSING_DATA_DOUBLE
+static inline double to_double(double value) { return value; }
+static inline double to_double(float value) { return value == MISSING_DATA_FLOAT ? MISSING_DATA_DOUBLE : double(value); }
+
+template <typename T>
+static void fuzzify_scalar(SetKind kind, double before, double pos, double after, const T* values, int nb, double* res) {
+  for (int i = 0; i < nb; i++)
+    res[i] = fuzzify_one(kind, before, pos, after, to_double(values[i]));
+}
+
+#ifdef FUZZIFY_KERNELS_X86
+
+__attribute__((target("sse4.1")))
+static inline __m128d load2_sse41(const double* values) { return _mm_loadu_pd(values); }
+
+// N.B: 2 floats converted to doubles, the missing ones being converted to MISSING_DATA_DOUBLE
+__attribute__((target("sse4.1")))
+static inline __m128d load2_sse41(const float* values) { 
+  const __m128 f = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(values)));
+  const __m128d v = _mm_cvtps_pd(f);
+  const __m128d na_mask = _mm_cvtps_pd(_mm_cmpeq_ps(f, _mm_set1_ps(MISSING_DATA_FLOAT)));
+  return _mm_blendv_pd(v, _mm_set1_pd(MISSING_DATA_DOUBLE), na_mask);
+}
+
+template <typename T>
+__attribute__((target("sse4.1")))
+static void fuzzify_sse41(SetKind kind, double before, double pos, double after, const T* values, int nb, double* res) {
+  const __m128d vpos = _mm_set1_pd(pos), vbefore = _mm_set1_pd(before), vafter = _mm_set1_pd(after);
+  const __m128d zero = _mm_setzero_pd(), one = _mm_set1_pd(1.0), na = _mm_set1_pd(MISSING_DATA_DOUBLE);
+  const __m128d left_width = _mm_set1_pd(pos - before), right_width = _mm_set1_pd(after - pos);
+  int i = 0;
+  for (; i + 2 <= nb; i += 2) {
+    const __m128d v = load2_sse41(values + i);
+    __m128d r;
+    if (kind == FIRST_SET) {
+      __m128d right = _mm_sub_pd(one, _mm_div_pd(_mm_sub_pd(v, vpos), right_width));
+      right = _mm_blendv_pd(right, zero, _mm_cmpge_pd(v, vafter));
+      r = _mm_blendv_pd(right, one, _mm_cmplt_pd(v, vpos));
+    } else if (kind == LAST_SET) {
+      __m128d left = _mm_div_pd(_mm_sub_pd(v, vbefore), left_width);
+      left = _mm_blendv_pd(left, zero, _mm_cmple_pd(v, vbefore));
+      r = _mm_blendv_pd(left, one, _mm_cmpgt_pd(v, vpos));
+    } else {
+      // N.B: only one division, on the left or right side
+      const __m128d is_left = _mm_cmplt_pd(v, vpos);
+      const __m128d ratio = _mm_div_pd(_mm_sub_pd(v, _mm_blendv_pd(vpos, vbefore, is_left)), 
+        _mm_blendv_pd(right_width, left_width, is_left));
+      const __m128d left = _mm_blendv_pd(ratio, zero, _mm_cmple_pd(v, vbefore));
+      const __m128d right = _mm_blendv_pd(_mm_sub_pd(one, ratio), zero, _mm_cmpge_pd(v, vafter));
+      r = _mm_blendv_pd(right, left, is_left);
+    }
+    r = _mm_blendv_pd(r, one, _mm_cmpeq_pd(v, vpos));
+    // missing values mask
+    r = _mm_blendv_pd(r, na, _mm_cmpeq_pd(v, na));
+    _mm_storeu_pd(res + i, r);
+  }
+  fuzzify_scalar(kind, before, pos, after, values + i, nb - i, res + i);
+}
+
+__attribute__((target("avx2")))
+static inline __m256d load4_avx2(const double* values) { return _mm256_loadu_pd(values); }
+
+// N.B: 4 floats converted to doubles, the missing ones being converted to MISSING_DATA_DOUBLE
+__attribute__((target("avx2")))
+static inline __m256d load4_avx2(const float* values) { 
+  const __m128 f = _mm_loadu_ps(values);
+  const __m256d v = _mm256_cvtps_pd(f);
+  const __m256d na_mask = _mm256_cvtps_pd(_mm_cmpeq_ps(f, _mm_set1_ps(MISSING_DATA_FLOAT)));
+  return _mm256_blendv_pd(v, _mm256_set1_pd(MISSING_DATA_DOUBLE), na_mask);
+}
+
+template <typename T>
+__attribute__((target("avx2")))
+static void fuzzify_avx2(SetKind kind, double before, double pos, double after, const T* values, int nb, double* res) {
+  const __m256d vpos = _mm256_set1_pd(pos), vbefore = _mm256_set1_pd(before), vafter = _mm256_set1_pd(after);
+  const __m256d zero = _mm256_setzero_pd(), one = _mm256_set1_pd(1.0), na = _mm256_set1_pd(MISSING_DATA_DOUBLE);
+  const __m256d left_width = _mm256_set1_pd(pos - before), right_width = _mm256_set1_pd(after - pos);
+  int i = 0;
+  for (; i + 4 <= nb; i += 4) {
+    const __m256d v = load4_avx2(values + i);
+    __m256d r;
+    if (kind == FIRST_SET) {
+      __m256d right = _mm256_sub_pd(one, _mm256_div_pd(_mm256_sub_pd(v, vpos), right_width));
+      right = _mm256_blendv_pd(right, zero, _mm256_cmp_pd(v, vafter, _CMP_GE_OQ));
+      r = _mm256_blendv_pd(right, one, _mm256_cmp_pd(v, vpos, _CMP_LT_OQ));
+    } else if (kind == LAST_SET) {
+      __m256d left = _mm256_div_pd(_mm256_sub_pd(v, vbefore), left_width);
+      left = _mm256_blendv_pd(left, zero, _mm256_cmp_pd(v, vbefore, _CMP_LE_OQ));
+      r = _mm256_blendv_pd(left, one, _mm256_cmp_pd(v, vpos, _CMP_GT_OQ));
+    } else {
+      // N.B: only one division, on the left or right side
+      const __m256d is_left = _mm256_cmp_pd(v, vpos, _CMP_LT_OQ);
+      const __m256d ratio = _mm256_div_pd(_mm256_sub_pd(v, _mm256_blendv_pd(vpos, vbefore, is_left)), 
+        _mm256_blendv_pd(right_width, left_width, is_left));
+      const __m256d left = _mm256_blendv_pd(ratio, zero, _mm256_cmp_pd(v, vbefore, _CMP_LE_OQ));
+      const __m256d right = _mm256_blendv_pd(_mm256_sub_pd(one, ratio), zero, _mm256_cmp_pd(v, vafter, _CMP_GE_OQ));
+      r = _mm256_blendv_pd(right, left, is_left);
+    }
+    r = _mm256_blendv_pd(r, one, _mm256_cmp_pd(v, vpos, _CMP_EQ_OQ));
+    // missing values mask
+    r = _mm256_blendv_pd(r, na, _mm256_cmp_pd(v, na, _CMP_EQ_OQ));
+    _mm256_storeu_pd(res + i, r);
+  }
+  fuzzify_scalar(kind, before, pos, after, values + i, nb - i, res + i);
+}
+
+#endif // FUZZIFY_KERNELS_X86
+
+bool FuzzifyKernels::is_supported(Implementation impl) {
+  switch (impl) {
+    case SCALAR: return true;
+#ifdef FUZZIFY_KERNELS_X86
+    case SSE41: return __builtin_cpu_supports("sse4.1");
+    case AVX2: return __builtin_cpu_supports("avx2");
+#endif
+    default: return false;
+  }
+}
+
+Implementation FuzzifyKernels::best_implementation() {
+  static const Implementation best = is_supported(AVX2) ? AVX2 : (is_supported(SSE41) ? SSE41 : SCALAR);
+  return best;
+}
+
+string FuzzifyKernels::implementation_name(Implementation impl) {
+  switch (impl) {
+    case SSE41: return "sse4.1";
+    case AVX2: return "avx2";
+    default: return "scalar";
+  }
+}
+
+template <typename T>
+static void fuzzify_impl(Implementation impl, SetKind kind, double before, double pos, double after, const T* values, int nb, double* res) {
+  if (is_na(pos)) {
+    for (int i = 0; i < nb; i++) res[i] = MISSING_DATA_DOUBLE;
+    return;
+  }
+  switch (impl) {
+#ifdef FUZZIFY_KERNELS_X86
+    case SSE41: fuzzify_sse41(kind, before, pos, after, values, nb, res); break;
+    case AVX2: fuzzify_avx2(kind, before, pos, after, values, nb, res); break;
+#endif
+    default: fuzzify_scalar(kind, before, pos, after, values, nb, res);
+  }
+}
+
+void FuzzifyKernels::fuzzify(SetKind kind, double before, double pos, double after, const double* values, int nb, double* res) {
+  fuzzify(best_implementation(), kind, before, pos, after, values, nb, res);
+}
+
+void FuzzifyKernels::fuzzify(Implementation impl, SetKind kind, double before, double pos, double after, const double* values, int nb, double* res) {
+  fuzzify_impl(impl, kind, before, pos, after, values, nb, res);
+}
+
+void FuzzifyKernels::fuzzify(Implementation impl, SetKind kind, double before, double pos, double after, const float* values, int nb, double* res) {
+  fuzzify_impl(impl, kind, before, pos, after, values, nb, res);
+}
+
+void FuzzifyKernels::fuzzify(SetKind kind, double before, double pos, double after, const float* values, int nb, double* res) {
+  fuzzify(best_implementation(), kind, before, pos, after, values, nb, res);
+}
@@ -0,0 +1,41 @@
+#ifndef FUZZIFY_KERNELS_H
+#define FUZZIFY_KERNELS_H
+
+#include <string>
+
+namespace fuzzy_coco {
+
+using namespace std;
+
+// column-wise versions of FuzzyVariable::fuzzify(): fuzzify a whole column of values against one set
+// the SIMD (x86 SSE4.1 and AVX2) implementations are selected at runtime according to the CPU,
+// with a portable scalar fallback. All implementations give exactly the same (bitwise) results
+// as FuzzyVariable::fuzzify(), including for missing values.
+namespace FuzzifyKernels {
+
+  enum Implementation { SCALAR = 0, SSE41, AVX2 };
+
+  // the kind of set, that determines the shape of its membership function
+  enum SetKind { FIRST_SET, MIDDLE_SET, LAST_SET };
+  inline SetKind set_kind(int set_idx, int nb_sets) { 
+    return set_idx == 0 ? FIRST_SET : (set_idx == nb_sets - 1 ? LAST_SET : MIDDLE_SET); 
+  }
+
+  // fuzzify values[0, nb[ into res[0, nb[ for a set at position pos, whose previous and next sets are at 
+  // positions before and after (only used if they exist, according to kind)
+  // N.B: missing values (cf is_na()) are fuzzified to MISSING_DATA_DOUBLE, as are all values if pos is missing
+  void fuzzify(SetKind kind, double before, double pos, double after, const double* values, int nb, double* res);
+  // same using a given implementation, that must be supported
+  void fuzzify(Implementation impl, SetKind kind, double before, double pos, double after, const double* values, int nb, double* res);
+  // same on float values (cf DataFrame::FLOAT32), converted to double: MISSING_DATA_FLOAT is a missing value
+  void fuzzify(SetKind kind, double before, double pos, double after, const float* values, int nb, double* res);
+  void fuzzify(Implementation impl, SetKind kind, double before, double pos, double after, const float* values, int nb, double* res);
+
+  // the best implementation supported by the current CPU, that is used by fuzzify()
+  Implementation best_implementation();
+  bool is_supported(Implementation impl);
+  string implementation_name(Implementation impl);
+}
+
+}
+#endif // FUZZIFY_KERNELS_H
@@ -3,6 +3,9 @@
 #include "fuzzy_coco.h"
 #include "file_utils.h"
 #include "logging_logger.h"
+#include "thread_pool.h"
+#include "binary_fuzzy_system.h"
+#include "island_model.h"
 
 using namespace fuzzy_coco;
 using namespace logging;
@@ -85,19 +88,83 @@ CoevGeneration FuzzyCoco::run(int nb, double max_fit, CoevGeneration& from_gen)
   return getEngine().run(from_gen, nb, max_fit);
 }
 
-NamedList FuzzyCoco::searchBestFuzzySystem(const DataFrame& df, int nb_out_vars, const FuzzyCocoParams& params, int seed)
-{
-  logger() << L_time << "FuzzyCoco::searchBestFuzzySystem()...\n";
-  DataFrame dfin, dfout;
-  split_dataset(df, nb_out_vars, dfin, dfout);
+CoevGeneration FuzzyCoco::run(const Checkpoint::Options& checkpoint) {
+  const auto& p = getParams().global_params;
+  StoppingCriteria criteria(p);
+
+  CoevGeneration gen;
+  if (checkpoint.enabled() && checkpoint.resume && exists(path(checkpoint.filename))) {
+    auto state = Checkpoint::load(path(checkpoint.filename));
+    Checkpoint::checkParams(state, getParams());
+    if (state.coevolutions.size() != 1)
+      THROW_WITH_LOCATION("Error in FuzzyCoco::run(): the checkpoint was made with several islands");
+    gen = restoreState(state.coevolutions.front());
+    criteria.start(state.last_improvement, getFitnessMethod().getBestFitness(), state.elapsed_seconds);
+    logger() << L_time << "FuzzyCoco::run(): resuming from " << checkpoint.filename 
+      << " at generation " << gen.generation_number << endl;
+  } else {
+    gen = start(getEngine().getRng(), p.influence_rules_initial_population, p.influence_evolving_ratio);
+    criteria.start(gen.generation_number, getFitnessMethod().getBestFitness());
+  }
 
-  FuzzyCocoParams fixed_params = params;
-  fixed_params.fitness_params.fix_output_thresholds(nb_out_vars);
+  // N.B: evolving by chunks gives the same generations as evolving in one go
+  const int interval = checkpoint.enabled() ? max(checkpoint.interval, 1) : numeric_limits<int>::max();
+  _stop_reason = gen.generation_number >= p.max_generations ? StopReason::MAX_GENERATIONS : StopReason::NONE;
+  while (_stop_reason == StopReason::NONE) {
+    _stop_reason = getEngine().run(gen, criteria, interval);
+    if (!checkpoint.enabled()) continue;
+
+    Checkpoint::State state;
+    state.params = Checkpoint::describeParams(getParams());
+    state.elapsed_seconds = criteria.getElapsedSeconds();
+    state.last_improvement = criteria.getLastImprovement();
+    state.coevolutions.push_back(getState(gen));
+    Checkpoint::save(state, path(checkpoint.filename));
+  }
+  logger() << L_time << "FuzzyCoco::run(): stopped at generation " << gen.generation_number 
+    << ": " << toString(_stop_reason) << endl;
+  return gen;
+}
 
-  RandomGenerator rng(seed);
-  FuzzyCoco coco(dfin, dfout, fixed_params, rng);
+Checkpoint::CoevolutionState FuzzyCoco::getState(const CoevGeneration& gen) {
+  Checkpoint::CoevolutionState state;
+  state.generation = gen;
+  state.best = getFitnessMethod().getBest();
+  state.best_fitness = getFitnessMethod().getBestFitness();
+  state.nb_evaluations = getFitnessMethod().getNbEvaluations();
+  state.rng_state = getEngine().getRng().getState();
+  return state;
+}
 
-  auto gen = coco.run();
+static void check_genomes_sizes(const Genomes& genomes, size_t size) {
+  for (const auto& genome : genomes)
+    if (genome.size() != size)
+      THROW_WITH_LOCATION("Error in FuzzyCoco::restoreState(): bad genome size " + to_string(genome.size()) 
+        + ", expected " + to_string(size));
+}
+
+CoevGeneration FuzzyCoco::restoreState(const Checkpoint::CoevolutionState& state) {
+  auto& codec = getEngine().getFuzzyCocoCodec();
+  const auto& gen = state.generation;
+  for (const auto* genomes : {&gen.left_gen.individuals, &gen.left_gen.elite})
+    check_genomes_sizes(*genomes, codec.getRulesCodec().size());
+  for (const auto* genomes : {&gen.right_gen.individuals, &gen.right_gen.elite})
+    check_genomes_sizes(*genomes, codec.getMFsCodec().size());
+
+  getEngine().getRng().setState(state.rng_state);
+  getFitnessMethod().setBest(state.best, state.best_fitness);
+  getFitnessMethod().setNbEvaluations(state.nb_evaluations);
+  return state.generation;
+}
+
+// the results of a search: the best fuzzy system found by coco, or an empty NamedList if none
+// N.B: nb_evaluations is the number of fitness evaluations of the whole search, cached or not
+static NamedList describe_search_results(FuzzyCoco& coco, const FuzzyCocoParams& params, int nb_generations,
+  StopReason reason, double nb_evaluations)
+{
+  const auto& cache = coco.getFitnessMethod().getFitnessCache();
+  logger() << "FuzzyCoco::searchBestFuzzySystem(): fitness cache hits=" << cache.getNbHits() 
+    << ", misses=" << cache.getNbMisses() << endl;
   
   if (coco.getFitnessMethod().getBestFitness() <= 0) {
     // nothing found --> return empty results
@@ -107,8 +174,43 @@ NamedList FuzzyCoco::searchBestFuzzySystem(const DataFrame& df, int nb_out_vars,
   
   coco.selectBestFuzzySystem();
 
+  NamedList desc;
+  auto fit = FuzzyCoco::describeFit(coco.getFitnessMethod(), nb_generations, reason);
+  fit.add("nb_evaluations", nb_evaluations);
+  desc.add("fit", fit);
+  desc.add("fuzzy_system", coco.getFuzzySystem().describe());
+  desc.add("params", params.describe());
+  return desc;
+}
+
+NamedList FuzzyCoco::searchBestFuzzySystem(const DataFrame& df, int nb_out_vars, const FuzzyCocoParams& params, int seed,
+  const Checkpoint::Options& checkpoint)
+{
+  logger() << L_time << "FuzzyCoco::searchBestFuzzySystem()...\n";
+  DataFrame dfin, dfout;
+  split_dataset(df, nb_out_vars, dfin, dfout);
+
+  FuzzyCocoParams fixed_params = params;
+  fixed_params.fitness_params.fix_output_thresholds(nb_out_vars);
+
+  if (fixed_params.global_params.nb_islands > 1) {
+    IslandModel islands(dfin, dfout, fixed_params, seed);
+    auto gen = islands.run(checkpoint);
+    // N.B: the islands params differ (nb_threads) --> describe with the actual params
+    auto desc = describe_search_results(islands.getBestIsland(), fixed_params, gen.generation_number,
+      islands.getStopReason(), islands.getNbEvaluations());
+    logger() << L_time << "Exiting FuzzyCoco::searchBestFuzzySystem()\n";
+    return desc;
+  }
+
+  RandomGenerator rng(seed);
+  FuzzyCoco coco(dfin, dfout, fixed_params, rng);
+
+  auto gen = coco.run(checkpoint);
+  auto desc = describe_search_results(coco, coco.getParams(), gen.generation_number, coco.getStopReason(),
+    coco.getFitnessMethod().getNbEvaluations());
   logger() << L_time << "Exiting FuzzyCoco::searchBestFuzzySystem()\n";
-  return coco.describe(gen.generation_number);
+  return desc;
 }
 
 
@@ -124,11 +226,66 @@ DataFrame FuzzyCoco::loadAndPredict(const DataFrame& df, const NamedList& saved)
   return fs.smartPredict(df);
 }
 
+FuzzySystem FuzzyCoco::loadFuzzySystem(const string& fuzzy_file)
+{
+  if (BinaryFuzzySystem::isBinary(fuzzy_file))
+    return BinaryFuzzySystem::load(path(fuzzy_file));
+  return FuzzySystem::load(loadFuzzyFile(fuzzy_file)["fuzzy_system"]);
+}
+
 DataFrame FuzzyCoco::loadAndPredict(const DataFrame& df, const string& fuzzy_file)
 {
-  return loadAndPredict(df, loadFuzzyFile(fuzzy_file));
+  FuzzySystem fs = loadFuzzySystem(fuzzy_file);
+  return fs.smartPredict(df);
 }
 
+long FuzzyCoco::predictByChunks(CsvChunkReader& reader, const FuzzySystem& fs, ostream& out, int chunk_size, int nb_threads)
+{
+  assert(chunk_size > 0);
+  ThreadPool pool(nb_threads > 0 ? nb_threads : ThreadPool::hardware_concurrency());
+  const int nb_workers = pool.size();
+  // N.B: predicting uses the fuzzy system state --> one copy per worker
+  vector<FuzzySystem> systems(nb_workers, fs);
+  // at most one chunk per worker in memory
+  vector<DataFrame> chunks(nb_workers), predicted(nb_workers);
+
+  // header
+  const int nb_out_vars = fs.getDB().getNbOutputVars();
+  DataFrame header(0, nb_out_vars);
+  vector<string> output_names;
+  for (int i = 0; i < nb_out_vars; i++)
+    output_names.push_back(fs.getDB().getOutputVariable(i).getName());
+  header.colnames(output_names);
+  FileUtils::writeCSV(out, header);
+
+  long nb_rows = 0;
+  while (true) {
+    int nb_chunks = 0;
+    while (nb_chunks < nb_workers && reader.next(chunk_size, chunks[nb_chunks])) nb_chunks++;
+    if (nb_chunks == 0) break;
+
+    pool.run(nb_chunks, [&](int chunk_idx, int worker_idx) {
+      predicted[chunk_idx] = systems[worker_idx].smartPredict(chunks[chunk_idx]);
+    });
+
+    for (int i = 0; i < nb_chunks; i++) {
+      FileUtils::writeCSV(out, predicted[i], ';', false);
+      nb_rows += predicted[i].nbrows();
+    }
+  }
+  out.flush();
+
+  return nb_rows;
+}
+
+long FuzzyCoco::loadAndPredictByChunks(const string& data_file, const string& fuzzy_file, ostream& out, int chunk_size,
+  int nb_threads, DataFrame::Storage storage)
+{
+  FuzzySystem fs = loadFuzzySystem(fuzzy_file);
+  CsvChunkReader reader(path(data_file), true);
+  reader.setStorage(storage);
+  return predictByChunks(reader, fs, out, chunk_size, nb_threads);
+}
 
 NamedList FuzzyCoco::eval(const DataFrame& df, const FuzzySystem& fs, const FuzzyCocoParams& params)
 {
@@ -164,7 +321,7 @@ namespace fuzzy_coco {
   }
 }
 
-NamedList FuzzyCoco::describeFit(FuzzyCocoFitnessMethod& fitter, int nb_generations) {
+NamedList FuzzyCoco::describeFit(FuzzyCocoFitnessMethod& fitter, int nb_generations, StopReason reason) {
   auto metrics = fitter.fitMetrics();
   double fitness = fitter.fitnessImpl();
 
@@ -174,6 +331,8 @@ NamedList FuzzyCoco::describeFit(FuzzyCocoFitnessMethod& fitter, int nb_generati
 
   if (!is_na(nb_generations))
     fit.add("generations", nb_generations);
+  if (reason != StopReason::NONE)
+    fit.add("stop_reason", toString(reason));
 
   return fit;
 }
@@ -181,7 +340,7 @@ NamedList FuzzyCoco::describeFit(FuzzyCocoFitnessMethod& fitter, int nb_generati
 NamedList FuzzyCoco::describe(int nb_generations) 
 {
   NamedList desc;
-  desc.add("fit", describeFit(getFitnessMethod(), nb_generations));
+  desc.add("fit", describeFit(getFitnessMethod(), nb_generations, getStopReason()));
   desc.add("fuzzy_system", getFuzzySystem().describe());
   desc.add("params", getParams().describe());
 
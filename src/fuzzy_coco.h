@@ -2,6 +2,8 @@
 #define FUZZY_COCO_H
 
 #include "fuzzy_coco_engine.h"
+#include "csv_loader.h"
+#include "checkpoint.h"
 
 namespace fuzzy_coco {
 
@@ -18,7 +20,9 @@ public:
   virtual ~FuzzyCoco() {}
 
   // ================ main static interface ======================
-  static NamedList searchBestFuzzySystem(const DataFrame& df, int nb_out_vars, const FuzzyCocoParams& params, int seed);
+  // N.B: with checkpoint, the run is checkpointed periodically, and possibly resumed (cf Checkpoint)
+  static NamedList searchBestFuzzySystem(const DataFrame& df, int nb_out_vars, const FuzzyCocoParams& params, int seed,
+    const Checkpoint::Options& checkpoint = Checkpoint::Options());
   // static void searchBestFuzzySystemAndSave(const DataFrame& df, int nb_out_vars, const FuzzyCocoParams& params, int seed, const string& filename);
 
   DataFrame predict(const DataFrame& dfin) { return getFuzzySystem().smartPredict(dfin); }
@@ -26,6 +30,14 @@ public:
   static DataFrame loadAndPredict(const DataFrame& df, const NamedList& saved);
   static DataFrame loadAndPredict(const DataFrame& df, const string& fuzzy_file);
 
+  // predict in constant memory: the input is read by chunks of chunk_size rows, predicted in parallel
+  // by nb_threads threads (0 for all cores), and written in order as CSV to out (cf FileUtils::writeCSV())
+  // returns the number of rows predicted
+  static long predictByChunks(CsvChunkReader& reader, const FuzzySystem& fs, ostream& out, int chunk_size, int nb_threads = 1);
+  // N.B: the chunks are stored according to storage (cf DataFrame::setStorage())
+  static long loadAndPredictByChunks(const string& data_file, const string& fuzzy_file, ostream& out, int chunk_size,
+    int nb_threads = 1, DataFrame::Storage storage = DataFrame::FLOAT64);
+
   static void evalAndSave(const DataFrame& df, const string& fuzzy_file, ostream& out = cout);
   static NamedList eval(const DataFrame& df, const FuzzySystem& fs, const FuzzyCocoParams& params);
   // // highest level function, Runs everything using the params
@@ -33,20 +45,33 @@ public:
   CoevGeneration start(RandomGenerator& rng, bool influence, double evolving_ratio);
   CoevGeneration run(int nb, double max_fit, RandomGenerator& rng, bool influence = false, double evolving_ratio = 0.8);
   CoevGeneration run(int nb, double max_fit, bool influence = false, double evolving_ratio = 0.8);
-  CoevGeneration run() { 
-    const auto& p = getParams().global_params; 
-    return run(p.max_generations, p.max_fitness, p.influence_rules_initial_population, p.influence_evolving_ratio); 
-  }
+  // run until one of the stopping criteria of the params is met, cf getStopReason()
+  CoevGeneration run() { return run(Checkpoint::Options()); }
   CoevGeneration run(int nb, double max_fit, CoevGeneration& from_gen);
+  // same as run(), but saves a checkpoint every checkpoint.interval generations, and resumes from
+  // the checkpoint file if requested. N.B: the results are identical to those of run()
+  CoevGeneration run(const Checkpoint::Options& checkpoint);
+
+  // why the last run() stopped, or NONE
+  StopReason getStopReason() const { return _stop_reason; }
+
+  // the state of the coevolution at generation gen, cf Checkpoint
+  Checkpoint::CoevolutionState getState(const CoevGeneration& gen);
+  // restore a state from getState() and return its generation.
+  // N.B: throws a runtime_error if the genomes do not match the codec
+  CoevGeneration restoreState(const Checkpoint::CoevolutionState& state);
 
   NamedList describeBestFuzzySystem() { return getEngine().describeBestFuzzySystem(); }
 
   NamedList describe(int nb_generations = MISSING_DATA_INT);
-  static NamedList describeFit(FuzzyCocoFitnessMethod& fitter, int nb_generations = MISSING_DATA_INT);
+  static NamedList describeFit(FuzzyCocoFitnessMethod& fitter, int nb_generations = MISSING_DATA_INT,
+    StopReason reason = StopReason::NONE);
 
   static FuzzyCoco load(const NamedList desc);
 
   static NamedList loadFuzzyFile(const string& fuzzy_file);
+  // load the fuzzy system of a fuzzy file, either a saved fit (JSON) or a binary fuzzy system (cf BinaryFuzzySystem)
+  static FuzzySystem loadFuzzySystem(const string& fuzzy_file);
 
   // set the shared Fuzzy System with the rules and MFs that achieve the best fitness computed so far
   void selectBestFuzzySystem() { getEngine().rebuildBestFuzzySystem(); }
@@ -87,6 +112,7 @@ private:
 
   unique_ptr<FuzzyCocoFitnessMethod> _fitter_ptr;
   FuzzyCocoEngine _engine;
+  StopReason _stop_reason = StopReason::NONE;
 };
 
 }
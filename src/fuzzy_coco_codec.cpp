@@ -1,5 +1,6 @@
 #include "fuzzy_coco_codec.h"
 #include "logging_logger.h"
+#include "profiler.h"
 
 using namespace fuzzy_coco;
 using namespace logging;
@@ -85,8 +86,7 @@ Genome FuzzyCocoCodec::encode(const Matrix<double>& pos_in, const Matrix<double>
 
 void FuzzyCocoCodec::decode(const Genome& mfs_genome, Matrix<double>& pos_in, Matrix<double>& pos_out)
 {
-  auto it = mfs_genome.cbegin();
-  getMFsCodec().decode(it, pos_in, pos_out);
+  getMFsCodec().decode(mfs_genome, _mfs_fields, pos_in, pos_out);
 }
 
 // void FuzzyCocoCodec::decode(const Genome& rules_genome, const FuzzyVariablesDB& db, vector<FuzzyRule>& rules, vector<FuzzyDefaultRule>& default_rules) 
@@ -113,26 +113,25 @@ void FuzzyCocoCodec::decode(
     vector<ConditionIndexes>& rules_out,
     vector<int>& default_rules)
 {
-  auto it1 = rules_genome.cbegin();
-  getRulesCodec().decode(it1, rules_in, rules_out, default_rules);
+  getRulesCodec().decode(rules_genome, _rules_fields, rules_in, rules_out, default_rules);
 }
 
 void FuzzyCocoCodec::setRulesGenome(FuzzySystem& fs, const Genome& rules_genome) {
+  PROFILE_PHASE(DECODE);
   decode(rules_genome, _rules_in, _rules_out, _default_rules);
 
   const int MAX_NB_RULES = _rules_in.size();
   fs.resetRules(MAX_NB_RULES);
 
-  for (int i = 0; i < MAX_NB_RULES; i++) {
-    FuzzyRule rule(fs.getDB(), _rules_in[i],  _rules_out[i], true); // NB: filter==true
-    if (rule.getNbInputConditions() > 0 && rule.getNbOutputConditions() > 0)
-      fs.addRule(std::move(rule));
-  }
+  // N.B: the conditions are filtered directly into the rules table, without building FuzzyRule objects
+  for (int i = 0; i < MAX_NB_RULES; i++)
+    fs.addFilteredRule(_rules_in[i], _rules_out[i]);
 
   fs.setDefaultRulesConditions(_default_rules);
 }
 
 void FuzzyCocoCodec::setMFsGenome(FuzzySystem& fs, const Genome& mfs_genome) {
+  PROFILE_PHASE(DECODE);
   decode(mfs_genome, _pos_in, _pos_out);
   fs.setVariablesSetPositions(_pos_in, _pos_out);
 }
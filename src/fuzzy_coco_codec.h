@@ -64,6 +64,8 @@ private:
   vector<ConditionIndexes> _rules_out;
   vector<int> _default_rules;
   Matrix<double> _pos_in, _pos_out;
+  // the decoded genome fields, cf FieldsDecoder
+  vector<int> _rules_fields, _mfs_fields;
 };
 
 }
@@ -118,6 +118,17 @@ CoevGeneration FuzzyCocoEngine::run() {
     getParams().global_params.max_fitness);
 }
 
+StopReason FuzzyCocoEngine::run(CoevGeneration& gen, StoppingCriteria& criteria, int nb) {
+  const auto& fit = getFitnessMethod();
+  for (int i = 0; i < nb; i++) {
+    gen = next(gen);
+    logger() << L_time << "generation " << gen.generation_number << ": fitness=" << gen.fitness << endl;
+    const auto reason = criteria.check(gen.generation_number, gen.fitness, fit.getBestFitness(), fit.getNbEvaluations());
+    if (reason != StopReason::NONE) return reason;
+  }
+  return StopReason::NONE;
+}
+
 CoevGeneration FuzzyCocoEngine::run(CoevGeneration& gen, int nb, double max_fit) {
   // auto gen = start();
 
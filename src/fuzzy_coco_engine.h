@@ -3,6 +3,7 @@
 
 #include "fuzzy_coco_fitness.h"
 #include "coevolution_engine.h"
+#include "stopping_criteria.h"
 
 namespace fuzzy_coco {
 
@@ -20,6 +21,9 @@ public:
   
   // highest level function, Runs everything using the params
   CoevGeneration run(CoevGeneration& gen, int nb, double max_fit);
+  // evolve gen for at most nb generations, until one of the criteria is met: returns the reason, or NONE
+  // N.B: the criteria must have been started, cf StoppingCriteria::start()
+  StopReason run(CoevGeneration& gen, StoppingCriteria& criteria, int nb);
   CoevGeneration run();
 
   Genomes buildRulesGenomes(int nb_pop_rules);
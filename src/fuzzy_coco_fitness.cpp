@@ -3,6 +3,7 @@
 #include "fuzzy_coco_fitness.h"
 #include "fuzzy_coco.h"
 #include "logging_logger.h"
+#include "profiler.h"
 
 using namespace fuzzy_coco;
 using namespace logging;
@@ -17,15 +18,56 @@ FuzzyCocoFitnessMethod::FuzzyCocoFitnessMethod(FuzzySystem& fs,FuzzySystemFitnes
                                                const DataFrame &dfin, const DataFrame &dfout, const FuzzyCocoParams& params)
   : CoopCoevolutionFitnessMethod(),  
       _actual_dfin(dfin),_actual_dfout(dfout), 
+      _params(params),
       _fuzzy_system(fs),
       _codec(dfin, dfout, params),
       _fsmc(), 
+      _fuzzification_cache(dfin),
       _fitter(fitter), 
-      _thresholds(params.fitness_params.output_vars_defuzz_thresholds)
+      _thresholds(_params.fitness_params.output_vars_defuzz_thresholds),
+      _nb_threads(params.global_params.nb_threads > 0 ? params.global_params.nb_threads : ThreadPool::hardware_concurrency())
 {
   assert(_thresholds.size() == (size_t)dfout.nbcols());
+  _fuzzy_system.setTNorm(parseTNorm(params.global_params.t_norm));
+  getFitnessCache().setCapacity(params.global_params.fitness_cache_size);
 }//KCOV IGNORE
 
+unique_ptr<FuzzyCocoFitnessMethod> FuzzyCocoFitnessMethod::clone(FuzzySystem& fs, const FuzzyCocoParams& params) const
+{
+  return make_unique<FuzzyCocoFitnessMethod>(fs, _fitter, _actual_dfin, _actual_dfout, params);
+}
+
+void FuzzyCocoFitnessMethod::initWorkers()
+{
+  if (_pool) return;
+  // N.B: the workers are single-threaded and do not use a cache (handled by the main instance)
+  FuzzyCocoParams worker_params = getParams();
+  worker_params.global_params.nb_threads = 1;
+  worker_params.global_params.fitness_cache_size = 0;
+
+  _pool = make_unique<ThreadPool>(getNbThreads());
+  _workers.reserve(_pool->size());
+  for (int i = 0; i < _pool->size(); i++)
+    _workers.push_back(make_unique<Worker>(*this, worker_params));
+}
+
+// N.B: each pair is evaluated by a worker, with its own fuzzy system, codec, metrics computer...
+// the results only depend on the pairs, so are identical to the serial evaluation
+void FuzzyCocoFitnessMethod::fitnessImplBatch(const vector<GenomePair>& pairs, vector<double>& fitnesses)
+{
+  const int nb = pairs.size();
+  if (getNbThreads() <= 1 || nb <= 1) {
+    CoopCoevolutionFitnessMethod::fitnessImplBatch(pairs, fitnesses);
+    return;
+  }
+
+  initWorkers();
+  fitnesses.resize(nb);
+  _pool->run(nb, [&](int i, int worker_idx) {
+    fitnesses[i] = _workers[worker_idx]->fitter->fitnessImpl(pairs[i].left, pairs[i].right);
+  });
+}
+
 bool FuzzyCocoFitnessMethod::resetFuzzySystem(const Genome& rules_genome, const Genome& vars_genome)
 {
 
@@ -45,6 +87,7 @@ double FuzzyCocoFitnessMethod::computeFuzzySystemFitness(FuzzySystem& fs, FuzzyS
 
 double FuzzyCocoFitnessMethod::fitnessImpl(const Genome& rules_genome, const Genome& mfs_genome) 
 {
+  PROFILE_PHASE(EVALUATION);
   if (!resetFuzzySystem(rules_genome, mfs_genome)) 
     return 0; 
   return fitnessImpl();
@@ -56,13 +99,34 @@ double FuzzyCocoFitnessMethod::fitnessImpl() {
 
 FuzzySystemMetrics FuzzyCocoFitnessMethod::fitMetrics() 
 {
-  auto predicted_output = getFuzzySystem().predict(_actual_dfin);
-  return computeMetrics(predicted_output, _actual_dfout);
+  auto& fs = getFuzzySystem();
+  const int nb_samples = fs.computeOutputSetsResultsBatch(_fuzzification_cache);
+  const int nb_vars = _actual_dfout.nbcols();
+  const auto& results = fs.getState().batch_output_sets_results;
+
+  FuzzySystemMetrics metrics;
+  for (int var_idx = 0; var_idx < nb_vars; var_idx++) {
+    FuzzySystemMetricsComputer::VariableAccumulator acc(_thresholds[var_idx]);
+    if (nb_samples > 0) {
+      PROFILE_PHASE(DEFUZZIFICATION);
+      const auto& actual = _actual_dfout[var_idx];
+      fs.defuzzifyVariableBatch(results, var_idx, nb_samples, [&](int i, double predicted) { acc.add(predicted, actual[i]); });
+    }
+    metrics += acc.metrics();
+  }
+  PROFILE_PHASE(METRICS);
+  FuzzySystemMetricsComputer::averageOverVariables(metrics, nb_vars);
+
+  // VERY IMPORTANT FOR NOW: need to add the number of variables used in the rules
+  metrics.nb_vars = fs.computeTotalInputVarsUsedInRules();
+
+  return metrics;
 }
 
 
 FuzzySystemMetrics FuzzyCocoFitnessMethod::computeMetrics(const DataFrame& predicted, const DataFrame& actual) 
 {
+  PROFILE_PHASE(METRICS);
   auto metrics = _fsmc.compute(predicted, actual, _thresholds);
     
   // VERY IMPORTANT FOR NOW: need to add the number of variables used in the rules
@@ -84,8 +148,14 @@ FuzzyCocoFeaturesWeightsFitnessMethod::FuzzyCocoFeaturesWeightsFitnessMethod(
   _sum_of_weights = std::accumulate(_features_weights.begin(), _features_weights.end(), double(0));
 }
 
+unique_ptr<FuzzyCocoFitnessMethod> FuzzyCocoFeaturesWeightsFitnessMethod::clone(FuzzySystem& fs, const FuzzyCocoParams& params) const
+{
+  return make_unique<FuzzyCocoFeaturesWeightsFitnessMethod>(fs, getFuzzySystemFitness(), getInputData(), getOutputData(), params);
+}
+
 double FuzzyCocoFeaturesWeightsFitnessMethod::fitnessImpl(const Genome& rules_genome, const Genome& mfs_genome) 
 {
+  PROFILE_PHASE(EVALUATION);
   if (!resetFuzzySystem(rules_genome, mfs_genome)) return 0.0;
   return fitnessImpl();
 }
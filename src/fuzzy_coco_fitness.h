@@ -7,6 +7,7 @@
 #include "fuzzy_system_metrics_computer.h"
 #include "fuzzy_system_fitness.h"
 #include "coevolution_engine.h"
+#include "thread_pool.h"
 
 namespace fuzzy_coco {
 
@@ -28,9 +29,14 @@ public: // VIRTUAL INTERFACE
     
     // main method: compute the fitness for a (rules, vars) pair of genomes
   double fitnessImpl(const Genome& rules_genome, const Genome& vars_genome) override;
+  // N.B: evaluated in parallel if params.global_params.nb_threads != 1, using workers (cf clone())
+  void fitnessImplBatch(const vector<GenomePair>& pairs, vector<double>& fitnesses) override;
   // mostly for tests
   virtual string description() const { return "FuzzyCocoFitnessMethod"; }
 
+  // create a new instance of the same class, with the same data but using the fuzzy system fs and those params
+  virtual unique_ptr<FuzzyCocoFitnessMethod> clone(FuzzySystem& fs, const FuzzyCocoParams& params) const;
+
 public: 
   // compute the fitness of the current embedded fuzzy system
   virtual double fitnessImpl();
@@ -47,6 +53,8 @@ public:
   // return if the fuzzy system is consistent/ok
   bool resetFuzzySystem(const Genome& rules_genome, const Genome& vars_genome);
 
+  // N.B: fused prediction and scoring: the metrics are accumulated as the defuzzified values are produced,
+  // without building the predicted DataFrame. Gives the same results as computeMetrics(predict())
   FuzzySystemMetrics fitMetrics();
   FuzzySystemMetrics computeMetrics(const DataFrame& predicted, const DataFrame& actual); 
 public:
@@ -54,23 +62,45 @@ public:
   const FuzzyCocoCodec& getFuzzyCocoCodec() const { return _codec; }
   FuzzySystem& getFuzzySystem() { return _fuzzy_system; }
   const FuzzySystem& getFuzzySystem() const { return _fuzzy_system; }
-  FuzzySystemFitness& getFuzzySystemFitness() { return _fitter; }
+  FuzzySystemFitness& getFuzzySystemFitness() const { return _fitter; }
 
   FuzzySystemMetricsComputer& getMetricsComputer() { return _fsmc; }
   const vector<double>& getThresholds() const { return _thresholds; }
 
   const DataFrame& getInputData() const { return _actual_dfin; }
+  const DataFrame& getOutputData() const { return _actual_dfout; }
+  const FuzzyCocoParams& getParams() const { return _params; }
+  // the number of threads used to evaluate the fitnesses, cf fitnessImplBatch()
+  int getNbThreads() const { return _nb_threads; }
+  FuzzificationCache& getFuzzificationCache() { return _fuzzification_cache; }
 
 protected:
   const DataFrame& _actual_dfin;
   const DataFrame& _actual_dfout;
 
 private:
+  // a worker for the parallel evaluation, that owns its fuzzy system and fitness method
+  struct Worker {
+    Worker(const FuzzyCocoFitnessMethod& main, const FuzzyCocoParams& params) 
+      : fs(main.getFuzzySystem().getDB()), fitter(main.clone(fs, params)) {}
+    FuzzySystem fs;
+    unique_ptr<FuzzyCocoFitnessMethod> fitter;
+  };
+  void initWorkers();
+
+private:
+  const FuzzyCocoParams _params;
   FuzzySystem& _fuzzy_system;
   FuzzyCocoCodec _codec;
   FuzzySystemMetricsComputer _fsmc;
+  // the fuzzified input data, reused across evaluations as long as the MFs (set positions) do not change
+  FuzzificationCache _fuzzification_cache;
   FuzzySystemFitness& _fitter;
   const vector<double>& _thresholds;
+
+  int _nb_threads;
+  unique_ptr<ThreadPool> _pool;
+  vector<unique_ptr<Worker>> _workers;
 };
 
 
@@ -87,6 +117,7 @@ public: // INTERFACE
   // main method: compute the fitness for a (rules, vars) pair of genomes
   double fitnessImpl(const Genome& rules_genome, const Genome& mfs_genome) override;
   string description() const override { return "FuzzyCocoFeaturesWeightsFitnessMethod"; }
+  unique_ptr<FuzzyCocoFitnessMethod> clone(FuzzySystem& fs, const FuzzyCocoParams& params) const override;
 public: // NON INTERFACE 
   double fitnessImpl() override;
 
@@ -1,6 +1,7 @@
 #include <cmath>
 #include "fuzzy_coco_params.h"
 #include "dataframe.h"
+#include "fuzzy_operator.h"
 #include "logging_logger.h"
 
 using namespace fuzzy_coco;
@@ -45,9 +46,19 @@ NamedList GlobalParams::describe() const {
   desc.add("nb_max_var_per_rule", nb_max_var_per_rule);
   desc.add("max_generations", max_generations);
   desc.add("max_fitness", max_fitness);
+  desc.add("max_seconds", max_seconds);
+  desc.add("max_evaluations", max_evaluations);
+  desc.add("stagnation_generations", stagnation_generations);
   desc.add("nb_cooperators", nb_cooperators);
   desc.add("influence_rules_initial_population", influence_rules_initial_population);
   desc.add("influence_evolving_ratio", influence_evolving_ratio);
+  desc.add("fitness_cache_size", fitness_cache_size);
+  desc.add("nb_threads", nb_threads);
+  desc.add("t_norm", t_norm);
+  desc.add("nb_islands", nb_islands);
+  desc.add("migration_interval", migration_interval);
+  desc.add("migration_topology", migration_topology);
+  desc.add("nb_migrants", nb_migrants);
   return desc;
 } 
 
@@ -56,9 +67,26 @@ GlobalParams::GlobalParams(const NamedList& desc) {
   nb_max_var_per_rule = desc.get_as_int("nb_max_var_per_rule", nb_max_var_per_rule);
   max_generations = desc.get_as_int("max_generations", max_generations);
   max_fitness = desc.get_double("max_fitness", max_fitness);
+  max_seconds = desc.get_numeric("max_seconds", max_seconds);
+  max_evaluations = desc.get_numeric("max_evaluations", max_evaluations);
+  stagnation_generations = desc.get_as_int("stagnation_generations", stagnation_generations);
+  if (max_seconds < 0 || max_evaluations < 0 || stagnation_generations < 0)
+    throw runtime_error("max_seconds, max_evaluations and stagnation_generations must be >= 0");
   nb_cooperators = desc.get_as_int("nb_cooperators", nb_cooperators);
   influence_rules_initial_population = desc.get_bool("influence_rules_initial_population", influence_rules_initial_population);
   influence_evolving_ratio = desc.get_double("influence_evolving_ratio", influence_evolving_ratio);
+  fitness_cache_size = desc.get_as_int("fitness_cache_size", fitness_cache_size);
+  nb_threads = desc.get_as_int("nb_threads", nb_threads);
+  t_norm = desc.get_string("t_norm", t_norm);
+  parseTNorm(t_norm); // N.B: throws in case of a bad name
+  nb_islands = desc.get_as_int("nb_islands", nb_islands);
+  if (nb_islands < 1) throw runtime_error("nb_islands must be >= 1");
+  migration_interval = desc.get_as_int("migration_interval", migration_interval);
+  if (migration_interval < 1) throw runtime_error("migration_interval must be >= 1");
+  migration_topology = desc.get_string("migration_topology", migration_topology);
+  parseMigrationTopology(migration_topology); // N.B: throws in case of a bad name
+  nb_migrants = desc.get_as_int("nb_migrants", nb_migrants);
+  if (nb_migrants < 0) throw runtime_error("nb_migrants must be >= 0");
 }
 
 bool GlobalParams::operator==(const GlobalParams& p) const {
@@ -67,8 +95,18 @@ bool GlobalParams::operator==(const GlobalParams& p) const {
         nb_max_var_per_rule == p.nb_max_var_per_rule && 
         max_generations == p.max_generations &&
         max_fitness == p.max_fitness&&
+        max_seconds == p.max_seconds &&
+        max_evaluations == p.max_evaluations &&
+        stagnation_generations == p.stagnation_generations &&
         nb_cooperators == p.nb_cooperators &&
-        influence_rules_initial_population == p.influence_rules_initial_population;
+        influence_rules_initial_population == p.influence_rules_initial_population &&
+        fitness_cache_size == p.fitness_cache_size &&
+        nb_threads == p.nb_threads &&
+        t_norm == p.t_norm &&
+        nb_islands == p.nb_islands &&
+        migration_interval == p.migration_interval &&
+        migration_topology == p.migration_topology &&
+        nb_migrants == p.nb_migrants;
 }
 
 
@@ -5,6 +5,7 @@
 #include <iostream>
 #include <cmath>
 #include <map>
+#include <stdexcept>
 
 #include "fuzzy_system_metrics.h"
 #include "evolution_params.h"
@@ -40,6 +41,16 @@ struct VarsParams {
   friend ostream& operator<<(ostream& out, const VarsParams& p);
 };
 
+// the topology of the migrations between the islands, cf GlobalParams::nb_islands
+enum class MigrationTopology { RING, RANDOM };
+
+// N.B: throws a runtime exception in case of an unknown name
+inline MigrationTopology parseMigrationTopology(const string& name) {
+  if (name == "ring") return MigrationTopology::RING;
+  if (name == "random") return MigrationTopology::RANDOM;
+  throw runtime_error("bad migration topology '" + name + "', must be one of ring, random");
+}
+
 struct GlobalParams {
   GlobalParams() = default;
   GlobalParams(const NamedList& desc);
@@ -55,6 +66,14 @@ struct GlobalParams {
   int max_generations = 100;
   // the fitness theshold to stop the evolution. N.B: > 1 means that it will never early-stop
   double max_fitness = 1;
+  // the wall-clock budget of the evolution, in seconds. 0 means no limit
+  // N.B: the results then depend on the speed of the machine
+  double max_seconds = 0;
+  // the maximum number of fitness evaluations, i.e. of evaluated (rules, MFs) pairs. 0 means no limit
+  // N.B: a double for the large budgets
+  double max_evaluations = 0;
+  // stop when the best fitness has not improved for that number of generations. 0 means never
+  int stagnation_generations = 0;
   // the number of cooperators to use to evaluate the fitness in the coevolution algorithm
   int nb_cooperators = 2;
 
@@ -63,6 +82,24 @@ struct GlobalParams {
   // the evolving ratio to use, cf influence_rules_initial_population
   double influence_evolving_ratio = 0.8;
 
+  // the max number of (rules, MFs) fitnesses to cache. 0 disables the cache
+  int fitness_cache_size = 10000;
+  // the number of threads to use to evaluate the fitnesses. 0 means all the hardware threads
+  // N.B: the results do not depend on the number of threads
+  int nb_threads = 1;
+  // the t-norm used to combine the rules input conditions: min, product or lukasiewicz
+  string t_norm = "min";
+
+  // the number of islands, i.e. of independent coevolutions evolved in parallel. 1 disables the island model
+  // N.B: the results depend on the number of islands, not on the number of threads
+  int nb_islands = 1;
+  // the number of generations between two migrations between the islands
+  int migration_interval = 10;
+  // how the migrants are sent: ring (to the next island) or random (to a random other island)
+  string migration_topology = "ring";
+  // the number of best rules and MFs genomes that migrate from each island
+  int nb_migrants = 1;
+
   bool has_missing() const { 
       return is_na(nb_rules) || is_na(nb_max_var_per_rule) || is_na(max_generations) || is_na(max_fitness) || is_na(nb_cooperators); 
   }
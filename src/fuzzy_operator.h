@@ -2,8 +2,66 @@
 #ifndef FUZZY_OPERATOR_H
 #define FUZZY_OPERATOR_H
 
+#include <algorithm>
+#include <string>
+#include <stdexcept>
+
 namespace fuzzy_coco {
 
+using namespace std;
+
+// the t-norms available for the AND of the rules antecedents
+enum class TNorm { MIN, PRODUCT, LUKASIEWICZ };
+
+// N.B: throws a runtime exception in case of an unknown name
+inline TNorm parseTNorm(const string& name) {
+  if (name == "min") return TNorm::MIN;
+  if (name == "product") return TNorm::PRODUCT;
+  if (name == "lukasiewicz") return TNorm::LUKASIEWICZ;
+  throw runtime_error("bad t-norm name '" + name + "', must be one of min, product, lukasiewicz");
+}
+
+inline string toString(TNorm tnorm) {
+  switch (tnorm) {
+    case TNorm::PRODUCT: return "product";
+    case TNorm::LUKASIEWICZ: return "lukasiewicz";
+    default: return "min";
+  }
+}
+
+// the t-norms implementations, to be used as template parameters so that the evaluation kernels
+// are specialized and inlined, cf FuzzyRule::evaluateFireLevels()
+// N.B: the DONTCARE/missing values are < 0: if x or y is < 0, return the other (the max) then.
+// If both are < 0 --> < 0
+struct TNormMin {
+  static double operate(double x, double y) {
+    double res = min(x, y);
+    return res >= 0 ? res : max(x, y);
+  }
+};
+
+struct TNormProduct {
+  static double operate(double x, double y) {
+    return min(x, y) >= 0 ? x * y : max(x, y);
+  }
+};
+
+struct TNormLukasiewicz {
+  static double operate(double x, double y) {
+    return min(x, y) >= 0 ? max(0.0, x + y - 1) : max(x, y);
+  }
+};
+
+// call f(T{}) with T the implementation of tnorm
+template <typename F>
+inline auto dispatchTNorm(TNorm tnorm, F&& f) {
+  switch (tnorm) {
+    case TNorm::PRODUCT: return f(TNormProduct{});
+    case TNorm::LUKASIEWICZ: return f(TNormLukasiewicz{});
+    default: return f(TNormMin{});
+  }
+}
+
 class FuzzyOperator
 {
 public:
@@ -19,12 +77,7 @@ public:
     FuzzyOperatorAND() {}
     virtual ~FuzzyOperatorAND() {}
     // AND operator --> use min(x, y) unless x or y is the dontcare
-    virtual double operate(double x, double y) {
-      double res = min(x, y);
-       // DONTCARE VALUE < 0; If the min < 0 ==> x or/and y are < 0 --> return the other (the max) then
-       // if both qre < 0 --> < 0
-      return res >= 0 ? res : max(x, y); 
-    }
+    virtual double operate(double x, double y) { return TNormMin::operate(x, y); }
 };
 
 }
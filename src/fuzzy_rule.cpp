@@ -204,59 +204,188 @@ double FuzzyRule::evaluateInputConditionFireLevel(const FuzzyVariablesDB& db, co
 double FuzzyRule::evaluateInputConditionFireLevel(int idx, double value) const { 
     return evaluateInputConditionFireLevel(getDB(), getInputConditionIndex(idx), value);
 }
-// static
-double FuzzyRule::evaluateFireLevel(const FuzzyVariablesDB& db, const ConditionIndexes& cis, const vector<double>& input_vars_values)
-{
-    const int nb_input = cis.size();
-    assert(nb_input > 0);
-    assert(input_vars_values.size() == (size_t)db.getNbInputVars());
+// the evaluation kernels, specialized for each t-norm T (cf fuzzy_operator.h), so that the hot loops are inlined
+namespace {
 
-    vector<double> evals(nb_input, 0);
-    for (int i = 0; i < nb_input; i++) {
+template <typename T, typename VALUE>
+double evaluateFireLevelKernel(const FuzzyVariablesDB& db, ConditionsRange cis, VALUE value) {
+    const int nb_input = cis.size();
+    double eval = FuzzyRule::evaluateInputConditionFireLevel(db, cis[0], value(cis[0].var_idx));
+    for (int i = 1; i < nb_input; i++) {
         const auto& ci = cis[i];
-        evals[i] = evaluateInputConditionFireLevel(db, ci, input_vars_values[ci.var_idx]);
+        eval = T::operate(eval, FuzzyRule::evaluateInputConditionFireLevel(db, ci, value(ci.var_idx)));
     }
+    return eval;
+}
+
+template <typename T>
+void combineFireLevelsKernel(const vector<double>& evals, vector<double>& fire_levels) {
+    const int nb_rows = fire_levels.size();
+    double* levels = fire_levels.data();
+    const double* values = evals.data();
+    for (int row = 0; row < nb_rows; row++)
+        levels[row] = T::operate(levels[row], values[row]);
+}
+
+}
+
+// static
+double FuzzyRule::evaluateFireLevel(const FuzzyVariablesDB& db, ConditionsRange cis, const vector<double>& input_vars_values, TNorm tnorm)
+{
+    assert(cis.size() > 0);
+    assert(input_vars_values.size() == (size_t)db.getNbInputVars());
 
-    return combineFireLevels(evals);
+    // N.B: the conditions are combined on the fly, in the same order as combineFireLevels()
+    auto value = [&](int var_idx) { return input_vars_values[var_idx]; };
+    return dispatchTNorm(tnorm, [&](auto t) { 
+        return evaluateFireLevelKernel<decltype(t)>(db, cis, value); 
+    });
 }
 
 double FuzzyRule::evaluateFireLevel(const vector<double>& input_vars_values) const {
-    return evaluateFireLevel(getDB(), getInputConditionIndexes(), input_vars_values);
+    return evaluateFireLevel(getDB(), FuzzyRulesTable::asRange(getInputConditionIndexes()), input_vars_values);
 }
 
 // evaluate the firing level of a rule where the input values are stored in a row of a dataframe
 // the input variables are assumed to be in the same order as the df columns
 double FuzzyRule::evaluateFireLevel(const DataFrame& df, const int row) const {
-    return evaluateFireLevel(getDB(), getInputConditionIndexes(), df, row);
+    return evaluateFireLevel(getDB(), FuzzyRulesTable::asRange(getInputConditionIndexes()), df, row);
 }
 
 // static 
-double FuzzyRule::evaluateFireLevel(const FuzzyVariablesDB& db, const ConditionIndexes& cis,const DataFrame& df, const int row)  {
-    const int nb_input = cis.size();
-    assert(nb_input > 0);
+double FuzzyRule::evaluateFireLevel(const FuzzyVariablesDB& db, ConditionsRange cis, const DataFrame& df, const int row, TNorm tnorm)  {
+    assert(cis.size() > 0);
     assert(df.nbcols() == db.getNbInputVars());
     assert(row >= 0 && row < df.nbrows());
 
-    vector<double> evals(nb_input, 0);
-    for (int i = 0; i < nb_input; i++) {
-        const auto& ci = cis[i];
-        evals[i] = evaluateInputConditionFireLevel(db, ci, df.at(row, ci.var_idx));
-    }
-    
-    return combineFireLevels(evals);
+    // N.B: allocation-free: the conditions are combined on the fly (running AND), in the same order as combineFireLevels()
+    auto value = [&](int var_idx) { return df.at(row, var_idx); };
+    return dispatchTNorm(tnorm, [&](auto t) { 
+        return evaluateFireLevelKernel<decltype(t)>(db, cis, value); 
+    });
 }
 
-double FuzzyRule::combineFireLevels(const vector<double>& fire_levels) {
-    const int nb_input = fire_levels.size();
+void FuzzyRule::evaluateFireLevels(const DataFrame& df, vector<double>& fire_levels) const {
+    evaluateFireLevels(getDB(), FuzzyRulesTable::asRange(getInputConditionIndexes()), df, fire_levels);
+}
+
+// static
+// N.B: the conditions are combined in the same order as in combineFireLevels(), so that the
+// results are identical to the row by row evaluation
+void FuzzyRule::evaluateFireLevels(const FuzzyVariablesDB& db, ConditionsRange cis, const DataFrame& df, vector<double>& fire_levels, 
+    TNorm tnorm) 
+{
+    const int nb_input = cis.size();
     assert(nb_input > 0);
+    assert(df.nbcols() == db.getNbInputVars());
 
-    double eval = fire_levels[0];
-    if (nb_input > 1) {
-        //TODO: The operator should be provided as a param
-        FuzzyOperatorAND op;
+    // first condition: initialize the fire levels
+    db.getInputVariable(cis[0].var_idx).fuzzify(cis[0].set_idx, df[cis[0].var_idx], fire_levels);
+
+    vector<double> evals;
+    dispatchTNorm(tnorm, [&](auto t) {
         for (int i = 1; i < nb_input; i++) {
-            eval = op.operate(eval, fire_levels[i]);
+            const auto& ci = cis[i];
+            db.getInputVariable(ci.var_idx).fuzzify(ci.set_idx, df[ci.var_idx], evals);
+            combineFireLevelsKernel<decltype(t)>(evals, fire_levels);
         }
-    }
-    return eval;
-}
\ No newline at end of file
+    });
+}
+
+void FuzzyRule::evaluateFireLevels(FuzzificationCache& cache, vector<double>& fire_levels) const {
+    evaluateFireLevels(getDB(), FuzzyRulesTable::asRange(getInputConditionIndexes()), cache, fire_levels);
+}
+
+// static
+// N.B: same as above, but the input conditions fire levels are fetched from the cache
+void FuzzyRule::evaluateFireLevels(const FuzzyVariablesDB& db, ConditionsRange cis, FuzzificationCache& cache, vector<double>& fire_levels, 
+    TNorm tnorm) 
+{
+    const int nb_input = cis.size();
+    assert(nb_input > 0);
+
+    fire_levels = cache.fetch(db, cis[0].var_idx, cis[0].set_idx);
+
+    dispatchTNorm(tnorm, [&](auto t) {
+        for (int i = 1; i < nb_input; i++)
+            combineFireLevelsKernel<decltype(t)>(cache.fetch(db, cis[i].var_idx, cis[i].set_idx), fire_levels);
+    });
+}
+
+double FuzzyRule::combineFireLevels(const vector<double>& fire_levels, TNorm tnorm) {
+    const int nb_input = fire_levels.size();
+    assert(nb_input > 0);
+
+    return dispatchTNorm(tnorm, [&](auto t) {
+        double eval = fire_levels[0];
+        for (int i = 1; i < nb_input; i++)
+            eval = decltype(t)::operate(eval, fire_levels[i]);
+        return eval;
+    });
+}
+
+void FuzzyRulesTable::clear() {
+  // N.B: keeps the capacity
+  _in_conds.clear();
+  _out_conds.clear();
+  _in_offsets.assign(1, 0);
+  _out_offsets.assign(1, 0);
+}
+
+void FuzzyRulesTable::reserve(int nb_rules) {
+  _in_offsets.reserve(nb_rules + 1);
+  _out_offsets.reserve(nb_rules + 1);
+}
+
+void FuzzyRulesTable::addRule(ConditionsRange input_conds, ConditionsRange output_conds) {
+  _in_conds.insert(_in_conds.end(), input_conds.begin(), input_conds.end());
+  _in_offsets.push_back(_in_conds.size());
+  _out_conds.insert(_out_conds.end(), output_conds.begin(), output_conds.end());
+  _out_offsets.push_back(_out_conds.size());
+}
+
+// N.B: same logic as FuzzyRule::filterConditionIndexes(), but checks the variables already used
+// among the conditions appended for this rule, to avoid allocating
+int FuzzyRulesTable::appendFiltered(const ConditionIndexes& cis, int nb_vars, int nb_sets, ConditionIndexes& conds) {
+  const int start = conds.size();
+  for (const auto& ci : cis) {
+    if (ci.var_idx < 0 || ci.var_idx >= nb_vars || ci.set_idx < 0 || ci.set_idx >= nb_sets) continue;
+    const int nb = conds.size();
+    bool used = false;
+    for (int i = start; i < nb && !used; i++)
+      used = conds[i].var_idx == ci.var_idx;
+    if (!used) conds.push_back(ci);
+  }
+  return int(conds.size()) - start;
+}
+
+bool FuzzyRulesTable::addFilteredRule(const ConditionIndexes& input_conds, int nb_input_vars, int nb_input_sets, 
+    const ConditionIndexes& output_conds, int nb_output_vars, int nb_output_sets) 
+{
+  const int nb_in = _in_conds.size();
+  const int nb_out = _out_conds.size();
+  if (appendFiltered(input_conds, nb_input_vars, nb_input_sets, _in_conds) > 0 && 
+      appendFiltered(output_conds, nb_output_vars, nb_output_sets, _out_conds) > 0) {
+    _in_offsets.push_back(_in_conds.size());
+    _out_offsets.push_back(_out_conds.size());
+    return true;
+  }
+  // rollback
+  _in_conds.resize(nb_in);
+  _out_conds.resize(nb_out);
+  return false;
+}
+
+void FuzzyRulesTable::replace(ConditionIndexes& conds, vector<int>& offsets, int rule_idx, const ConditionIndexes& cis) {
+  const int first = offsets[rule_idx], last = offsets[rule_idx + 1];
+  conds.erase(conds.begin() + first, conds.begin() + last);
+  conds.insert(conds.begin() + first, cis.begin(), cis.end());
+  const int delta = int(cis.size()) - (last - first);
+  for (size_t i = rule_idx + 1; i < offsets.size(); i++) offsets[i] += delta;
+}
+
+void FuzzyRulesTable::setRule(int rule_idx, const ConditionIndexes& input_conds, const ConditionIndexes& output_conds) {
+  assert(rule_idx >= 0 && rule_idx < getNbRules());
+  replace(_in_conds, _in_offsets, rule_idx, input_conds);
+  replace(_out_conds, _out_offsets, rule_idx, output_conds);
+}
@@ -18,7 +18,9 @@
 #include <cassert>
 
 #include "fuzzy_variables_db.h"
+#include "fuzzy_operator.h"
 #include "dataframe.h"
+#include "fuzzification_cache.h"
 #include "named_list.h"
 
 namespace fuzzy_coco {
@@ -44,6 +46,63 @@ inline bool operator==(const ConditionIndex& a, const ConditionIndex& b) {
 
 
 using ConditionIndexes = vector<ConditionIndex>;
+
+// a contiguous range of conditions, cf FuzzyRulesTable
+struct ConditionsRange {
+  const ConditionIndex* first;
+  const ConditionIndex* last;
+
+  const ConditionIndex* begin() const { return first; }
+  const ConditionIndex* end() const { return last; }
+  int size() const { return last - first; }
+  bool empty() const { return first == last; }
+  const ConditionIndex& operator[](int i) const { return first[i]; }
+  ConditionIndexes toConditionIndexes() const { return ConditionIndexes(first, last); }
+};
+
+// a compact table of rules conditions, stored CSR-style: the input conditions of all rules are contiguous, 
+// the input conditions of rule i being in [_in_offsets[i], _in_offsets[i + 1][. Same for the output conditions.
+// N.B: the table is rebuilt in place, so does not allocate once its buffers are large enough
+class FuzzyRulesTable {
+public:
+  FuzzyRulesTable() { clear(); }
+
+  int getNbRules() const { return int(_in_offsets.size()) - 1; }
+  ConditionsRange getInputConditions(int rule_idx) const { return range(_in_conds, _in_offsets, rule_idx); }
+  ConditionsRange getOutputConditions(int rule_idx) const { return range(_out_conds, _out_offsets, rule_idx); }
+  // the total number of input conditions
+  int getNbInputConditions() const { return _in_conds.size(); }
+
+  void clear();
+  void reserve(int nb_rules);
+  void addRule(ConditionsRange input_conds, ConditionsRange output_conds);
+  void addRule(const ConditionIndexes& input_conds, const ConditionIndexes& output_conds) {
+    addRule(asRange(input_conds), asRange(output_conds));
+  }
+  // filter the conditions as FuzzyRule::filterConditionIndexes() would do, and only add the rule if it 
+  // has both input and output conditions. Returns whether the rule was added
+  bool addFilteredRule(const ConditionIndexes& input_conds, int nb_input_vars, int nb_input_sets, 
+    const ConditionIndexes& output_conds, int nb_output_vars, int nb_output_sets);
+  // replace the conditions of rule #rule_idx
+  void setRule(int rule_idx, const ConditionIndexes& input_conds, const ConditionIndexes& output_conds);
+
+  static ConditionsRange asRange(const ConditionIndexes& cis) { return {cis.data(), cis.data() + cis.size()}; }
+
+private:
+  static ConditionsRange range(const ConditionIndexes& conds, const vector<int>& offsets, int rule_idx) {
+    assert(rule_idx >= 0 && rule_idx + 1 < int(offsets.size()));
+    return {conds.data() + offsets[rule_idx], conds.data() + offsets[rule_idx + 1]};
+  }
+  // append the good conditions, returns their number
+  static int appendFiltered(const ConditionIndexes& cis, int nb_vars, int nb_sets, ConditionIndexes& conds);
+  static void replace(ConditionIndexes& conds, vector<int>& offsets, int rule_idx, const ConditionIndexes& cis);
+
+private:
+  ConditionIndexes _in_conds;
+  vector<int> _in_offsets;
+  ConditionIndexes _out_conds;
+  vector<int> _out_offsets;
+};
 using FuzzyVariables = vector<FuzzyVariable>;
 // using FuzzyInputVariables = vector<const FuzzyInputVariable*>;
 // using FuzzyOutputVariables = vector<const FuzzyOutputVariable*>;
@@ -97,6 +156,11 @@ public:
 
 
     double evaluateFireLevel(const DataFrame& df, const int row) const;
+    // evaluate the fire levels for all the rows of the dataframe, one input condition (i.e. column) at a time
+    // N.B: gives exactly the same values as evaluateFireLevel(df, row) for each row
+    void evaluateFireLevels(const DataFrame& df, vector<double>& fire_levels) const;
+    // same but uses (and fills) the cache of fuzzified input values
+    void evaluateFireLevels(FuzzificationCache& cache, vector<double>& fire_levels) const;
 
     // evaluate one input condition. N.B: if the value is missing, the fire level is 0
     // N.B: use is_na() to detect missing data
@@ -128,11 +192,19 @@ public:
   }
 
   static double evaluateInputConditionFireLevel(const FuzzyVariablesDB& db, const ConditionIndex& ci, double value);
-  static double evaluateFireLevel(const FuzzyVariablesDB& db, const ConditionIndexes& cis, const vector<double>& input_vars_values);
-  static double evaluateFireLevel(const FuzzyVariablesDB& db, const ConditionIndexes& cis, const DataFrame& df, const int row);
+  // N.B: the input conditions are combined using the tnorm t-norm. The dispatch is done once per call, 
+  // the evaluation kernels being specialized for each t-norm
+  static double evaluateFireLevel(const FuzzyVariablesDB& db, ConditionsRange cis, const vector<double>& input_vars_values, 
+    TNorm tnorm = TNorm::MIN);
+  static double evaluateFireLevel(const FuzzyVariablesDB& db, ConditionsRange cis, const DataFrame& df, const int row, 
+    TNorm tnorm = TNorm::MIN);
+  static void evaluateFireLevels(const FuzzyVariablesDB& db, ConditionsRange cis, const DataFrame& df, vector<double>& fire_levels, 
+    TNorm tnorm = TNorm::MIN);
+  static void evaluateFireLevels(const FuzzyVariablesDB& db, ConditionsRange cis, FuzzificationCache& cache, vector<double>& fire_levels, 
+    TNorm tnorm = TNorm::MIN);
   
   // combine the fire levels of each input condition into the final rule fire level
-  static double combineFireLevels(const vector<double>& fire_levels);
+  static double combineFireLevels(const vector<double>& fire_levels, TNorm tnorm = TNorm::MIN);
 
   // could/should go elsewhere ?
   // filter out the "wrong" pairs, which indices are out of range (the pairs usually come from the genetic algorithm)
@@ -1,6 +1,7 @@
 #include "fuzzy_system.h"
 #include <unordered_map>
 #include "logging_logger.h"
+#include "profiler.h"
 
 using namespace fuzzy_coco;
 using namespace logging;
@@ -19,6 +20,9 @@ FuzzySystem FuzzySystem::load(const NamedList& desc) {
   auto set_idxs = FuzzyDefaultRule::convert_default_rules_to_set_idx(default_rules);
   fs.setDefaultRulesConditions(set_idxs);
 
+  // N.B: optional, for the compatibility with the systems saved before the t-norms were introduced
+  if (desc.has("t_norm")) fs.setTNorm(parseTNorm(desc.get_string("t_norm")));
+
   return fs;
 }
 
@@ -62,12 +66,38 @@ void FuzzySystem::setDefaultRulesConditions(const vector<int>& out_sets) {
 }
 
 void FuzzySystem::resetRules(int reserve) {
-  _rules.clear();
+  _rules_table.clear();
   if (reserve > 0) {
-    _rules.reserve(reserve);
+    _rules_table.reserve(reserve);
   }
 }
 
+FuzzyRule FuzzySystem::getRule(int i) const {
+  return FuzzyRule(getDB(), 
+    _rules_table.getInputConditions(i).toConditionIndexes(), 
+    _rules_table.getOutputConditions(i).toConditionIndexes());
+}
+
+vector<FuzzyRule> FuzzySystem::getRules() const {
+  const int nb_rules = getNbRules();
+  vector<FuzzyRule> rules;
+  rules.reserve(nb_rules);
+  for (int i = 0; i < nb_rules; i++)
+    rules.push_back(getRule(i));
+  return rules;
+}
+
+bool FuzzySystem::addFilteredRule(const ConditionIndexes& input_conds, const ConditionIndexes& output_conds) {
+  const auto& db = getDB();
+  return _rules_table.addFilteredRule(
+    input_conds, db.getNbInputVars(), db.getNbInputSets(), 
+    output_conds, db.getNbOutputVars(), db.getNbOutputSets());
+}
+
+void FuzzySystem::setRule(int i, const FuzzyRule& rule) {
+  _rules_table.setRule(i, rule.getInputConditionIndexes(), rule.getOutputConditionIndexes());
+}
+
 void FuzzySystem::setDefaultRules(const vector<FuzzyDefaultRule>& rules)
 {
   auto set_idxs = FuzzyDefaultRule::convert_default_rules_to_set_idx(rules);
@@ -115,11 +145,7 @@ void FuzzySystem::setRules(const vector<FuzzyRule>& rules)
 // }
 
 int FuzzySystem::computeTotalInputVarsUsedInRules() const {
-  int total = 0;
-  for (int i = 0; i < getNbRules(); i++) {
-    total += getRule(i).getNbInputConditions();
-  }
-  return total;
+  return _rules_table.getNbInputConditions();
 }
 
 int FuzzySystem::fetchInputVariablesUsage(vector<bool>& used) const
@@ -129,7 +155,7 @@ int FuzzySystem::fetchInputVariablesUsage(vector<bool>& used) const
   used.resize(nb, false);
   int nb_used = 0;
   for (int i = 0; i < getNbRules(); i++) {
-    for (const auto& ci: getRule(i).getInputConditionIndexes()) {
+    for (const auto& ci: _rules_table.getInputConditions(i)) {
       used[ci.var_idx] = true;
       nb_used++;
     }
@@ -158,7 +184,7 @@ vector<int> FuzzySystem::getUsedOutputVariables() const
   vector<bool> used(nb, false);
 
   for (int i = 0; i < getNbRules(); i++) 
-    for (const auto& co: getRule(i).getOutputConditionIndexes()) 
+    for (const auto& co: _rules_table.getOutputConditions(i)) 
       used[co.var_idx] = true;
   
   vector<int> res;
@@ -184,7 +210,7 @@ NamedList FuzzySystem::describe() const {
   // desc.add("parameters", params);
 
   desc.add("variables", getDB().describe());
-  desc.add("rules", FuzzyRule::describeRules(_rules));
+  desc.add("rules", FuzzyRule::describeRules(getRules()));
 
   // NamedList default_rules;
   // const auto& defs = getDefaultRulesOutputSets();
@@ -195,6 +221,8 @@ NamedList FuzzySystem::describe() const {
   //     default_rules.add(rule_desc.name(), rule_desc);
   // }
   desc.add("default_rules", FuzzyDefaultRule::describeDefaultRules(fetchDefaultRules()));
+  // N.B: only for a non-default t-norm, so that the descriptions of the min-based systems are unchanged
+  if (getTNorm() != TNorm::MIN) desc.add("t_norm", toString(getTNorm()));
     
   return desc;
 }
@@ -258,7 +286,7 @@ void FuzzySystem::computeRulesImplications(const vector<double>& rule_fire_level
     // if the firelevel is missing the rule does not fire, thus it is ignored
     if (is_na(fire_level)) continue;
 
-    for (const auto& ci : getRule(rule_idx).getOutputConditionIndexes()) 
+    for (const auto& ci : _rules_table.getOutputConditions(rule_idx)) 
       results[ci.var_idx][ci.set_idx] += fire_level;
           
   }
@@ -294,7 +322,7 @@ void FuzzySystem::computeRulesFireLevels(int sample_idx, const DataFrame& df, ve
   fire_levels.reserve(nb_rules);
 
   for (int rule_idx = 0; rule_idx < nb_rules; rule_idx++) 
-    fire_levels.push_back( getRule(rule_idx).evaluateFireLevel(df, sample_idx) );
+    fire_levels.push_back( FuzzyRule::evaluateFireLevel(getDB(), _rules_table.getInputConditions(rule_idx), df, sample_idx, getTNorm()) );
   
 }
 // N.B: mostly for testing and convenience purposes
@@ -302,7 +330,7 @@ vector<double> FuzzySystem::computeRulesFireLevels(const vector<double>& input_v
   vector<double> fire_levels;
   fire_levels.reserve(getNbRules());
   for (int rule_idx = 0; rule_idx < getNbRules(); rule_idx++) {
-    fire_levels.push_back( getRule(rule_idx).evaluateFireLevel(input_values) );
+    fire_levels.push_back( FuzzyRule::evaluateFireLevel(getDB(), _rules_table.getInputConditions(rule_idx), input_values, getTNorm()) );
   }
   return fire_levels;
 }//KCOV IGNORE
@@ -320,8 +348,7 @@ void FuzzySystem::computeOutputVarsMaxFireLevels(const vector<double>& rules_fir
 
   for (size_t rule_idx = 0; rule_idx < nb_rules; rule_idx++) {
     const double fire_level = rules_fire_levels[rule_idx];
-    const auto& rule = getRule(rule_idx);
-    for (const auto& co : rule.getOutputConditionIndexes()) {
+    for (const auto& co : _rules_table.getOutputConditions(rule_idx)) {
       outvars_max_fire_levels[co.var_idx] = max(outvars_max_fire_levels[co.var_idx], fire_level);
     }
   }
@@ -329,21 +356,12 @@ void FuzzySystem::computeOutputVarsMaxFireLevels(const vector<double>& rules_fir
 // defuzzify the output variables
 void FuzzySystem::defuzzify(const Matrix<double>& results, vector<double>& defuzz_values) const {
     const size_t nb_out_vars = getDB().getNbOutputVars();
-    const size_t nb_sets = getDB().getNbOutputSets();
     assert(results.size() == nb_out_vars && results[0].size() == (size_t)getDB().getNbOutputSets());
     
-    vector<double> set_evals(nb_sets, 0);
-    defuzz_values.clear();
-
-    for (size_t var_idx = 0; var_idx < nb_out_vars; var_idx++) {
-        const auto& results_for_var = results[var_idx];
-        // gather values for this output variable sets
-        set_evals.clear();
-        for (size_t set_idx = 0; set_idx < nb_sets; set_idx++) {
-            set_evals.push_back(results_for_var[set_idx]);
-        }
-        defuzz_values.push_back(getDB().getOutputVariable(var_idx).defuzz(set_evals));
-    }
+    defuzz_values.resize(nb_out_vars);
+    // N.B: results[var_idx] already holds the evaluations of the output variable sets, no need to copy them
+    for (size_t var_idx = 0; var_idx < nb_out_vars; var_idx++)
+        defuzz_values[var_idx] = getDB().getOutputVariable(var_idx).defuzz(results[var_idx]);
 }
 
 
@@ -364,12 +382,24 @@ void FuzzySystem::defuzzify(const Matrix<double>& results, vector<double>& defuz
 // }
 
 // evaluate the fuzzy system on data: and output the defuzzed values in predicted
+// N.B: all the samples are processed at once (cf the *Batch() methods), column by column.
+// The results are identical to calling predictSample() on each sample
 DataFrame FuzzySystem::predict(const DataFrame& input)
 {
-    const int nb_samples = input.nbrows();
+    computeRulesFireLevelsBatch(input, getState().rules_fire_levels);
+    return predictFromRulesFireLevels(input.nbrows());
+}
+
+DataFrame FuzzySystem::predict(FuzzificationCache& cache)
+{
+    computeRulesFireLevelsBatch(cache, getState().rules_fire_levels);
+    return predictFromRulesFireLevels(cache.getData().nbrows());
+}
+
+DataFrame FuzzySystem::predictFromRulesFireLevels(int nb_samples)
+{
     const int nb_out_vars = getDB().getNbOutputVars();
     DataFrame res(nb_samples, nb_out_vars);
-    vector<double> defuzzed(res.nbcols());
     
     vector<string> output_names;
     output_names.reserve(nb_out_vars);
@@ -377,14 +407,31 @@ DataFrame FuzzySystem::predict(const DataFrame& input)
         output_names.push_back(getDB().getOutputVariable(i).getName());
     res.colnames(output_names);
 
-    for (int i = 0; i < nb_samples; i++) {
-        predictSample(i, input, defuzzed);
-        res.fillRow(i, defuzzed);
-    }
+    if (nb_samples == 0) return res;
+
+    computeOutputSetsResultsBatch(nb_samples);
+    defuzzifyBatch(getState().batch_output_sets_results, res);
 
     return res;
 }
 
+void FuzzySystem::computeOutputSetsResultsBatch(int nb_samples)
+{
+  PROFILE_PHASE(IMPLICATION);
+    auto& state = getState();
+    computeRulesImplicationsBatch(state.rules_fire_levels, nb_samples, state.batch_output_sets_results);
+    computeOutputVarsMaxFireLevelsBatch(state.rules_fire_levels, nb_samples, state.batch_output_vars_max_fire_levels);
+    addDefaultRulesImplicationsBatch(getDefaultRulesOutputSets(), state.batch_output_vars_max_fire_levels, state.batch_output_sets_results);
+}
+
+int FuzzySystem::computeOutputSetsResultsBatch(FuzzificationCache& cache)
+{
+    const int nb_samples = cache.getData().nbrows();
+    computeRulesFireLevelsBatch(cache, getState().rules_fire_levels);
+    if (nb_samples > 0) computeOutputSetsResultsBatch(nb_samples);
+    return nb_samples;
+}
+
 // same as predict, but is smart on the input data frame:  will use the column names
 // to match the values on the corresponding variables
 DataFrame FuzzySystem::smartPredict(const DataFrame& df)
@@ -399,12 +446,13 @@ DataFrame FuzzySystem::smartPredict(const DataFrame& df)
 }
 
 // evaluate the fuzzy system on data for a sample: and output the defuzzed value by output var in defuzzed
+// N.B: does not allocate once the state buffers (and defuzzed) have been sized by a first call
 void FuzzySystem::predictSample(int sample_idx, const DataFrame& dfin, vector<double>& defuzzed)
 {
     assert(sample_idx >= 0);
 
     // rules processing
-    vector<double> fire_levels; // TODO: put in state for reuse ?
+    auto& fire_levels = getState().fire_levels;
     computeRulesFireLevels(sample_idx, dfin, fire_levels);
     computeRulesImplications(fire_levels, getState().output_sets_results);
 
@@ -417,3 +465,122 @@ void FuzzySystem::predictSample(int sample_idx, const DataFrame& dfin, vector<do
 
 }
 
+
+void FuzzySystem::computeRulesFireLevelsBatch(const DataFrame& df, Matrix<double>& rules_fire_levels) const {
+  PROFILE_PHASE(FIRE_LEVELS);
+  assert(df.nbcols() == getDB().getNbInputVars());
+  const int nb_rules = getNbRules();
+  rules_fire_levels.resize(nb_rules);
+  for (int rule_idx = 0; rule_idx < nb_rules; rule_idx++) 
+    FuzzyRule::evaluateFireLevels(getDB(), _rules_table.getInputConditions(rule_idx), df, rules_fire_levels[rule_idx], getTNorm());
+}
+
+void FuzzySystem::computeRulesFireLevelsBatch(FuzzificationCache& cache, Matrix<double>& rules_fire_levels) const {
+  PROFILE_PHASE(FIRE_LEVELS);
+  const int nb_rules = getNbRules();
+  rules_fire_levels.resize(nb_rules);
+  for (int rule_idx = 0; rule_idx < nb_rules; rule_idx++) 
+    FuzzyRule::evaluateFireLevels(getDB(), _rules_table.getInputConditions(rule_idx), cache, rules_fire_levels[rule_idx], getTNorm());
+}
+
+void FuzzySystem::computeRulesImplicationsBatch(const Matrix<double>& rules_fire_levels, int nb_samples, Matrix<double>& results) const {
+  const int nb_rules = getNbRules();
+  const int nb_sets = getDB().getNbOutputSets();
+  assert(rules_fire_levels.size() == (size_t)nb_rules);
+
+  results.redim(getDB().getNbOutputVars() * nb_sets, nb_samples);
+  results.reset(); // important since we add the levels
+
+  for (int rule_idx = 0; rule_idx < nb_rules; rule_idx++) {
+    const auto& fire_levels = rules_fire_levels[rule_idx];
+    for (const auto& ci : _rules_table.getOutputConditions(rule_idx)) {
+      auto& set_results = results[ci.var_idx * nb_sets + ci.set_idx];
+      for (int i = 0; i < nb_samples; i++) {
+        const double fire_level = fire_levels[i];
+        // if the firelevel is missing the rule does not fire, thus it is ignored
+        if (!is_na(fire_level)) set_results[i] += fire_level;
+      }
+    }
+  }
+}
+
+void FuzzySystem::computeOutputVarsMaxFireLevelsBatch(const Matrix<double>& rules_fire_levels, int nb_samples, Matrix<double>& outvars_max_fire_levels) const {
+  const int nb_rules = getNbRules();
+  assert(rules_fire_levels.size() == (size_t)nb_rules);
+
+  outvars_max_fire_levels.redim(getDB().getNbOutputVars(), nb_samples);
+  for (auto& row : outvars_max_fire_levels) 
+    row.assign(nb_samples, MISSING_DATA_DOUBLE);
+
+  for (int rule_idx = 0; rule_idx < nb_rules; rule_idx++) {
+    const auto& fire_levels = rules_fire_levels[rule_idx];
+    for (const auto& co : _rules_table.getOutputConditions(rule_idx)) {
+      auto& max_levels = outvars_max_fire_levels[co.var_idx];
+      for (int i = 0; i < nb_samples; i++)
+        max_levels[i] = max(max_levels[i], fire_levels[i]);
+    }
+  }
+}
+
+void FuzzySystem::addDefaultRulesImplicationsBatch(const vector<int>& default_rules_set_idx, const Matrix<double>& outvars_max_fire_levels, Matrix<double>& results) const {
+  const int nb_out_vars = getDB().getNbOutputVars();
+  const int nb_sets = getDB().getNbOutputSets();
+  assert(default_rules_set_idx.size() == (size_t)nb_out_vars);
+  assert(outvars_max_fire_levels.size() == (size_t)nb_out_vars);
+  assert(results.size() == (size_t)(nb_out_vars * nb_sets));
+
+  for (int var_idx = 0; var_idx < nb_out_vars; var_idx++) {
+    const auto& max_levels = outvars_max_fire_levels[var_idx];
+    auto& set_results = results[var_idx * nb_sets + default_rules_set_idx[var_idx]];
+    const int nb_samples = max_levels.size();
+    for (int i = 0; i < nb_samples; i++) {
+      const double max_fire_level = max_levels[i];
+      // N.B: only use the value if it is not missing.
+      if (!is_na(max_fire_level)) set_results[i] += 1 - max_fire_level;
+    }
+  }
+}
+
+// N.B: same algorithm as FuzzyVariable::defuzz(), vectorized on the samples
+void FuzzySystem::computeDefuzzSumsBatch(const Matrix<double>& results, int var_idx, int nb_samples) {
+  const int nb_sets = getDB().getNbOutputSets();
+  assert(results.size() == (size_t)(getDB().getNbOutputVars() * nb_sets));
+
+  auto& state = getState();
+  auto& eval_sums = state.batch_eval_sums;
+  auto& eval_products = state.batch_eval_products;
+  auto& nb_non_missing = state.batch_nb_non_missing;
+  eval_sums.assign(nb_samples, 0.0);
+  eval_products.assign(nb_samples, 0.0);
+  nb_non_missing.assign(nb_samples, 0);
+
+  const auto& var = getDB().getOutputVariable(var_idx);
+  for (int set_idx = 0; set_idx < nb_sets; set_idx++) {
+    const double pos = var.getSet(set_idx).getPosition();
+    // a set with a missing position is ignored
+    if (is_na(pos)) continue;
+    const auto& set_evals = results[var_idx * nb_sets + set_idx];
+    for (int i = 0; i < nb_samples; i++) {
+      const double eval = set_evals[i];
+      if (!is_na(eval)) {
+        nb_non_missing[i]++;
+        eval_sums[i] += eval;
+        eval_products[i] += (eval * pos);
+      }
+    }
+  }
+}
+
+void FuzzySystem::defuzzifyBatch(const Matrix<double>& results, DataFrame& defuzz_values) {
+  PROFILE_PHASE(DEFUZZIFICATION);
+  const int nb_out_vars = getDB().getNbOutputVars();
+  const int nb_samples = defuzz_values.nbrows();
+  assert(defuzz_values.nbcols() == nb_out_vars);
+
+  auto& defuzzed = getState().batch_defuzz_values;
+  defuzzed.resize(nb_samples);
+  for (int var_idx = 0; var_idx < nb_out_vars; var_idx++) {
+    defuzzifyVariableBatch(results, var_idx, nb_samples, [&](int i, double value) { defuzzed[i] = value; });
+    defuzz_values.fillCol(var_idx, defuzzed);
+  }
+}
@@ -57,6 +57,28 @@ struct FuzzySystemEvaluationState {
     // output vars max fire levels: for each output var, record its max fire level
     vector<double> output_vars_max_fire_levels;
     vector<double> defuzz_values;
+
+    // =========== sample evaluation related, cf predictSample() =================
+    // N.B: a buffer, reused across calls to avoid per-sample allocations
+
+    // r[i] is the fire level of rule i for the current sample
+    vector<double> fire_levels;
+
+    // =========== batch evaluation related, cf predict() =================
+    // N.B: these are only buffers, reused across calls to avoid reallocations
+
+    // r[i][k] is the fire level of rule i for sample k
+    Matrix<double> rules_fire_levels;
+    // r[i * nb_output_sets + j][k] is the value for output var i, its output set j and sample k
+    Matrix<double> batch_output_sets_results;
+    // r[i][k] is the max fire level of output var i for sample k
+    Matrix<double> batch_output_vars_max_fire_levels;
+    // r[k] is the defuzzed value of sample k for the current output var
+    vector<double> batch_defuzz_values;
+    // defuzzifyBatch() accumulators, for the current output var
+    vector<double> batch_eval_sums;
+    vector<double> batch_eval_products;
+    vector<int> batch_nb_non_missing;
 };
 
 class FuzzySystem 
@@ -66,7 +88,10 @@ public:
     FuzzySystem(const vector<string>& input_var_names, const vector<string>& output_var_names,
         int nb_input_sets, int nb_output_sets);
     FuzzySystem(const FuzzyVariablesDB& db);
-    FuzzySystem(const FuzzySystem& fs) = default;
+    // N.B: the FuzzyRule objects reference the DB, so they are not copied but materialized again when needed
+    FuzzySystem(const FuzzySystem& fs) 
+      : _vars_db(fs._vars_db), _rules_table(fs._rules_table), 
+        _default_rules_out_sets(fs._default_rules_out_sets), _tnorm(fs._tnorm), _state(fs._state) {}
 
     ~FuzzySystem() {}
 
@@ -79,16 +104,22 @@ public:
     const FuzzyVariablesDB& getDB() const { return _vars_db; }
     FuzzyVariablesDB& getDB() { return _vars_db; }
 
-    int getNbRules() const { return _rules.size(); }
-    // const FuzzyRule& getRule(int idx) const { return _rules[idx]; }
+    int getNbRules() const { return _rules_table.getNbRules(); }
     const vector<int>& getDefaultRulesOutputSets() const { return _default_rules_out_sets; }
 
     // N.B: need to build them from getDefaultRulesOutputSets()
     vector<FuzzyDefaultRule> fetchDefaultRules() const;
 
-    const vector<FuzzyRule>& getRules() const { return _rules; }
-    const FuzzyRule& getRule(int i) const { return _rules[i]; }
-    FuzzyRule& getRule(int i) { return _rules[i]; }
+    // the t-norm used to combine the rules input conditions
+    TNorm getTNorm() const { return _tnorm; }
+    void setTNorm(TNorm tnorm) { _tnorm = tnorm; }
+
+    // the rules are stored in a FuzzyRulesTable, used for the evaluation
+    const FuzzyRulesTable& getRulesTable() const { return _rules_table; }
+    // N.B: the FuzzyRule objects are built from the table on each call (e.g. for describe()), and are not
+    // stored, so that a const FuzzySystem can be shared by several threads (cf PredictionServer)
+    vector<FuzzyRule> getRules() const;
+    FuzzyRule getRule(int i) const;
 
     // vector<ConditionIndexes> getInputRulesConditions() const { return _input_rules_idx; }
     // vector<ConditionIndexes> getOutputRulesConditions() const { return _output_rules_idx; }
@@ -101,8 +132,16 @@ public:
 
     // ================== main setters ====================
     void resetRules(int reserve = 0);
-    void addRule(FuzzyRule&& rule) { _rules.push_back(rule); }
-    void addRule(const FuzzyRule& rule) { _rules.push_back(rule); }
+    void addRule(const FuzzyRule& rule) { 
+      _rules_table.addRule(rule.getInputConditionIndexes(), rule.getOutputConditionIndexes()); 
+    }
+    void addRule(ConditionsRange input_conds, ConditionsRange output_conds) {
+      _rules_table.addRule(input_conds, output_conds);
+    }
+    // filter the conditions, and add the rule only if it has both input and output conditions
+    // cf FuzzyRulesTable::addFilteredRule(). N.B: does not allocate once the table is large enough
+    bool addFilteredRule(const ConditionIndexes& input_conds, const ConditionIndexes& output_conds);
+    void setRule(int i, const FuzzyRule& rule);
     void setRules(const vector<FuzzyRule>& rules);
 
     void setDefaultRules(const vector<FuzzyDefaultRule>& rules);
@@ -115,6 +154,9 @@ public:
     // ================== main methods ====================
 
     DataFrame predict(const DataFrame& input);
+    // same as predict() on the cache data, but reuses (and lazily fills) the cached fuzzified input values
+    // N.B: the cache must be up-to-date with the current set positions
+    DataFrame predict(FuzzificationCache& cache);
     DataFrame smartPredict(const DataFrame& input);
     void predictSample(int sample_idx, const DataFrame& dfin, vector<double>& defuzzed);
 
@@ -156,17 +198,63 @@ public:
  
     void computeOutputVarsMaxFireLevels(const vector<double>& rules_fire_levels, vector<double>& outvars_max_fire_levels) const;
     void defuzzify(const Matrix<double>& results, vector<double>& defuzz_values) const;
-   
+
+    // ========== batch computations related to predict()
+    // these are the column-wise equivalents of the above methods: they process all the samples at once,
+    // one rule (or output var) at a time. They give exactly the same results as the per-sample methods.
+
+    // r[rule_idx][sample_idx]
+    void computeRulesFireLevelsBatch(const DataFrame& df, Matrix<double>& rules_fire_levels) const;
+    void computeRulesFireLevelsBatch(FuzzificationCache& cache, Matrix<double>& rules_fire_levels) const;
+    // r[var_idx * nb_output_sets + set_idx][sample_idx]. N.B: results is reset
+    void computeRulesImplicationsBatch(const Matrix<double>& rules_fire_levels, int nb_samples, Matrix<double>& results) const;
+    // r[var_idx][sample_idx]
+    void computeOutputVarsMaxFireLevelsBatch(const Matrix<double>& rules_fire_levels, int nb_samples, Matrix<double>& outvars_max_fire_levels) const;
+    void addDefaultRulesImplicationsBatch(const vector<int>& default_rules_set_idx, const Matrix<double>& outvars_max_fire_levels, Matrix<double>& results) const;
+    // N.B: fill the columns of defuzz_values, that must already be of the right dimensions
+    void defuzzifyBatch(const Matrix<double>& results, DataFrame& defuzz_values);
+    // defuzzify the output var var_idx, calling f(sample_idx, defuzzed_value) as the values are produced
+    // N.B: does not allocate once the state buffers are large enough
+    template <typename F>
+    void defuzzifyVariableBatch(const Matrix<double>& results, int var_idx, int nb_samples, F&& f);
+    // the rest of predict(), once the rules fire levels have been computed in the state
+    DataFrame predictFromRulesFireLevels(int nb_samples);
+    // the inference part of predict(), once the rules fire levels have been computed in the state: 
+    // fills getState().batch_output_sets_results, to be defuzzified
+    void computeOutputSetsResultsBatch(int nb_samples);
+    // same on the cache data, returns the number of samples.
+    // N.B: used for the fused prediction and scoring, cf FuzzyCocoFitnessMethod::fitMetrics()
+    int computeOutputSetsResultsBatch(FuzzificationCache& cache);
+
+private:
+    // compute the batch_eval_sums/products and batch_nb_non_missing state buffers for output var var_idx
+    void computeDefuzzSumsBatch(const Matrix<double>& results, int var_idx, int nb_samples);
+
 private:
     FuzzyVariablesDB _vars_db;
     
     // variables to be set after the construction
-    vector<FuzzyRule> _rules;
+    FuzzyRulesTable _rules_table;
     vector<int> _default_rules_out_sets; // store the default rules output sets for each output var
+    TNorm _tnorm = TNorm::MIN;
 
     // variable state
     FuzzySystemEvaluationState _state;
 };
 
+template <typename F>
+void FuzzySystem::defuzzifyVariableBatch(const Matrix<double>& results, int var_idx, int nb_samples, F&& f) {
+  computeDefuzzSumsBatch(results, var_idx, nb_samples);
+  const auto& state = getState();
+  const double* eval_sums = state.batch_eval_sums.data();
+  const double* eval_products = state.batch_eval_products.data();
+  const int* nb_non_missing = state.batch_nb_non_missing.data();
+  for (int i = 0; i < nb_samples; i++) {
+    // all sets ignored --> NA
+    if (nb_non_missing[i] == 0) f(i, MISSING_DATA_DOUBLE);
+    else f(i, (eval_sums[i] == 0.0) ? 0.0 : eval_products[i] / eval_sums[i]);
+  }
+}
+
 }
 #endif // FUZZYSYSTEM_H
@@ -42,63 +42,60 @@ FuzzySystemMetrics FuzzySystemMetricsComputer::computeForOneValue(double predict
   return metrics;
 }
 
+FuzzySystemMetrics FuzzySystemMetricsComputer::VariableAccumulator::metrics() const
+{
+  FuzzySystemMetrics metrics;
+  if (_nb == 0) return metrics;
+
+  metrics.true_positives = _tp;
+  metrics.true_negatives = _tn;
+  metrics.false_positives = _fp;
+  metrics.false_negatives = _fn;
+  metrics.sensitivity = sensitivity(_tp, _fn);
+  metrics.specificity = specificity(_tn, _fp);
+  metrics.accuracy = accuracy(_tp, _tn, _fp, _fn);
+  metrics.ppv = ppv(_tp, _fp);
+
+  metrics.mse = _mse / _nb;
+  metrics.rmse = sqrt(metrics.mse);
+  metrics.rrse = sqrt(_rrse / _nb);
+  metrics.rae = _rae / _nb;
+
+  // N.B: the distances are always "above", cf add()
+  const double sumDistBelow = 0;
+  const double distMinBelow = 0;
+  metrics.distanceThreshold = distanceToThresholdAggregate(_sum_dist_above, sumDistBelow, _tp, _tn, _fp, _fn);
+  const double distMinAbove = _dist_min_above == INFINITY_DOUBLE ? 0 : _dist_min_above;
+  metrics.distanceMinThreshold = (distMinAbove + distMinBelow) / 2;
+
+  return metrics;
+}
+
 // N.B: aggregate values for a single output variable
 FuzzySystemMetrics FuzzySystemMetricsComputer::computeForOneVariable(const vector<double>& predicted, const vector<double>& actual, double threshold) 
 {
   assert(predicted.size() == actual.size());
-  FuzzySystemMetrics metrics;
-
   const int nb = predicted.size();
 
-  double sumDistBelow = 0;
-  double sumDistAbove = 0;
-  double distMinBelow = INFINITY_DOUBLE;
-  double distMinAbove = INFINITY_DOUBLE;
-
-  int actual_nb = 0;
-  for (int i = 0; i < nb; i++) {
-      if (is_na(predicted[i]) || is_na(actual[i])) continue; // ignore prediced MISSING DATA?
-      FuzzySystemMetrics m = computeForOneValue(predicted[i], actual[i], threshold);
-      actual_nb++;
-      metrics += m;
-
-      const double dist = m.distanceThreshold;
-
-      // N.B: can never be negative since only set when both predicted and actual have the same
-      // threshold-sign
-      assert(dist >= 0);
-
-      sumDistAbove += distanceMin(dist);
-      distMinAbove = min(distMinAbove, dist);
-
-      // if (dist >= 0) { //above
-      //   sumDistAbove += distanceMin(dist);
-      //   distMinAbove = min(distMinAbove, dist);
-      // } else {
-      //   sumDistBelow += distanceMin(-dist);
-      //   distMinBelow = min(distMinBelow, -dist);
-      // }
-  }
-  if (actual_nb == 0) return metrics;
-
-  int tp = metrics.true_positives, tn = metrics.true_negatives;
-  int fp = metrics.false_positives, fn = metrics.false_negatives;
-  metrics.sensitivity = sensitivity(tp, fn);
-  metrics.specificity = specificity(tn, fp);
-  metrics.accuracy = accuracy(tp, tn, fp, fn);
-  metrics.ppv = ppv(tp, fp);
+  VariableAccumulator acc(threshold);
+  for (int i = 0; i < nb; i++)
+    acc.add(predicted[i], actual[i]);
 
-  metrics.mse = metrics.mse / actual_nb;
-  metrics.rmse = sqrt(metrics.mse);
-  metrics.rrse = sqrt(metrics.rrse / actual_nb);
-  metrics.rae = metrics.rae / actual_nb;
-
-  metrics.distanceThreshold = distanceToThresholdAggregate(sumDistAbove, sumDistBelow, tp, tn, fp, fn);
-  if (distMinAbove == INFINITY_DOUBLE) distMinAbove = 0;
-  if (distMinBelow == INFINITY_DOUBLE) distMinBelow = 0;
-  metrics.distanceMinThreshold = (distMinAbove + distMinBelow) / 2;
+  return acc.metrics();
+}
 
-  return metrics;
+void FuzzySystemMetricsComputer::averageOverVariables(FuzzySystemMetrics& metrics, int nb_vars)
+{
+  metrics.sensitivity /= nb_vars;
+  metrics.specificity /= nb_vars;
+  metrics.accuracy /= nb_vars;
+  metrics.ppv /= nb_vars;
+  metrics.rmse /= nb_vars;
+  metrics.rrse /= nb_vars;
+  metrics.rae /= nb_vars;
+  metrics.mse /= nb_vars;
+  metrics.distanceThreshold /= nb_vars;
+  metrics.distanceMinThreshold /= nb_vars;
 }
 
 FuzzySystemMetrics FuzzySystemMetricsComputer::compute(const DataFrame& predicted, const DataFrame& actual, const vector<double>& thresholds)
@@ -120,16 +117,7 @@ FuzzySystemMetrics FuzzySystemMetricsComputer::compute(const DataFrame& predicte
   }
 
   // compute mean
-  metrics.sensitivity /= nb_vars;
-  metrics.specificity /= nb_vars;
-  metrics.accuracy /= nb_vars;
-  metrics.ppv /= nb_vars;
-  metrics.rmse /= nb_vars;
-  metrics.rrse /= nb_vars;
-  metrics.rae /= nb_vars;
-  metrics.mse /= nb_vars;
-  metrics.distanceThreshold /= nb_vars;
-  metrics.distanceMinThreshold /= nb_vars;
+  averageOverVariables(metrics, nb_vars);
 
   return metrics;
 }
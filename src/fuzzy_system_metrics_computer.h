@@ -36,6 +36,52 @@ public:
 
 
 
+  // compute the mean of the metrics summed over nb_vars output variables, cf compute()
+  static void averageOverVariables(FuzzySystemMetrics& metrics, int nb_vars);
+
+  // accumulates the metrics for an output variable value by value, without storing the values nor allocating
+  // N.B: gives exactly the same results as computeForOneVariable()
+  class VariableAccumulator {
+  public:
+    VariableAccumulator(double threshold) : _threshold(threshold) {}
+
+    void add(double predicted, double actual) {
+      if (is_na(predicted) || is_na(actual)) return; // ignore prediced MISSING DATA?
+      _nb++;
+
+      if (error(predicted, actual) != 0.0) {
+        _rrse += rrse(predicted, actual);
+        _rae += rae(predicted, actual);
+        _mse += mse(predicted, actual);
+      }
+
+      double dist = 0;
+      const bool actual_positive = is_positive(actual, _threshold);
+      if (is_positive(predicted, _threshold) == actual_positive) { // well classified
+        if (actual_positive) _tp++; else _tn++;
+        dist = distanceToThreshold(predicted, actual, _threshold);
+      } else {
+        if (actual_positive) _fn++; else _fp++;
+      }
+
+      // N.B: can never be negative since only set when both predicted and actual have the same threshold-sign
+      assert(dist >= 0);
+      _sum_dist_above += distanceMin(dist);
+      _dist_min_above = min(_dist_min_above, dist);
+    }
+
+    // the aggregated metrics for the variable
+    FuzzySystemMetrics metrics() const;
+
+  private:
+    double _threshold;
+    int _nb = 0;
+    int _tp = 0, _tn = 0, _fp = 0, _fn = 0;
+    double _rrse = 0, _rae = 0, _mse = 0;
+    double _sum_dist_above = 0;
+    double _dist_min_above = INFINITY_DOUBLE;
+  };
+
   // ====== static methods and constants ===========
   static constexpr double EPSILON = 1e-9;
 
@@ -1,4 +1,5 @@
 #include "fuzzy_variable.h"
+#include "fuzzify_kernels.h"
 using namespace fuzzy_coco;
 
 FuzzyVariable::FuzzyVariable(string name, const vector<string>& set_names) : _name(std::move(name))
@@ -93,7 +94,7 @@ namespace fuzzy_coco {
 double FuzzyVariable::fuzzify(int set_idx, double value) const
 {
   // TODO: essayer de supprimer les protections pour voir la diff de vitesse
-  // TODO: zone critique en temps à essayer d'optimiser
+  // N.B: zone critique en temps: cf the column-wise version below, and FuzzifyKernels
   assert(getSetsCount() > 1);
   assert(set_idx >= 0 && set_idx < getSetsCount());
   const int lastSetNum = getSetsCount() - 1;
@@ -139,6 +140,28 @@ double FuzzyVariable::fuzzify(int set_idx, double value) const
   }
 }
 
+void FuzzyVariable::fuzzify(int set_idx, const vector<double>& values, vector<double>& res) const
+{
+  fuzzify(set_idx, ColumnView(values), res);
+}
+
+void FuzzyVariable::fuzzify(int set_idx, const ColumnView& values, vector<double>& res) const
+{
+  const int nb_sets = getSetsCount();
+  assert(nb_sets > 1);
+  assert(set_idx >= 0 && set_idx < nb_sets);
+
+  const double before = set_idx > 0 ? getSet(set_idx - 1).getPosition() : MISSING_DATA_DOUBLE;
+  const double after = set_idx < nb_sets - 1 ? getSet(set_idx + 1).getPosition() : MISSING_DATA_DOUBLE;
+  const auto kind = FuzzifyKernels::set_kind(set_idx, nb_sets);
+  const double pos = getSet(set_idx).getPosition();
+  res.resize(values.size());
+  if (values.isFloat())
+    FuzzifyKernels::fuzzify(kind, before, pos, after, values.floatData(), values.size(), res.data());
+  else
+    FuzzifyKernels::fuzzify(kind, before, pos, after, values.data(), values.size(), res.data());
+}
+
 // FuzzyInputVariable FuzzyInputVariable::load(const NamedList& desc) {
 //   FuzzyInputVariable var(desc.name(), desc.size());
 //   var.setSetsPositions(desc);
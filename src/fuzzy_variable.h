@@ -9,6 +9,7 @@
 
 #include "fuzzy_set.h"
 #include "named_list.h"
+#include "dataframe.h"
 
 namespace fuzzy_coco {
 using namespace std;
@@ -26,6 +27,11 @@ public:
 
 public: // ================= main methods =========================
   double fuzzify(int set_idx, double input) const;
+  // fuzzify a whole column of values: same results as fuzzify(set_idx, value) for each value,
+  // with missing values fuzzified to MISSING_DATA_DOUBLE. N.B: vectorized, cf FuzzifyKernels
+  void fuzzify(int set_idx, const vector<double>& values, vector<double>& res) const;
+  // same on a DataFrame column, whatever its storage
+  void fuzzify(int set_idx, const ColumnView& values, vector<double>& res) const;
   double defuzz(const vector<double>& set_eval) const;
 
 public: // ============ accessors / setters ========================
@@ -24,6 +24,8 @@ public:
     FuzzyVariablesDB(int nb_input_vars, int nb_input_sets, int nb_output_vars, int nb_output_sets);
     FuzzyVariablesDB(const vector<string>& input_names, int nb_in_sets, 
       const vector<string>& output_names, int nb_out_sets);
+    FuzzyVariablesDB(vector<FuzzyVariable> input_vars, vector<FuzzyVariable> output_vars) 
+      : _input_vars(std::move(input_vars)), _output_vars(std::move(output_vars)) {}
     FuzzyVariablesDB(const FuzzyVariablesDB& db) : _input_vars(db._input_vars), _output_vars(db._output_vars) {}
     FuzzyVariablesDB(FuzzyVariablesDB&& db) : _input_vars(std::move(db._input_vars)), _output_vars(std::move(db._output_vars)) {}
     ~FuzzyVariablesDB() {}
@@ -1,6 +1,46 @@
 #include "genome_codec.h"
 using namespace fuzzy_coco;
 
+RulesCodec::RulesCodec(int nb_rules, const IntPairParams& params_input, const IntPairParams& params_output) 
+    : _codec(params_input, params_output), _codec_default_rules(params_output.nb, params_output.nb_bits2), _nb_rules(nb_rules),
+    _nb_input_conditions(params_input.nb), _nb_output_conditions(params_output.nb)
+{
+    // same layout as encode()
+    for (int i = 0; i < _nb_rules; i++) {
+        for (int j = 0; j < _nb_input_conditions; j++) {
+            _decoder.addField(params_input.nb_bits1);
+            _decoder.addField(params_input.nb_bits2);
+        }
+        for (int j = 0; j < _nb_output_conditions; j++) {
+            _decoder.addField(params_output.nb_bits1);
+            _decoder.addField(params_output.nb_bits2);
+        }
+    }
+    _decoder.addFields(params_output.nb, params_output.nb_bits2);
+    assert(_decoder.size() == size());
+}
+
+void RulesCodec::decode(const BitArray& bits, vector<int>& fields, vector<ConditionIndexes>& rules_in, vector<ConditionIndexes>& rules_out, vector<int>& default_rules) const
+{
+    _decoder.decode(bits, fields);
+    const int* field = fields.data();
+    auto fill = [&field](ConditionIndexes& cis, int nb) {
+        cis.resize(nb);
+        for (auto& ci : cis) {
+            ci.var_idx = *field++;
+            ci.set_idx = *field++;
+        }
+    };
+
+    rules_in.resize(_nb_rules);
+    rules_out.resize(_nb_rules);
+    for (int i = 0; i < _nb_rules; i++) {
+        fill(rules_in[i], _nb_input_conditions);
+        fill(rules_out[i], _nb_output_conditions);
+    }
+    default_rules.assign(field, field + _nb_output_conditions);
+}
+
 void RulesCodec::decode(BitArray::const_iterator& bits, vector<ConditionIndexes>& rules_in, vector<ConditionIndexes>& rules_out, vector<int>& default_rules) const 
 {
     rules_in.resize(_nb_rules);
@@ -48,7 +88,32 @@ DiscretizedFuzzySystemSetPositionsCodec::DiscretizedFuzzySystemSetPositionsCodec
         _codec_out(output.nb_bits),
         _disc_in(disc_in), 
         _disc_out(disc_out)
-{}
+{
+    // same layout as encode()
+    _decoder.addFields(input.nb_vars * input.nb_sets, input.nb_bits);
+    _decoder.addFields(output.nb_vars * output.nb_sets, output.nb_bits);
+    assert(_decoder.size() == size());
+}
+
+void DiscretizedFuzzySystemSetPositionsCodec::decode(const BitArray& bits, vector<int>& fields, Matrix<double>& pos_in, Matrix<double>& pos_out) const
+{
+    _decoder.decode(bits, fields);
+    pos_in.redim(getNbInputVars(), _input_params.nb_sets);
+    pos_out.redim(getNbOutputVars(), _output_params.nb_sets);
+    undiscretize(undiscretize(fields.data(), pos_in, _disc_in), pos_out, _disc_out);
+}
+
+// N.B: returns the first unused field
+const int* DiscretizedFuzzySystemSetPositionsCodec::undiscretize(const int* fields, Matrix<double>& pos,  const vector<Discretizer>& discs)
+{
+    const int nbrows = pos.nbrows();
+    for (int i = 0; i < nbrows; i++) {
+        const auto& discretizer = discs[i];
+        for (auto& p : pos[i])
+            p = discretizer.undiscretize(*fields++);
+    }
+    return fields;
+}
 
 
 void DiscretizedFuzzySystemSetPositionsCodec::decode(BitArray::const_iterator& bits, Matrix<double>& pos_in, Matrix<double>& pos_out) const 
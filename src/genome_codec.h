@@ -188,10 +188,43 @@ private:
     ConditionIndexesCodec _codec_out;
 };
 
+// a precomputed table of the (bit offset, width) of the fields of a genome, to decode it at once
+// into a flat array of ints: the value of the field #i goes to the slot #i
+// N.B: the fields are extracted using word-level shift/mask, cf BitArray::getField()
+class FieldsDecoder {
+public:
+    // append a field of nb_bits just after the previous one
+    void addField(int nb_bits) { 
+        _fields.push_back({size_t(_nb_bits), nb_bits});
+        _nb_bits += nb_bits;
+    }
+    void addFields(int nb, int nb_bits) { for (int i = 0; i < nb; i++) addField(nb_bits); }
+
+    int getNbFields() const { return _fields.size(); }
+    // the total number of bits
+    int size() const { return _nb_bits; }
+
+    // N.B: values is resized to getNbFields(), no allocation once sized
+    void decode(const BitArray& bits, vector<int>& values) const {
+        assert(bits.size() >= size_t(size()));
+        const int nb = _fields.size();
+        values.resize(nb);
+        for (int i = 0; i < nb; i++)
+            values[i] = int(bits.getField(_fields[i].offset, _fields[i].nb_bits));
+    }
+
+private:
+    struct Field {
+        size_t offset;
+        int nb_bits;
+    };
+    vector<Field> _fields;
+    int _nb_bits = 0;
+};
+
 class RulesCodec {
 public:
-    RulesCodec(int nb_rules, const IntPairParams& params_input, const IntPairParams& params_output) 
-        : _codec(params_input, params_output), _codec_default_rules(params_output.nb, params_output.nb_bits2), _nb_rules(nb_rules) {}
+    RulesCodec(int nb_rules, const IntPairParams& params_input, const IntPairParams& params_output);
 
     int getNbRules() const { return _nb_rules; }
 
@@ -208,10 +241,14 @@ public:
     }
 
     void decode(BitArray::const_iterator& bits, vector<ConditionIndexes>& rules_in, vector<ConditionIndexes>& rules_out, vector<int>& default_rules) const;
+    // same as above but uses the precomputed fields table: fields is a buffer for the decoded values
+    void decode(const BitArray& bits, vector<int>& fields, vector<ConditionIndexes>& rules_in, vector<ConditionIndexes>& rules_out, vector<int>& default_rules) const;
 
     void encode(const vector<ConditionIndexes>& rules_in, const vector<ConditionIndexes>& rules_out, const vector<int>& default_rules, 
         BitArray::iterator& bits) const;
 
+    const FieldsDecoder& getFieldsDecoder() const { return _decoder; }
+
     int size() const { return _codec.size() * getNbRules() + _codec_default_rules.size(); }
 
     inline friend ostream& operator<<(ostream& out, const RulesCodec& codec) {
@@ -226,6 +263,9 @@ private:
     RuleCodec _codec;
     IntVectorCodec _codec_default_rules;
     int _nb_rules;
+    int _nb_input_conditions;
+    int _nb_output_conditions;
+    FieldsDecoder _decoder;
 };
 
 struct PosParams {
@@ -285,6 +325,8 @@ public:
     }
 
     void decode(BitArray::const_iterator& it, Matrix<double>& pos_in, Matrix<double>& pos_out) const;
+    // same as above but uses the precomputed fields table: fields is a buffer for the decoded values
+    void decode(const BitArray& bits, vector<int>& fields, Matrix<double>& pos_in, Matrix<double>& pos_out) const;
 
     void encode(const Matrix<double>& pos_in, const Matrix<double>& pos_out, BitArray::iterator& it) const;
 
@@ -301,6 +343,7 @@ public:
 protected:
     static void encode(const Matrix<double>& pos, BitArray::iterator& bits, const vector<Discretizer>& discs, const IntCodec& codec);
     static void decode(BitArray::const_iterator& bits, Matrix<double>& pos,  const vector<Discretizer>& discs, const IntCodec& codec);
+    static const int* undiscretize(const int* fields, Matrix<double>& pos,  const vector<Discretizer>& discs);
 
 private:
     PosParams _input_params;
@@ -309,6 +352,7 @@ private:
     IntCodec _codec_out;
     vector<Discretizer> _disc_in;
     vector<Discretizer> _disc_out;
+    FieldsDecoder _decoder;
 };
 
 }
@@ -0,0 +1,192 @@
+#include "island_model.h"
+#include "logging_logger.h"
+
+using namespace fuzzy_coco;
+using namespace logging;
+
+static int nb_pool_threads(const GlobalParams& params) {
+  const int nb_threads = params.nb_threads > 0 ? params.nb_threads : ThreadPool::hardware_concurrency();
+  return min(nb_threads, params.nb_islands);
+}
+
+// N.B: the islands are evolved in parallel, so each island evaluates its fitnesses in a single thread
+static FuzzyCocoParams island_params(const FuzzyCocoParams& params) {
+  FuzzyCocoParams p = params;
+  p.global_params.nb_threads = 1;
+  return p;
+}
+
+IslandModel::IslandModel(const DataFrame& dfin, const DataFrame& dfout, const FuzzyCocoParams& params, int seed)
+  : _params(params),
+    _topology(parseMigrationTopology(params.global_params.migration_topology)),
+    _rng(seed),
+    _pool(nb_pool_threads(params.global_params)),
+    _criteria(params.global_params)
+{
+  const int nb_islands = params.global_params.nb_islands;
+  if (nb_islands < 1) THROW_WITH_LOCATION("nb_islands must be >= 1");
+
+  const FuzzyCocoParams p = island_params(params);
+  _rngs.reserve(nb_islands);
+  _islands.reserve(nb_islands);
+  for (int i = 0; i < nb_islands; i++) {
+    _rngs.push_back(make_unique<RandomGenerator>(int(_rng.random())));
+    _islands.push_back(make_unique<FuzzyCoco>(dfin, dfout, p, *_rngs.back()));
+  }
+  _generations.resize(nb_islands);
+}
+
+void IslandModel::start() {
+  const auto& p = getParams().global_params;
+  _pool.run(getNbIslands(), [&](int i, int) {
+    _generations[i] = getIsland(i).start(*_rngs[i], p.influence_rules_initial_population, p.influence_evolving_ratio);
+  });
+}
+
+void IslandModel::evolve(int nb, double max_fit) {
+  _pool.run(getNbIslands(), [&](int i, int) {
+    auto& engine = getIsland(i).getEngine();
+    auto& gen = _generations[i];
+    for (int j = 0; j < nb && gen.fitness < max_fit; j++)
+      gen = engine.next(gen);
+  });
+}
+
+vector<int> IslandModel::selectDestinations() {
+  const int nb_islands = getNbIslands();
+  vector<int> destinations(nb_islands);
+  for (int i = 0; i < nb_islands; i++)
+    destinations[i] = _topology == MigrationTopology::RING ? (i + 1) % nb_islands : (i + _rng.random(1, nb_islands - 1)) % nb_islands;
+  return destinations;
+}
+
+void IslandModel::replaceWorst(Generation& gen, const Genomes& immigrants) {
+  const int nb_individuals = gen.individuals.size();
+  vector<int> idx(nb_individuals);
+  for (int i = 0; i < nb_individuals; i++) idx[i] = i;
+  // sort by increasing fitness, ties handled by the indices for determinism
+  sort(idx.begin(), idx.end(), [&](int a, int b) {
+    return gen.fitnesses[a] < gen.fitnesses[b] ? true : gen.fitnesses[a] > gen.fitnesses[b] ? false : a < b;
+  });
+
+  const int nb = min<int>(immigrants.size(), nb_individuals);
+  for (int i = 0; i < nb; i++)
+    gen.individuals[idx[i]] = immigrants[i];
+}
+
+void IslandModel::migrate() {
+  const int nb_islands = getNbIslands();
+  const int nb_migrants = getParams().global_params.nb_migrants;
+
+  // the emigrants are the best of the elites (the elites are sorted by decreasing fitness, but the last one)
+  auto emigrants = [nb_migrants](const Generation& gen) {
+    const int nb = min<int>(nb_migrants, gen.elite.size());
+    return Genomes(gen.elite.begin(), gen.elite.begin() + nb);
+  };
+
+  const vector<int> destinations = selectDestinations();
+  vector<Genomes> rules_immigrants(nb_islands), mfs_immigrants(nb_islands);
+  for (int i = 0; i < nb_islands; i++) {
+    const int dst = destinations[i];
+    const auto rules = emigrants(_generations[i].left_gen);
+    const auto mfs = emigrants(_generations[i].right_gen);
+    rules_immigrants[dst].insert(rules_immigrants[dst].end(), rules.begin(), rules.end());
+    mfs_immigrants[dst].insert(mfs_immigrants[dst].end(), mfs.begin(), mfs.end());
+  }
+
+  // N.B: the islands are updated in parallel, their update only depends on their own state
+  _pool.run(nb_islands, [&](int i, int) {
+    auto& gen = _generations[i];
+    replaceWorst(gen.left_gen, rules_immigrants[i]);
+    replaceWorst(gen.right_gen, mfs_immigrants[i]);
+    getIsland(i).getEngine().update(gen);
+    gen.fitness = max(gen.left_gen.fitness, gen.right_gen.fitness);
+  });
+}
+
+int IslandModel::getBestIslandIndex() const {
+  int best = 0;
+  for (int i = 1; i < getNbIslands(); i++)
+    if (_islands[i]->getFitnessMethod().getBestFitness() > _islands[best]->getFitnessMethod().getBestFitness())
+      best = i;
+  return best;
+}
+
+long IslandModel::getNbEvaluations() const {
+  long nb = 0;
+  for (const auto& island : _islands)
+    nb += island->getFitnessMethod().getNbEvaluations();
+  return nb;
+}
+
+Checkpoint::State IslandModel::getState() {
+  Checkpoint::State state;
+  state.params = Checkpoint::describeParams(getParams());
+  state.rng_state = _rng.getState();
+  state.elapsed_seconds = _criteria.getElapsedSeconds();
+  state.last_improvement = _criteria.getLastImprovement();
+  for (int i = 0; i < getNbIslands(); i++)
+    state.coevolutions.push_back(getIsland(i).getState(_generations[i]));
+  return state;
+}
+
+void IslandModel::restoreState(const Checkpoint::State& state) {
+  Checkpoint::checkParams(state, getParams());
+  if (int(state.coevolutions.size()) != getNbIslands())
+    THROW_WITH_LOCATION("Error in IslandModel::restoreState(): bad number of islands");
+  _rng.setState(state.rng_state);
+  for (int i = 0; i < getNbIslands(); i++)
+    _generations[i] = getIsland(i).restoreState(state.coevolutions[i]);
+}
+
+CoevGeneration IslandModel::run(const Checkpoint::Options& checkpoint) {
+  const auto& p = getParams().global_params;
+  const int interval = max(p.migration_interval, 1);
+  logger() << L_time << "IslandModel::run(): " << getNbIslands() << " islands, " << p.max_generations
+    << " generations, migration every " << interval << " generations" << endl;
+
+  int nb_done = 0;
+  if (checkpoint.enabled() && checkpoint.resume && exists(path(checkpoint.filename))) {
+    const auto state = Checkpoint::load(path(checkpoint.filename));
+    restoreState(state);
+    nb_done = _generations.front().generation_number;
+    _criteria.start(state.last_improvement, getBestIsland().getFitnessMethod().getBestFitness(), state.elapsed_seconds);
+    logger() << L_time << "IslandModel::run(): resuming from " << checkpoint.filename 
+      << " at generation " << nb_done << endl;
+  } else {
+    start();
+    _criteria.start(nb_done, getBestIsland().getFitnessMethod().getBestFitness());
+  }
+
+  // N.B: the migrations happen every interval generations, even after the last one, so that a run resumed
+  // from a checkpoint with more generations is identical to an uninterrupted one
+  int last_checkpoint = nb_done;
+  _stop_reason = nb_done >= p.max_generations ? StopReason::MAX_GENERATIONS : StopReason::NONE;
+  while (_stop_reason == StopReason::NONE) {
+    const int nb = min(interval - nb_done % interval, p.max_generations - nb_done);
+    evolve(nb, p.max_fitness);
+    nb_done += nb;
+
+    // N.B: the stopping criteria are checked between the epochs, on all the islands
+    double fitness = numeric_limits<double>::lowest();
+    double best_fitness = numeric_limits<double>::lowest();
+    for (int i = 0; i < getNbIslands(); i++) {
+      fitness = max(fitness, _generations[i].fitness);
+      best_fitness = max(best_fitness, getIsland(i).getFitnessMethod().getBestFitness());
+    }
+    logger() << L_time << "generation " << nb_done << ": best island=" << getBestIslandIndex()
+      << ", fitness=" << best_fitness << endl;
+    _stop_reason = _criteria.check(nb_done, fitness, best_fitness, getNbEvaluations());
+    if (_stop_reason == StopReason::MAX_FITNESS) break;
+
+    if (nb_done % interval == 0) migrate();
+
+    if (checkpoint.enabled() && (nb_done - last_checkpoint >= max(checkpoint.interval, 1) || _stop_reason != StopReason::NONE)) {
+      Checkpoint::save(getState(), path(checkpoint.filename));
+      last_checkpoint = nb_done;
+    }
+  }
+  logger() << L_time << "IslandModel::run(): stopped at generation " << nb_done << ": " << toString(_stop_reason) << endl;
+
+  return _generations[getBestIslandIndex()];
+}
@@ -0,0 +1,73 @@
+#ifndef ISLAND_MODEL_H
+#define ISLAND_MODEL_H
+
+#include <memory>
+#include "fuzzy_coco.h"
+#include "thread_pool.h"
+
+namespace fuzzy_coco {
+
+// the island model: nb_islands independent FuzzyCoco coevolutions, evolved in parallel, each with its own
+// RandomGenerator seeded from the master one. Every migration_interval generations, the best rules and MFs genomes
+// of each island migrate to another island (ring or random topology), where they replace the worst individuals.
+// N.B: the islands only interact during the migrations, whose destinations are drawn from the master RandomGenerator,
+// so the results only depend on the seed and the number of islands, not on the number of threads
+class IslandModel
+{
+public:
+  // N.B: the islands use params.global_params.nb_threads threads overall
+  IslandModel(const DataFrame& dfin, const DataFrame& dfout, const FuzzyCocoParams& params, int seed);
+
+  // highest level function, evolve all the islands using the params
+  // returns the generation of the best island
+  // N.B: the stopping criteria (cf StoppingCriteria) are checked on all the islands after each epoch, i.e. every
+  // migration_interval generations
+  // N.B: with checkpoint, the islands are checkpointed after the migrations, every checkpoint.interval generations
+  // (at least), and the run is possibly resumed from the checkpoint file (cf Checkpoint)
+  CoevGeneration run(const Checkpoint::Options& checkpoint = Checkpoint::Options());
+  // why the last run() stopped, or NONE
+  StopReason getStopReason() const { return _stop_reason; }
+
+  // start all islands, i.e. build and evaluate their initial generations
+  void start();
+  // evolve all islands for (at most) nb generations
+  void evolve(int nb, double max_fit);
+  // exchange the best genomes between the islands
+  void migrate();
+
+  // the state of all the islands, cf Checkpoint
+  Checkpoint::State getState();
+  // N.B: throws a runtime_error if the state does not match the params
+  void restoreState(const Checkpoint::State& state);
+
+  int getNbIslands() const { return _islands.size(); }
+  FuzzyCoco& getIsland(int idx) { return *_islands[idx]; }
+  const CoevGeneration& getGeneration(int idx) const { return _generations[idx]; }
+  // the index of the island with the best fitness computed so far (the first one in case of ties)
+  int getBestIslandIndex() const;
+  FuzzyCoco& getBestIsland() { return getIsland(getBestIslandIndex()); }
+  const FuzzyCocoParams& getParams() const { return _params; }
+  // the number of fitness evaluations of all the islands, cf CoevolutionFitnessMethod::getNbEvaluations()
+  long getNbEvaluations() const;
+
+  // the destination island of the migrants of each island
+  vector<int> selectDestinations();
+
+  // replace the nb worst individuals of gen (according to its fitnesses) by the immigrants
+  static void replaceWorst(Generation& gen, const Genomes& immigrants);
+
+private:
+  FuzzyCocoParams _params;
+  MigrationTopology _topology;
+  RandomGenerator _rng;
+  // N.B: the islands keep references to their RandomGenerator
+  vector<unique_ptr<RandomGenerator>> _rngs;
+  vector<unique_ptr<FuzzyCoco>> _islands;
+  vector<CoevGeneration> _generations;
+  ThreadPool _pool;
+  StoppingCriteria _criteria;
+  StopReason _stop_reason = StopReason::NONE;
+};
+
+}
+#endif // ISLAND_MODEL_H
@@ -0,0 +1,64 @@
+#include "mapped_file.h"
+#include <fstream>
+#include <sstream>
+#include <system_error>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define FUZZY_COCO_MMAP 1
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace fuzzy_coco;
+
+#ifdef FUZZY_COCO_MMAP
+
+MappedFile::MappedFile(const path& filename) {
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw filesystem_error("error opening file", filename, error_code(errno, generic_category()));
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    throw filesystem_error("error reading file", filename, error_code(errno, generic_category()));
+  }
+  _size = st.st_size;
+
+  // N.B: mmap() of an empty file fails
+  if (_size > 0) {
+    void* addr = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+      close(fd);
+      throw filesystem_error("error mapping file", filename, error_code(errno, generic_category()));
+    }
+    madvise(addr, _size, MADV_SEQUENTIAL);
+    _data = static_cast<const char*>(addr);
+    _mapped = true;
+  }
+  // N.B: the mapping stays valid after the file is closed
+  close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (_mapped) munmap(const_cast<char*>(_data), _size);
+}
+
+#else
+
+MappedFile::MappedFile(const path& filename) {
+  ifstream in(filename, ios::binary);
+  if (!in.is_open())
+    throw filesystem_error("error opening file", filename, error_code());
+  ostringstream content;
+  content << in.rdbuf();
+  _content = content.str();
+  _data = _content.data();
+  _size = _content.size();
+}
+
+MappedFile::~MappedFile() {}
+
+#endif
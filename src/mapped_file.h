@@ -0,0 +1,37 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <string_view>
+#include <filesystem>
+
+namespace fuzzy_coco {
+
+using namespace std;
+using namespace std::filesystem;
+
+// a read-only view on the whole content of a file, memory-mapped on POSIX systems
+// (so that huge files are paged in on demand by the OS), or read in memory otherwise
+// N.B: throws a filesystem_error if the file can not be opened
+class MappedFile
+{
+public:
+  MappedFile(const path& filename);
+  ~MappedFile();
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const char* data() const { return _data; }
+  size_t size() const { return _size; }
+  string_view view() const { return {_data, _size}; }
+
+private:
+  const char* _data = nullptr;
+  size_t _size = 0;
+  bool _mapped = false;
+  // the content when the file is not memory-mapped
+  string _content;
+};
+
+}
+#endif // MAPPED_FILE_H
@@ -1,4 +1,5 @@
 #include "mutation_method.h"
+#include "profiler.h"
 
 using namespace fuzzy_coco;
 
@@ -8,21 +9,50 @@ void TogglingMutationMethod::mutate(Genome& genome)
     if (_mut_flip_genome == 0) {
         // flip a single random position
         int idx = _rng.random(0, nb - 1);
-        genome[idx] = !genome[idx];
+        genome.flip(idx);
         return;
     }
+    if (_geometric) mutateGeometric(genome);
+    else mutateLegacy(genome);
+}
+
+void TogglingMutationMethod::mutateLegacy(Genome& genome)
+{
+    const int nb = genome.size();
     // batch compute of probs per bit
     vector<double> probs(nb);
     probs.clear();
     _rng.randomReal(0, 1, nb, probs);
     for (int i = 0; i < nb; i++) {
         if (probs[i] < _mut_flip_genome)
-             genome[i] = !genome[i];
+             genome.flip(i);
     
     }
 }
 
+// the number of non-flipped bits before the next flipped one follows a geometric distribution
+// of parameter p=_mut_flip_genome: gap = floor(log(U) / log(1 - p)) with U uniform in ]0, 1]
+void TogglingMutationMethod::mutateGeometric(Genome& genome)
+{
+    const size_t nb = genome.size();
+    if (_mut_flip_genome >= 1) {
+        for (size_t i = 0; i < nb; i++) genome.flip(i);
+        return;
+    }
+
+    size_t pos = 0;
+    while (true) {
+        const double u = 1.0 - _rng.randomReal(0, 1);
+        const double gap = floor(log(u) / _log_no_flip);
+        // N.B: compare as double to avoid overflows when the gap is huge
+        if (gap >= double(nb - pos)) break;
+        pos += size_t(gap);
+        genome.flip(pos++);
+    }
+}
+
 void TogglingMutationMethod::mutate(vector<Genome>& genomes) {
+    PROFILE_PHASE(MUTATION);
     for (auto& gen: genomes) {
         if (_rng.randomReal(0, 1) < _mutFlipInd)
             mutate(gen);
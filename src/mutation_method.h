@@ -1,6 +1,7 @@
 #ifndef MUTATION_METHOD_H
 #define MUTATION_METHOD_H
 
+#include <cmath>
 #include "genome.h"
 #include "random_generator.h"
 
@@ -20,17 +21,29 @@ class TogglingMutationMethod : public MutationMethod
 public:
     // mutFlipInd: the probability that a genome is a target for a mutation
     // mut_flip_genome: the probability that a bit of a genome is mutated
-    TogglingMutationMethod(RandomGenerator& rng, double mutFlipInd, double mut_flip_genome) 
-        : _rng(rng), _mutFlipInd(mutFlipInd), _mut_flip_genome(mut_flip_genome) {}
+    // geometric: whether to use the geometric skip-sampling (cf mutateGeometric()) instead of the
+    // legacy one-draw-per-bit sampling. N.B: both give the same distribution but not the same random draws
+    TogglingMutationMethod(RandomGenerator& rng, double mutFlipInd, double mut_flip_genome, bool geometric = false) 
+        : _rng(rng), _mutFlipInd(mutFlipInd), _mut_flip_genome(mut_flip_genome), _geometric(geometric),
+        _log_no_flip(log1p(-mut_flip_genome)) {}
 
     // N.B: if mutationPerBitProbability == 0 --> flip a single random position
     void mutate(Genome& genome) override;
     void mutate(vector<Genome>& genomes) override;
 
+    // draw a random number for each bit
+    void mutateLegacy(Genome& genome);
+    // draw the gaps between the flipped bits from a geometric distribution: 
+    // the cost is proportional to the number of flips, and there is no allocation
+    void mutateGeometric(Genome& genome);
+
 private:
     RandomGenerator& _rng;
     double _mutFlipInd;
     double _mut_flip_genome;
+    bool _geometric;
+    // log(1 - _mut_flip_genome)
+    double _log_no_flip;
 };
 
 }
@@ -1,12 +1,12 @@
 #include <iomanip>
+#include <charconv>
+#include <iterator>
 
 #include "named_list.h"
 #include "types.h"
 #include "string_utils.h"
-#include "logging_logger.h"
 
 using namespace fuzzy_coco;
-using namespace logging;
 
 
 
@@ -33,50 +33,162 @@ void Scalar::print(ostream& out) const {
     }
 }
 
-Scalar Scalar::parse(istream& in) {
-  const char QUOTE = '"';
-  string item;
-  in >> item;
+namespace {
+  // a single-pass, non-recursive tokenizer for the NamedList JSON-like format, on the whole content
+  // N.B: no per-token allocation except for the strings themselves
+  struct Parser {
+    string_view content;
+    size_t pos = 0;
 
-  logger() << "Scalar::parse(): item='" << item << "'\n"; 
+    static constexpr char QUOTE = '"';
+    static constexpr char SPACE = ' ';
+    static constexpr char COMMA = ',';
 
-  // null
-  if (item.empty()) return Scalar();
+    bool at_end() const { return pos >= content.size(); }
+    char peek() const { return content[pos]; }
 
-  if (item.back() == '}')
-  in.unget();
+    void skip_spaces() { 
+      while (!at_end() && peek() <= SPACE) pos++; 
+    }
+    void skip_spaces_and_commas() { 
+      while (!at_end() && (peek() <= SPACE || peek() == COMMA)) pos++; 
+    }
 
-  if (item.at(0) == QUOTE) { // string
-    int last_quote_idx = item.find_last_of(QUOTE);
-    string s(item.begin() + 1, item.begin() + last_quote_idx);
+    // parse a quoted string, starting at the opening quote. N.B: handles the escapes produced by quoted()
+    string parse_string() {
+      assert(peek() == QUOTE);
+      pos++;
+      string s;
+      while (true) {
+        const size_t next = content.find_first_of("\\\"", pos);
+        if (next == string_view::npos) THROW_WITH_LOCATION("parsing error, unterminated string");
+        s.append(content.substr(pos, next - pos));
+        pos = next + 1;
+        if (content[next] == QUOTE) break;
+        // escape
+        if (at_end()) THROW_WITH_LOCATION("parsing error, unterminated string");
+        s += content[pos++];
+      }
+      return s;
+    }
 
-    // it may by a NA string
-    if (s == NA_DOUBLE_STRING)
-      return Scalar(MISSING_DATA_DOUBLE);
-    else if (s == NA_INT_STRING)
-      return Scalar(MISSING_DATA_INT);
+    Scalar parse_scalar() {
+      skip_spaces();
+      if (at_end()) return Scalar();
+
+      if (peek() == QUOTE) {
+        string s = parse_string();
+        // it may by a NA string
+        if (s == NA_DOUBLE_STRING)
+          return Scalar(MISSING_DATA_DOUBLE);
+        else if (s == NA_INT_STRING)
+          return Scalar(MISSING_DATA_INT);
+        return Scalar(std::move(s));
+      }
 
-    return Scalar(s);
-  }
+      // the token ends with a space, a comma or the end of the list
+      const size_t start = pos;
+      while (!at_end() && peek() > SPACE && peek() != COMMA && peek() != '}') pos++;
+      const string_view item = content.substr(start, pos - start);
 
-  // bool case
-  if (item[0] == 't' || item[0] == 'f') {
-    if (item.length() >= 4 && item.substr(0, 4) == "true") 
-      return Scalar(true);
-    if (item.length() >= 5 && item.substr(0, 5) == "false") 
-      return Scalar(false);
-    THROW_WITH_LOCATION("in Scalar::parse, unable to parse item: " + item);
-  }
+      // null
+      if (item.empty()) return Scalar();
 
-  // look for the dot
-  if (item.find_first_of('.') != item.npos) // double
-    return Scalar(stod(item));
+      // bool case
+      if (item[0] == 't' || item[0] == 'f') {
+        if (item == "true") return Scalar(true);
+        if (item == "false") return Scalar(false);
+        THROW_WITH_LOCATION("in Scalar::parse, unable to parse item: " + string(item));
+      }
+
+      const char* first = item.data();
+      const char* last = first + item.size();
+      // N.B: a double has a dot or an exponent
+      if (item.find_first_of(".eE") != string_view::npos) {
+        double d;
+        auto [ptr, ec] = from_chars(first, last, d);
+        if (ec == errc::invalid_argument) throw invalid_argument("unable to parse double: " + string(item));
+        if (ec == errc::result_out_of_range) throw out_of_range("double out of range: " + string(item));
+        return Scalar(d);
+      }
+      int i;
+      auto [ptr, ec] = from_chars(first, last, i);
+      if (ec == errc::invalid_argument) throw invalid_argument("unable to parse int: " + string(item));
+      if (ec == errc::result_out_of_range) throw out_of_range("int out of range: " + string(item));
+      return Scalar(i);
+    }
 
-  return Scalar(stoi(item));
+    // "name":, returns the name and leaves the position after the colon
+    string parse_element_name() {
+      string name = parse_string();
+      skip_spaces();
+      if (at_end() || peek() != ':') THROW_WITH_LOCATION("parsing error, expected ':' after \"" + name + "\"");
+      pos++; // consume :
+      skip_spaces();
+      return name;
+    }
+
+    // parse the list starting at the opening brace. N.B: the nested lists are handled with an
+    // explicit stack, not by recursion
+    NamedList parse_list(const string& name) {
+      vector<NamedList> stack;
+      stack.emplace_back(name);
+      pos++; // consume {
+      while (true) {
+        skip_spaces_and_commas();
+        if (at_end()) THROW_WITH_LOCATION("parsing error, unterminated list");
+        const char ch = peek();
+        if (ch == '}') {
+          pos++;
+          NamedList done = std::move(stack.back());
+          stack.pop_back();
+          if (stack.empty()) return done;
+          stack.back().append(std::move(done));
+        } else if (ch == QUOTE) {
+          string elt_name = parse_element_name();
+          if (!at_end() && peek() == '{') {
+            pos++; // consume {
+            stack.emplace_back(elt_name);
+          } else {
+            stack.back().append(NamedList(elt_name, parse_scalar()));
+          }
+        } else {
+          THROW_WITH_LOCATION(string("parsing error, current character=") + ch);
+        }
+      }
+    }
+
+    NamedList parse_document() {
+      skip_spaces();
+      if (at_end()) return NamedList();
+      const char ch = peek();
+
+      if (ch == '}') 
+        THROW_WITH_LOCATION(string("parsing error, current character=") + ch);
+
+      if (ch == '{') return parse_list("");
+
+      if (ch == QUOTE) { // element
+        string elt_name = parse_element_name();
+        if (!at_end() && peek() == '{') return parse_list(elt_name);
+        return NamedList(elt_name, parse_scalar());
+      }
+
+      return NamedList();
+    }
+  };
+}
+
+static string slurp_stream(istream& in) {
+  return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
 }
-Scalar Scalar::parse(const string& content) {
-  istringstream str = istringstream(content);
-  return parse(str);
+
+Scalar Scalar::parse(istream& in) {
+  return parse(slurp_stream(in));
+}
+
+Scalar Scalar::parse(string_view content) {
+  return Parser{content}.parse_scalar();
 }
 
 bool NamedList::operator==(const NamedList& l) const {
@@ -92,79 +204,23 @@ bool NamedList::operator==(const NamedList& l) const {
 }
 
 
-NamedList NamedList::parse(const string& content) {
-    istringstream str = istringstream(content);
-    return parse(str);
+NamedList NamedList::parse(string_view content) {
+  return Parser{content}.parse_document();
 }
 
-NamedList NamedList::parse(istream &in)
-{
-  logger() << "NamedList::parse()\n";
-  const char QUOTE = '"';
-  const char SPACE = ' ';
-  const char COMMA = ',';
-
-
-
-  auto peek_next_significant = [&](){ while(in && in.peek() <= SPACE) in.get(); return in.peek(); };
-  auto skip_comma = [&](){ if (in.peek() == COMMA) in.get(); };
-
-  char ch = peek_next_significant();
-
-  logger() << "NamedList::parse() ch='" << ch << "'\n";
-
-  if (in.eof()) return(NamedList());
-
-  if (ch == '}')
-  { // end of list
-    THROW_WITH_LOCATION(string("parsing error, current character=") + ch);
-  }
-
-  if (ch == '{')
-  { // list
-    NamedList list;
-    in.get(); // consume {
-    while (in && peek_next_significant() != '}')
-    {
-      skip_comma();
-      auto child = NamedList::parse(in);
-      skip_comma();
-      list.add(child);
-    }
-    in.get(); // consume }
-
-    return list;
-  }
-
-  if (ch == QUOTE)
-  { // element
-    char c = 0;
-    in.get(c); // consume "
-    string elt_name;
-    getline(in, elt_name, QUOTE);
-    c = peek_next_significant();
-    assert(c == ':');
-    in.get(c); // consume :
-    if (peek_next_significant() == '{') {
-      auto sublist = NamedList::parse(in);
-      skip_comma();
-      sublist._name = elt_name;
-
-      return sublist;
-    }
-    auto scalar = Scalar::parse(in);
-    skip_comma();
-    return NamedList(elt_name, scalar);
-  }
-
-  // THROW_WITH_LOCATION(string("parsing error, current character=") + ch);
-
-  return NamedList();
+NamedList NamedList::parse(istream &in) {
+  return parse(slurp_stream(in));
 }
 
 int NamedList::find_first_idx(const string& name) const 
 {
   if (!is_list()) return -1;
+  if (_index) {
+    auto it = _index->find(name);
+    if (it != _index->end() && _children[it->second]._name == name) return it->second;
+    // N.B: the index may be stale, since a child may have been replaced or renamed through the
+    // non-const accessors --> fall back on the linear scan
+  }
   const int nb = size();
   for (int i = 0; i < nb; i++)
     if ( (*this)[i].name() == name) return i;
@@ -237,6 +293,10 @@ double NamedList::get_double(const string& name, double default_value) const {
   return has(name) ? get_double(name) : default_value; 
 }
 
+double NamedList::get_numeric(const string& name, double default_value) const {
+  return has(name) ? get_numeric(name) : default_value; 
+}
+
 vector<string> NamedList::names() const {
   vector<string> res;
   res.reserve(size());
@@ -284,10 +344,32 @@ string NamedList::to_string() const
 
 
 void NamedList::add(const string& name, const NamedList& elt) {
-  assert(is_list());
   NamedList node(elt);
   node._name = name;
-  _children.push_back(node);
+  append(std::move(node));
+}
+
+void NamedList::append(NamedList&& elt) {
+  assert(is_list());
+  _children.push_back(std::move(elt));
+  const int idx = _children.size() - 1;
+  if (_index) {
+    // N.B: the index may be shared with copies of this list
+    if (_index.use_count() > 1) _index = make_shared<unordered_map<string, int>>(*_index);
+    // N.B: keep the first matching name
+    _index->emplace(_children[idx]._name, idx);
+  } else if (_children.size() >= INDEX_MIN_SIZE) {
+    buildIndex();
+  }
+}
+
+void NamedList::buildIndex() {
+  auto index = make_shared<unordered_map<string, int>>();
+  index->reserve(_children.size());
+  const int nb = _children.size();
+  for (int i = 0; i < nb; i++)
+    index->emplace(_children[i]._name, i);
+  _index = std::move(index);
 }
 
 void NamedList::add(const string& name, const vector<double>& v) {
@@ -9,6 +9,8 @@
 #include <variant>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <string_view>
 
 namespace fuzzy_coco {
 
@@ -45,7 +47,7 @@ public:
 
     void print(ostream& out) const;
     static Scalar parse(istream& in);
-    static Scalar parse(const string& content);
+    static Scalar parse(string_view content);
 
     friend ostream& operator<<(ostream& out, const Scalar& scalar) {
         scalar.print(out);
@@ -74,8 +76,8 @@ public: // ========= main read-only user interface =================
   const NamedList& operator[](int idx) const { return _children.at(idx); }
   NamedList& operator[](int idx)  { return _children.at(idx); }
 
-  // // access elements by name: N.B linear in size(), only the first matching name is returned, or an exception
-  // is thrown
+  // // access elements by name: only the first matching name is returned, or an exception is thrown
+  // N.B: linear in size(), except for the names found in the lists with at least INDEX_MIN_SIZE elements, that are indexed
   const NamedList& operator[](const string& name) const { return fetch(name); }
   NamedList& operator[](const string& name)  { return fetch(name); }
 
@@ -98,6 +100,8 @@ public: // ========= main read-only user interface =================
   int get_int(const string& name, int default_value) const;
   int get_as_int(const string& name, int default_value) const;
   double get_double(const string& name, double default_value) const;
+  // N.B: accepts an int or a double
+  double get_numeric(const string& name, double default_value) const;
 
   const string& get_string() const { return scalar_check().get_string(); }
   int get_int() const { return scalar_check().get_int(); }
@@ -114,10 +118,16 @@ public: // ========= main setter user interface =================
 
   void add(const string& name, const vector<double>& v);
   void add(const string& name, const map<string, double>& hash);
+  // add an element, with its own name
+  void append(NamedList&& elt);
+
+  // the lists with at least INDEX_MIN_SIZE elements maintain a hash index of the names for fetch()
+  static constexpr size_t INDEX_MIN_SIZE = 16;
+  bool is_indexed() const { return bool(_index); }
 
 public: //
 
-  // N.B: not optimized: check all names and return the first found...
+  // return the first element with that name, cf find_first_idx()
   // if not found throw runtime_error
   // const shared_ptr<NamedList> fetch(const string& name) const;
   const NamedList& fetch(const string& name) const;
@@ -148,8 +158,9 @@ public: //
 
   bool operator==(const NamedList& l) const;
 
+  // N.B: single-pass, the nested lists are parsed iteratively
   static NamedList parse(istream& in);
-  static NamedList parse(const string& content);
+  static NamedList parse(string_view content);
 
   friend ostream& operator<<(ostream& out, const NamedList& list) {
       list.print(out);
@@ -162,15 +173,17 @@ public: //
   string to_string() const;
 
 protected:
-  void add(const NamedList& elt) {
-      assert(is_list());
-      _children.push_back(elt);
-  } 
+  void add(const NamedList& elt) { append(NamedList(elt)); }
+
+  void buildIndex();
 
 private:
     string _name;
     Scalar _value;
     vector<NamedList> _children;
+    // name -> index of the first child with that name, cf INDEX_MIN_SIZE
+    // N.B: shared by the copies, and copied on write by append()
+    shared_ptr<unordered_map<string, int>> _index;
 };
 
   const string NA_INT_STRING = "NA";
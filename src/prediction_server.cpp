@@ -0,0 +1,435 @@
+#include "prediction_server.h"
+#include <sstream>
+#include <algorithm>
+#include <list>
+#include <cstring>
+
+#include "fuzzy_coco.h"
+#include "csv_loader.h"
+#include "file_utils.h"
+#include "thread_pool.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define FUZZY_COCO_UNIX_SOCKET 1
+#include <cerrno>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+#endif
+
+using namespace fuzzy_coco;
+
+PredictionServer::PredictionServer(const Options& options)
+  : _options(options), _start_time(Clock::now())
+{
+  assert(_options.max_batch_rows > 0);
+  const int nb_workers = _options.nb_workers > 0 ? _options.nb_workers : ThreadPool::hardware_concurrency();
+  _latencies.reserve(LATENCY_WINDOW);
+  _workers.reserve(nb_workers);
+  for (int i = 0; i < nb_workers; i++)
+    _workers.emplace_back([this] { work(); });
+}
+
+PredictionServer::~PredictionServer() {
+  {
+    lock_guard<mutex> lock(_queue_mutex);
+    _stopping = true;
+  }
+  _queue_cv.notify_all();
+  for (auto& worker : _workers)
+    worker.join();
+}
+
+shared_ptr<const FuzzySystem> PredictionServer::getFuzzySystem(const string& fuzzy_file) {
+  const auto mtime = filesystem::last_write_time(fuzzy_file);
+  {
+    lock_guard<mutex> lock(_models_mutex);
+    auto it = _models.find(fuzzy_file);
+    if (it != _models.end() && it->second.mtime == mtime) return it->second.fs;
+  }
+  // N.B: loaded outside the lock, so that the other models stay available
+  auto fs = make_shared<const FuzzySystem>(FuzzyCoco::loadFuzzySystem(fuzzy_file));
+  lock_guard<mutex> lock(_models_mutex);
+  _models[fuzzy_file] = {fs, mtime};
+  return fs;
+}
+
+int PredictionServer::getNbCachedFuzzySystems() const {
+  lock_guard<mutex> lock(_models_mutex);
+  return _models.size();
+}
+
+DataFrame PredictionServer::predict(const string& fuzzy_file, const DataFrame& df) {
+  const auto start = Clock::now();
+  auto fs = getFuzzySystem(fuzzy_file);
+
+  // N.B: the requests of a micro-batch must have the same columns, cf FuzzySystem::smartPredict()
+  const auto& db = fs->getDB();
+  vector<string> input_names(db.getNbInputVars());
+  for (int i = 0; i < db.getNbInputVars(); i++)
+    input_names[i] = db.getInputVariable(i).getName();
+  const DataFrame dfin = df.subsetColumns(input_names);
+
+  PendingRequest request{fs, &dfin, {}};
+  auto result = request.result.get_future();
+  {
+    lock_guard<mutex> lock(_queue_mutex);
+    _queue.push_back(&request);
+  }
+  _queue_cv.notify_one();
+
+  DataFrame predicted = result.get();
+  recordRequest(df.nbrows(), start);
+  return predicted;
+}
+
+void PredictionServer::work() {
+  WorkerSystems systems;
+  vector<PendingRequest*> batch;
+  while (true) {
+    batch.clear();
+    {
+      unique_lock<mutex> lock(_queue_mutex);
+      _queue_cv.wait(lock, [this] { return _stopping || !_queue.empty(); });
+      if (_queue.empty()) return;
+
+      // coalesce the pending requests for the same fuzzy system, in order
+      auto fs = _queue.front()->fs;
+      int nb_rows = 0;
+      for (auto it = _queue.begin(); it != _queue.end(); ) {
+        const int nb = (*it)->dfin->nbrows();
+        if ((*it)->fs == fs && (batch.empty() || nb_rows + nb <= _options.max_batch_rows)) {
+          batch.push_back(*it);
+          nb_rows += nb;
+          it = _queue.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+    processBatch(batch, systems);
+  }
+}
+
+// stack the input values of the batch requests
+static DataFrame stack_rows(const vector<const DataFrame*>& dfs) {
+  int nb_rows = 0;
+  for (auto df : dfs) nb_rows += df->nbrows();
+  const int nb_cols = dfs.front()->nbcols();
+  DataFrame stacked(nb_rows, nb_cols);
+  stacked.colnames(dfs.front()->colnames());
+  int offset = 0;
+  for (auto df : dfs) {
+    for (int col = 0; col < nb_cols; col++)
+      for (int row = 0; row < df->nbrows(); row++)
+        stacked.set(offset + row, col, df->at(row, col));
+    offset += df->nbrows();
+  }
+  return stacked;
+}
+
+static DataFrame slice_rows(const DataFrame& df, int first_row, int nb_rows) {
+  DataFrame slice(nb_rows, df.nbcols());
+  slice.colnames(df.colnames());
+  for (int col = 0; col < df.nbcols(); col++)
+    for (int row = 0; row < nb_rows; row++)
+      slice.set(row, col, df.at(first_row + row, col));
+  return slice;
+}
+
+void PredictionServer::processBatch(vector<PendingRequest*>& batch, WorkerSystems& systems) {
+  const auto& model = batch.front()->fs;
+  // forget the copies of the models that are no longer cached nor used
+  for (auto it = systems.begin(); it != systems.end(); )
+    it = it->first.use_count() == 1 ? systems.erase(it) : next(it);
+  auto it = systems.find(model);
+  if (it == systems.end()) it = systems.emplace(model, *model).first;
+  FuzzySystem& fs = it->second;
+
+  vector<DataFrame> results;
+  try {
+    if (batch.size() == 1) {
+      results.push_back(fs.predict(*batch.front()->dfin));
+    } else {
+      vector<const DataFrame*> dfs;
+      for (auto request : batch) dfs.push_back(request->dfin);
+      const DataFrame predicted = fs.predict(stack_rows(dfs));
+      int offset = 0;
+      for (auto df : dfs) {
+        results.push_back(slice_rows(predicted, offset, df->nbrows()));
+        offset += df->nbrows();
+      }
+    }
+  } catch (...) {
+    for (auto request : batch)
+      request->result.set_exception(current_exception());
+    return;
+  }
+
+  {
+    lock_guard<mutex> lock(_stats_mutex);
+    _nb_batches++;
+  }
+  for (size_t i = 0; i < batch.size(); i++)
+    batch[i]->result.set_value(std::move(results[i]));
+}
+
+void PredictionServer::recordRequest(int nb_rows, Clock::time_point start) {
+  const double latency = chrono::duration<double, micro>(Clock::now() - start).count();
+  lock_guard<mutex> lock(_stats_mutex);
+  _nb_requests++;
+  _nb_rows += nb_rows;
+  if (int(_latencies.size()) < LATENCY_WINDOW) {
+    _latencies.push_back(latency);
+  } else {
+    _latencies[_latency_idx] = latency;
+    _latency_idx = (_latency_idx + 1) % LATENCY_WINDOW;
+  }
+}
+
+// q-quantile of the latencies, in milliseconds
+static double latency_quantile(vector<double> latencies, double q) {
+  if (latencies.empty()) return MISSING_DATA_DOUBLE;
+  const size_t idx = min(latencies.size() - 1, size_t(q * latencies.size()));
+  nth_element(latencies.begin(), latencies.begin() + idx, latencies.end());
+  return latencies[idx] / 1000;
+}
+
+NamedList PredictionServer::stats() const {
+  const int nb_models = getNbCachedFuzzySystems();
+  lock_guard<mutex> lock(_stats_mutex);
+  const double uptime = chrono::duration<double>(Clock::now() - _start_time).count();
+
+  NamedList desc;
+  desc.add("nb_requests", int(_nb_requests));
+  // N.B: as a double, may exceed the int range on a long-running server
+  desc.add("nb_rows", double(_nb_rows));
+  desc.add("nb_batches", int(_nb_batches));
+  desc.add("nb_errors", int(_nb_errors));
+  desc.add("nb_fuzzy_systems", nb_models);
+  desc.add("uptime_s", uptime);
+  desc.add("requests_per_s", uptime > 0 ? _nb_requests / uptime : 0.0);
+  desc.add("rows_per_s", uptime > 0 ? _nb_rows / uptime : 0.0);
+  desc.add("latency_p50_ms", latency_quantile(_latencies, 0.5));
+  desc.add("latency_p99_ms", latency_quantile(_latencies, 0.99));
+  desc.add("latency_max_ms", latency_quantile(_latencies, 1));
+  return desc;
+}
+
+static void write_response(ostream& out, const string& content) {
+  out << "OK " << count(content.begin(), content.end(), '\n') << '\n' << content;
+  out.flush();
+}
+
+bool PredictionServer::handleRequest(const string& line, istream& in, ostream& out) {
+  istringstream request(line);
+  string command;
+  request >> command;
+  if (command.empty()) return true;
+
+  // the rest of the line
+  auto read_argument = [&]() {
+    string arg;
+    getline(request >> ws, arg);
+    if (arg.empty()) THROW_WITH_LOCATION("missing argument for " + command);
+    return arg;
+  };
+
+  try {
+    if (command == "PREDICT") {
+      long nb_rows = -1;
+      request >> nb_rows;
+      if (!request || nb_rows < 0) THROW_WITH_LOCATION("bad number of rows for PREDICT");
+      const string fuzzy_file = read_argument();
+
+      // N.B: consume the whole request before parsing it, to stay in sync in case of error
+      string header_line, rows, row;
+      if (!getline(in, header_line)) THROW_WITH_LOCATION("missing header for PREDICT");
+      for (long i = 0; i < nb_rows; i++) {
+        if (!getline(in, row)) THROW_WITH_LOCATION("missing rows for PREDICT");
+        rows += row;
+        rows += '\n';
+      }
+      vector<string_view> tokens;
+      CsvLoader::splitLine(header_line, ';', tokens);
+      const DataFrame df = CsvLoader::parseRows(rows, vector<string>(tokens.begin(), tokens.end()), true);
+
+      ostringstream csv;
+      FileUtils::writeCSV(csv, predict(fuzzy_file, df));
+      write_response(out, csv.str());
+    } else if (command == "LOAD") {
+      getFuzzySystem(read_argument());
+      write_response(out, "");
+    } else if (command == "STATS") {
+      write_response(out, stats().to_string());
+    } else if (command == "QUIT") {
+      write_response(out, "");
+      return false;
+    } else {
+      THROW_WITH_LOCATION("unknown command: " + command);
+    }
+  } catch (exception& e) {
+    {
+      lock_guard<mutex> lock(_stats_mutex);
+      _nb_errors++;
+    }
+    // N.B: the response must be a single line
+    string message = e.what();
+    replace(message.begin(), message.end(), '\n', ' ');
+    out << "ERROR " << message << '\n';
+    out.flush();
+  }
+  return true;
+}
+
+void PredictionServer::serve(istream& in, ostream& out) {
+  string line;
+  while (getline(in, line)) {
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    if (!handleRequest(line, in, out)) break;
+  }
+  out.flush();
+}
+
+#ifdef FUZZY_COCO_UNIX_SOCKET
+
+namespace {
+  // a minimal buffered streambuf on a socket
+  class SocketStreamBuf : public streambuf {
+  public:
+    SocketStreamBuf(int fd) : _fd(fd) {
+      setg(_in, _in, _in);
+      setp(_out, _out + sizeof(_out));
+    }
+    ~SocketStreamBuf() { sync(); }
+
+  protected:
+    int_type underflow() override {
+      ssize_t nb;
+      do { nb = ::read(_fd, _in, sizeof(_in)); } while (nb < 0 && errno == EINTR);
+      if (nb <= 0) return traits_type::eof();
+      setg(_in, _in, _in + nb);
+      return traits_type::to_int_type(_in[0]);
+    }
+
+    int_type overflow(int_type ch) override {
+      if (sync() != 0) return traits_type::eof();
+      if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+      }
+      return traits_type::not_eof(ch);
+    }
+
+    int sync() override {
+      const char* p = pbase();
+      while (p < pptr()) {
+        const ssize_t nb = ::send(_fd, p, pptr() - p, MSG_NOSIGNAL);
+        if (nb < 0 && errno == EINTR) continue;
+        if (nb <= 0) return -1;
+        p += nb;
+      }
+      setp(_out, _out + sizeof(_out));
+      return 0;
+    }
+
+  private:
+    int _fd;
+    char _in[65536];
+    char _out[65536];
+  };
+}
+
+void PredictionServer::serveUnixSocket(const string& socket_path) {
+  sockaddr_un addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (socket_path.size() >= sizeof(addr.sun_path))
+    THROW_WITH_LOCATION("socket path too long: " + socket_path);
+  strcpy(addr.sun_path, socket_path.c_str());
+
+  const int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listen_fd < 0) THROW_WITH_LOCATION(string("socket() failed: ") + strerror(errno));
+  ::unlink(socket_path.c_str());
+  if (::bind(listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(listen_fd, 64) != 0) {
+    const string error = strerror(errno);
+    ::close(listen_fd);
+    THROW_WITH_LOCATION("unable to listen on " + socket_path + ": " + error);
+  }
+
+  // N.B: a list, since the connection threads keep a reference to their done flag
+  struct Connection {
+    atomic<bool> done{false};
+    thread worker;
+  };
+  list<Connection> connections;
+  // join the finished connections, so that a long-running server does not accumulate their threads
+  auto reap = [&] {
+    for (auto it = connections.begin(); it != connections.end(); ) {
+      if (it->done) {
+        it->worker.join();
+        it = connections.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    _nb_connection_threads = connections.size();
+  };
+
+  // N.B: poll() with a timeout, to check for stop()
+  while (!_stop_requested) {
+    reap();
+    pollfd pfd{listen_fd, POLLIN, 0};
+    if (poll(&pfd, 1, 100) <= 0) continue;
+    const int fd = ::accept(listen_fd, nullptr, nullptr);
+    if (fd < 0) continue;
+    {
+      lock_guard<mutex> lock(_connections_mutex);
+      _connections.insert(fd);
+    }
+    auto& connection = connections.emplace_back();
+    connection.worker = thread([this, fd, &connection] {
+      {
+        SocketStreamBuf buf(fd);
+        istream in(&buf);
+        ostream out(&buf);
+        serve(in, out);
+      }
+      {
+        lock_guard<mutex> lock(_connections_mutex);
+        _connections.erase(fd);
+        ::close(fd);
+      }
+      connection.done = true;
+    });
+    _nb_connection_threads = connections.size();
+  }
+
+  // unblock the connections waiting for a request
+  {
+    lock_guard<mutex> lock(_connections_mutex);
+    for (int fd : _connections) ::shutdown(fd, SHUT_RD);
+  }
+  for (auto& connection : connections)
+    connection.worker.join();
+  _nb_connection_threads = 0;
+  ::close(listen_fd);
+  ::unlink(socket_path.c_str());
+  _stop_requested = false;
+}
+
+#else
+
+void PredictionServer::serveUnixSocket(const string& socket_path) {
+  THROW_WITH_LOCATION("Unix sockets are not supported on this platform: " + socket_path);
+}
+
+#endif
+
+void PredictionServer::stop() {
+  _stop_requested = true;
+}
@@ -0,0 +1,132 @@
+#ifndef PREDICTION_SERVER_H
+#define PREDICTION_SERVER_H
+
+#include <string>
+#include <map>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <future>
+#include <chrono>
+#include <atomic>
+#include <set>
+#include <filesystem>
+#include <iostream>
+#include "fuzzy_system.h"
+#include "named_list.h"
+
+namespace fuzzy_coco {
+
+using namespace std;
+
+// a long-running prediction server: the fuzzy systems are loaded once and kept in memory, and the
+// concurrent requests are coalesced into micro-batches.
+//
+// The protocol is line-based, on a stream (e.g. stdin/stdout, cf serve()) or on a Unix socket (cf serveUnixSocket()):
+//   - PREDICT <nb_rows> <fuzzy_file>: followed by a CSV header line and nb_rows CSV lines, as for --predict
+//     (i.e. the first column is the row names). The response is the CSV of the predictions, with a header
+//   - LOAD <fuzzy_file>: (re)load a fuzzy system in the cache
+//   - STATS: the counters, cf stats()
+//   - QUIT: close the connection
+// Each response starts with a line "OK <nb_lines>" followed by nb_lines lines, or is a single line "ERROR <message>".
+// The fuzzy files (JSON or binary, cf FuzzyCoco::loadFuzzySystem()) are cached by path, and reloaded when modified.
+class PredictionServer
+{
+public:
+  struct Options {
+    // the maximum number of rows of a micro-batch
+    int max_batch_rows = 65536;
+    // the number of threads that predict the micro-batches
+    int nb_workers = 1;
+  };
+
+  PredictionServer(const Options& options);
+  PredictionServer() : PredictionServer(Options()) {}
+  // N.B: waits for the pending predictions
+  ~PredictionServer();
+  PredictionServer(const PredictionServer&) = delete;
+  PredictionServer& operator=(const PredictionServer&) = delete;
+
+  // the cached fuzzy system. N.B: loaded if not cached, or if the file has been modified since
+  shared_ptr<const FuzzySystem> getFuzzySystem(const string& fuzzy_file);
+  int getNbCachedFuzzySystems() const;
+
+  // predict df: blocks until the micro-batch that contains df has been predicted.
+  // N.B: thread-safe, this is where the concurrent requests are coalesced
+  DataFrame predict(const string& fuzzy_file, const DataFrame& df);
+
+  // process the requests from in until QUIT or the end of the stream, and write the responses to out
+  void serve(istream& in, ostream& out);
+  // listen on a Unix socket, and serve each connection in its own thread until stop() is called
+  // N.B: throws a runtime_error if not supported on this platform
+  void serveUnixSocket(const string& socket_path);
+  // stop serveUnixSocket()
+  void stop();
+  // the number of connection threads of serveUnixSocket() not yet joined.
+  // N.B: the finished ones are joined by the accept loop, i.e. within its poll timeout
+  int getNbConnectionThreads() const { return _nb_connection_threads; }
+
+  // the counters: number of requests, rows and batches, throughput and latency quantiles
+  NamedList stats() const;
+
+private:
+  using Clock = chrono::steady_clock;
+
+  struct Model {
+    shared_ptr<const FuzzySystem> fs;
+    filesystem::file_time_type mtime;
+  };
+
+  struct PendingRequest {
+    shared_ptr<const FuzzySystem> fs;
+    // the input values, restricted to the input variables of fs
+    const DataFrame* dfin;
+    promise<DataFrame> result;
+  };
+
+  // N.B: predicting uses the fuzzy system state --> each worker predicts with its own copies of the models
+  using WorkerSystems = map<shared_ptr<const FuzzySystem>, FuzzySystem>;
+  void work();
+  void processBatch(vector<PendingRequest*>& batch, WorkerSystems& systems);
+  // handle a request line, returns false on QUIT
+  bool handleRequest(const string& line, istream& in, ostream& out);
+  void recordRequest(int nb_rows, Clock::time_point start);
+
+private:
+  Options _options;
+  Clock::time_point _start_time;
+
+  // the fuzzy systems cache
+  mutable mutex _models_mutex;
+  map<string, Model> _models;
+
+  // the micro-batches queue
+  mutex _queue_mutex;
+  condition_variable _queue_cv;
+  deque<PendingRequest*> _queue;
+  bool _stopping = false;
+  vector<thread> _workers;
+
+  // the counters
+  mutable mutex _stats_mutex;
+  long _nb_requests = 0;
+  long _nb_rows = 0;
+  long _nb_batches = 0;
+  long _nb_errors = 0;
+  // the latencies in microseconds of the last LATENCY_WINDOW requests, as a ring buffer
+  static constexpr int LATENCY_WINDOW = 10000;
+  vector<double> _latencies;
+  int _latency_idx = 0;
+
+  // the Unix socket connections
+  atomic<bool> _stop_requested{false};
+  mutex _connections_mutex;
+  set<int> _connections;
+  atomic<int> _nb_connection_threads{0};
+};
+
+}
+#endif // PREDICTION_SERVER_H
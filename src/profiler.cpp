@@ -0,0 +1,100 @@
+#include "profiler.h"
+#include <atomic>
+
+using namespace fuzzy_coco;
+
+namespace {
+  struct AtomicStats {
+    atomic<long> nb_calls{0};
+    atomic<uint64_t> total_ns{0};
+    atomic<uint64_t> max_ns{0};
+  };
+
+  using Clock = chrono::steady_clock;
+
+  atomic<bool> ENABLED{false};
+  AtomicStats STATS[Profiler::NB_PHASES];
+  // N.B: only modified by enable(), cf describe()
+  Clock::time_point START_TIME = Clock::now();
+  Clock::time_point STOP_TIME = START_TIME;
+}
+
+const char* Profiler::phaseName(Phase phase) {
+  switch (phase) {
+    case EVALUATION: return "evaluation";
+    case DECODE: return "decode";
+    case FIRE_LEVELS: return "fire_levels";
+    case IMPLICATION: return "implication";
+    case DEFUZZIFICATION: return "defuzzification";
+    case METRICS: return "metrics";
+    case SELECTION: return "selection";
+    case CROSSOVER: return "crossover";
+    case MUTATION: return "mutation";
+    default: return "unknown";
+  }
+}
+
+void Profiler::enable(bool on) {
+  if (on) {
+    reset();
+    START_TIME = Clock::now();
+  } else if (enabled()) {
+    STOP_TIME = Clock::now();
+  }
+  ENABLED.store(on, memory_order_relaxed);
+}
+
+bool Profiler::enabled() { return ENABLED.load(memory_order_relaxed); }
+
+void Profiler::reset() {
+  for (auto& stats : STATS) {
+    stats.nb_calls = 0;
+    stats.total_ns = 0;
+    stats.max_ns = 0;
+  }
+}
+
+void Profiler::record(Phase phase, uint64_t ns) {
+  auto& stats = STATS[phase];
+  stats.nb_calls.fetch_add(1, memory_order_relaxed);
+  stats.total_ns.fetch_add(ns, memory_order_relaxed);
+  uint64_t max_ns = stats.max_ns.load(memory_order_relaxed);
+  while (ns > max_ns && !stats.max_ns.compare_exchange_weak(max_ns, ns, memory_order_relaxed)) {}
+}
+
+Profiler::Stats Profiler::getStats(Phase phase) {
+  const auto& stats = STATS[phase];
+  Stats res;
+  res.nb_calls = stats.nb_calls.load(memory_order_relaxed);
+  res.total_ns = stats.total_ns.load(memory_order_relaxed);
+  res.max_ns = stats.max_ns.load(memory_order_relaxed);
+  return res;
+}
+
+NamedList Profiler::describe() {
+  const double elapsed = chrono::duration<double>((enabled() ? Clock::now() : STOP_TIME) - START_TIME).count();
+  const auto evaluations = getStats(EVALUATION);
+
+  NamedList desc;
+  desc.add("compiled", available());
+  desc.add("elapsed_s", elapsed);
+  // N.B: as doubles, since they may exceed the int range on long runs
+  desc.add("nb_evaluations", double(evaluations.nb_calls));
+  desc.add("evaluations_per_s", elapsed > 0 ? evaluations.nb_calls / elapsed : 0.0);
+
+  NamedList phases;
+  for (int i = 0; i < NB_PHASES; i++) {
+    const Phase phase = Phase(i);
+    const auto stats = getStats(phase);
+    NamedList lst;
+    lst.add("nb_calls", double(stats.nb_calls));
+    lst.add("total_ns", double(stats.total_ns));
+    lst.add("max_ns", double(stats.max_ns));
+    lst.add("mean_ns", stats.nb_calls > 0 ? double(stats.total_ns) / stats.nb_calls : 0.0);
+    lst.add("calls_per_s", stats.total_ns > 0 ? stats.nb_calls * 1e9 / stats.total_ns : 0.0);
+    phases.add(phaseName(phase), lst);
+  }
+  desc.add("phases", phases);
+
+  return desc;
+}
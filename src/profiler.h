@@ -0,0 +1,94 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <cstdint>
+#include <chrono>
+#include "named_list.h"
+
+namespace fuzzy_coco {
+
+using namespace std;
+
+// a lightweight built-in profiler of the hot phases of a fit: for each phase, the number of calls, the total and
+// maximum durations, recorded by scoped timers (cf PROFILE_PHASE) that are thread-safe.
+// The timers are compiled out unless FUZZYCOCO_PROFILE is defined (cf the FUZZYCOCO_PROFILE cmake option), and are
+// inactive (i.e. an atomic load) until the profiler is enabled, cf enable()
+// N.B: with several threads the durations of the phases are summed over the threads, so they may exceed the elapsed time
+namespace Profiler {
+
+  enum Phase {
+    // a (non-cached) fitness evaluation of a (rules, MFs) pair, including all the phases below except the evolution ones
+    EVALUATION,
+    // the decoding of the rules and MFs genomes into the fuzzy system, cf FuzzyCocoCodec::setRulesGenome()
+    DECODE,
+    FIRE_LEVELS,
+    // the rules and default rules implications
+    IMPLICATION,
+    // N.B: in a fit, the metrics are accumulated during the defuzzification, so they are included
+    DEFUZZIFICATION,
+    // the final metrics of a fit (averaging, number of used variables), or the metrics of a prediction
+    METRICS,
+    SELECTION,
+    CROSSOVER,
+    MUTATION,
+    NB_PHASES
+  };
+
+  const char* phaseName(Phase phase);
+
+  struct Stats {
+    long nb_calls = 0;
+    uint64_t total_ns = 0;
+    uint64_t max_ns = 0;
+  };
+
+  // whether the timers were compiled in
+  constexpr bool available() {
+#ifdef FUZZYCOCO_PROFILE
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  // N.B: enabling resets the stats and the elapsed time
+  void enable(bool on = true);
+  bool enabled();
+  void reset();
+
+  void record(Phase phase, uint64_t ns);
+  Stats getStats(Phase phase);
+
+  // the report: the elapsed time since enable() (until it was disabled), the number of evaluations and their throughput,
+  // and for each phase its stats, its mean duration and its throughput (calls per second of the phase)
+  NamedList describe();
+
+  class ScopedTimer {
+  public:
+    explicit ScopedTimer(Phase phase) : _phase(phase), _active(enabled()) {
+      if (_active) _start = Clock::now();
+    }
+    ~ScopedTimer() {
+      if (_active) record(_phase, chrono::duration_cast<chrono::nanoseconds>(Clock::now() - _start).count());
+    }
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+  private:
+    using Clock = chrono::steady_clock;
+    Phase _phase;
+    bool _active;
+    Clock::time_point _start;
+  };
+}
+
+}
+
+// time the rest of the enclosing scope as the Profiler::Phase phase
+#ifdef FUZZYCOCO_PROFILE
+#define PROFILE_PHASE(phase) fuzzy_coco::Profiler::ScopedTimer profiler_scoped_timer(fuzzy_coco::Profiler::phase)
+#else
+#define PROFILE_PHASE(phase)
+#endif
+
+#endif // PROFILER_H
@@ -5,6 +5,9 @@
 #include <random>
 #include <cassert>
 #include <cstring>
+#include <string>
+#include <sstream>
+#include <stdexcept>
 
 namespace fuzzy_coco {
 
@@ -78,6 +81,21 @@ public:
     return res;
   }
 
+  // the full state of the generator, e.g. to checkpoint and resume a run (cf Checkpoint)
+  string getState() const {
+    ostringstream out;
+    out << _rng;
+    return out.str();
+  }
+
+  // N.B: throws a runtime_error on a bad state
+  void setState(const string& state) {
+    istringstream in(state);
+    mt19937 rng;
+    if (!(in >> rng)) throw runtime_error("bad random generator state");
+    _rng = rng;
+  }
+
 private:
   mt19937 _rng;
 
@@ -0,0 +1,50 @@
+#include "stopping_criteria.h"
+
+using namespace fuzzy_coco;
+
+string fuzzy_coco::toString(StopReason reason) {
+  switch (reason) {
+    case StopReason::MAX_GENERATIONS: return "max_generations";
+    case StopReason::MAX_FITNESS: return "max_fitness";
+    case StopReason::MAX_SECONDS: return "max_seconds";
+    case StopReason::MAX_EVALUATIONS: return "max_evaluations";
+    case StopReason::STAGNATION: return "stagnation";
+    default: return "none";
+  }
+}
+
+StoppingCriteria::StoppingCriteria(const GlobalParams& params)
+  : _max_generations(params.max_generations),
+    _max_fitness(params.max_fitness),
+    _max_seconds(params.max_seconds),
+    _max_evaluations(params.max_evaluations),
+    _stagnation_generations(params.stagnation_generations),
+    _start_time(Clock::now())
+{}
+
+void StoppingCriteria::start(int generation_number, double best_fitness, double elapsed_seconds) {
+  _start_time = Clock::now();
+  _elapsed_seconds = elapsed_seconds;
+  _best_fitness = best_fitness;
+  _last_improvement = generation_number;
+}
+
+double StoppingCriteria::getElapsedSeconds() const {
+  return _elapsed_seconds + chrono::duration<double>(Clock::now() - _start_time).count();
+}
+
+StopReason StoppingCriteria::check(int generation_number, double fitness, double best_fitness, double nb_evaluations) {
+  if (best_fitness > _best_fitness) {
+    _best_fitness = best_fitness;
+    _last_improvement = generation_number;
+  }
+
+  // N.B: the fitness first, so that an evolution that reaches max_fitness is reported as such
+  if (fitness >= _max_fitness) return StopReason::MAX_FITNESS;
+  if (generation_number >= _max_generations) return StopReason::MAX_GENERATIONS;
+  if (_max_evaluations > 0 && nb_evaluations >= _max_evaluations) return StopReason::MAX_EVALUATIONS;
+  if (_stagnation_generations > 0 && generation_number - _last_improvement >= _stagnation_generations)
+    return StopReason::STAGNATION;
+  if (isTimeExceeded()) return StopReason::MAX_SECONDS;
+  return StopReason::NONE;
+}
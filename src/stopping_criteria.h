@@ -0,0 +1,57 @@
+#ifndef STOPPING_CRITERIA_H
+#define STOPPING_CRITERIA_H
+
+#include <string>
+#include <chrono>
+#include <limits>
+#include "fuzzy_coco_params.h"
+
+namespace fuzzy_coco {
+
+using namespace std;
+
+// why an evolution stopped. NONE means that it should continue
+enum class StopReason { NONE, MAX_GENERATIONS, MAX_FITNESS, MAX_SECONDS, MAX_EVALUATIONS, STAGNATION };
+
+// the name of the reason, i.e. of the param that stopped the evolution, "stagnation" for the stagnation_generations
+string toString(StopReason reason);
+
+// the stopping criteria of an evolution, cf the GlobalParams max_generations, max_fitness, max_seconds,
+// max_evaluations and stagnation_generations. They are checked after each generation
+// N.B: the stagnation is computed from the best fitness so far, so the criteria have a state, cf start()
+class StoppingCriteria
+{
+public:
+  StoppingCriteria(const GlobalParams& params);
+
+  // (re)start the evolution at generation generation_number, with the current best fitness, and the
+  // time already spent (e.g. when resumed from a checkpoint)
+  void start(int generation_number, double best_fitness, double elapsed_seconds = 0);
+
+  // the reason to stop after the generation generation_number, or NONE
+  StopReason check(int generation_number, double fitness, double best_fitness, double nb_evaluations);
+
+  // the number of seconds elapsed since the start, including the elapsed_seconds given to start()
+  double getElapsedSeconds() const;
+  bool isTimeExceeded() const { return _max_seconds > 0 && getElapsedSeconds() >= _max_seconds; }
+
+  // the generation number of the last improvement of the best fitness
+  int getLastImprovement() const { return _last_improvement; }
+
+private:
+  using Clock = chrono::steady_clock;
+
+  int _max_generations;
+  double _max_fitness;
+  double _max_seconds;
+  double _max_evaluations;
+  int _stagnation_generations;
+
+  Clock::time_point _start_time;
+  double _elapsed_seconds = 0;
+  double _best_fitness = numeric_limits<double>::lowest();
+  int _last_improvement = 0;
+};
+
+}
+#endif // STOPPING_CRITERIA_H
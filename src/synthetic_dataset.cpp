@@ -0,0 +1,142 @@
+#include "synthetic_dataset.h"
+#include <fstream>
+#include <charconv>
+#include <cmath>
+#include <algorithm>
+
+#include "random_generator.h"
+#include "file_utils.h"
+
+using namespace fuzzy_coco;
+
+void SyntheticDataset::Options::check() const {
+  if (nb_rows < 1) throw runtime_error("SyntheticDataset: the number of rows must be >= 1");
+  if (nb_vars < 1) throw runtime_error("SyntheticDataset: the number of variables must be >= 1");
+  if (nb_informative < 0) throw runtime_error("SyntheticDataset: the number of informative variables must be >= 0");
+  if (!(na_rate >= 0 && na_rate < 1)) throw runtime_error("SyntheticDataset: the NA rate must be in [0, 1[");
+  if (!(class_balance >= 0 && class_balance <= 1))
+    throw runtime_error("SyntheticDataset: the class balance must be in [0, 1]");
+}
+
+string SyntheticDataset::Options::filename(const string& ext) const {
+  string name = "synthetic_" + to_string(nb_rows) + "x" + to_string(nb_vars);
+  if (regression)
+    name += "_reg";
+  else if (class_balance != 0.5)
+    name += "_b" + to_string(int(lround(class_balance * 100)));
+  if (na_rate > 0) name += "_na" + to_string(int(lround(na_rate * 100)));
+  return name + "_s" + to_string(seed) + ext;
+}
+
+vector<string> SyntheticDataset::colnames(const Options& options) {
+  vector<string> names;
+  names.reserve(options.nb_vars + 1);
+  for (int j = 0; j < options.nb_vars; j++)
+    names.push_back("x" + to_string(j + 1));
+  names.push_back("y");
+  return names;
+}
+
+namespace {
+  double round2(double value) { return round(value * 100) / 100; }
+
+  // generates the rows one by one, cf SyntheticDataset
+  class RowGenerator {
+  public:
+    RowGenerator(const SyntheticDataset::Options& options)
+      : _options(options), _nb_informative(min(options.nb_informative, options.nb_vars)), _rng(options.seed)
+    {
+      options.check();
+    }
+
+    // row: the nb_vars input values followed by the output value
+    void next(vector<double>& row) {
+      const int nb_vars = _options.nb_vars;
+      row.resize(nb_vars + 1);
+      int label = 0;
+      if (!_options.regression)
+        label = _rng.randomReal(0, 1) < _options.class_balance ? 1 : 0;
+
+      double sum = 0;
+      for (int j = 0; j < nb_vars; j++) {
+        double value;
+        if (j < _nb_informative && !_options.regression)
+          value = label ? _rng.randomReal(40, 100) : _rng.randomReal(0, 60);
+        else
+          value = _rng.randomReal(0, 100);
+        value = round2(value);
+        if (j < _nb_informative) sum += value;
+        // N.B: the NA are only drawn when needed, so that the values do not depend on na_rate when it is 0
+        if (_options.na_rate > 0 && _rng.randomReal(0, 1) < _options.na_rate)
+          value = MISSING_DATA_DOUBLE;
+        row[j] = value;
+      }
+
+      if (_options.regression) {
+        const double mean = _nb_informative > 0 ? sum / _nb_informative : 50;
+        row[nb_vars] = round2(mean + _rng.randomReal(-5, 5));
+      } else
+        row[nb_vars] = label;
+    }
+
+  private:
+    const SyntheticDataset::Options& _options;
+    const int _nb_informative;
+    RandomGenerator _rng;
+  };
+}
+
+void SyntheticDataset::write(const Options& options, ostream& out) {
+  RowGenerator generator(options);
+
+  out << "id";
+  for (const auto& name : colnames(options))
+    out << ';' << name;
+  out << '\n';
+
+  vector<double> row;
+  string line;
+  char buffer[64];
+  for (int i = 0; i < options.nb_rows; i++) {
+    generator.next(row);
+    line = "row";
+    line += to_string(i + 1);
+    for (double value : row) {
+      line += ';';
+      if (is_na(value)) {
+        line += "NA";
+        continue;
+      }
+      auto [ptr, ec] = to_chars(buffer, buffer + sizeof(buffer), value, chars_format::fixed, 2);
+      line.append(buffer, ptr);
+    }
+    line += '\n';
+    out.write(line.data(), line.size());
+  }
+  if (!out) THROW_WITH_LOCATION("Error in SyntheticDataset::write(): write error");
+}
+
+void SyntheticDataset::write(const Options& options, const path& filename) {
+  FileUtils::mkdir_if_needed(filename);
+  ofstream out(filename);
+  if (!out.is_open())
+    throw filesystem_error("error opening file", filename, error_code());
+  write(options, out);
+}
+
+DataFrame SyntheticDataset::generate(const Options& options) {
+  RowGenerator generator(options);
+  DataFrame df(options.nb_rows, options.nb_vars + 1);
+  vector<double> row;
+  for (int i = 0; i < options.nb_rows; i++) {
+    generator.next(row);
+    df.fillRow(i, row);
+  }
+  df.colnames(colnames(options));
+  vector<string> rownames;
+  rownames.reserve(options.nb_rows);
+  for (int i = 0; i < options.nb_rows; i++)
+    rownames.push_back("row" + to_string(i + 1));
+  df.rownames(rownames);
+  return df;
+}
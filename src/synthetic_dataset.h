@@ -0,0 +1,54 @@
+#ifndef SYNTHETIC_DATASET_H
+#define SYNTHETIC_DATASET_H
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <filesystem>
+#include "dataframe.h"
+
+namespace fuzzy_coco {
+
+using namespace std;
+using namespace std::filesystem;
+
+// seeded synthetic datasets of arbitrary shapes, to test and benchmark the fits, cf the --generate option and
+// the fuzzycoco_scaling harness (tests/bench).
+// A dataset has rownames, nb_vars input variables and one output variable, the last column. Only the first
+// nb_informative input variables are related to the output, the others are noise, uniform in [0, 100]:
+//   - classification: the output is a class, 1 with probability class_balance, 0 otherwise. The informative
+//     variables are uniform in [0, 60] for the class 0, and in [40, 100] for the class 1
+//   - regression: the informative variables are uniform in [0, 100], the output is their mean plus a uniform noise
+//     in [-5, 5]
+// The missing values (NA) are only in the input variables, each value is missing with probability na_rate.
+// The values are rounded to 2 decimals, so that a written dataset loads exactly as the generated one
+namespace SyntheticDataset {
+
+  struct Options {
+    int nb_rows = 1000;
+    int nb_vars = 10;
+    // N.B: capped to nb_vars
+    int nb_informative = 3;
+    double na_rate = 0;
+    bool regression = false;
+    double class_balance = 0.5;
+    int seed = 123;
+
+    // throws a runtime_error if the options are not valid
+    void check() const;
+    // a file name that identifies the dataset, e.g. "synthetic_1000x10_s123.csv"
+    string filename(const string& ext = ".csv") const;
+  };
+
+  // the column names: "x1"..."xN" then "y"
+  vector<string> colnames(const Options& options);
+
+  // N.B: the rows are generated and written one by one, so a dataset of any size is written in constant memory
+  void write(const Options& options, ostream& out);
+  void write(const Options& options, const path& filename);
+
+  DataFrame generate(const Options& options);
+}
+
+}
+#endif // SYNTHETIC_DATASET_H
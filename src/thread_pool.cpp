@@ -0,0 +1,85 @@
+#include "thread_pool.h"
+
+using namespace fuzzy_coco;
+
+ThreadPool::ThreadPool(int nb_threads) : _nb_workers(max(nb_threads, 1))
+{
+  if (_nb_workers == 1) return;
+  _threads.reserve(_nb_workers);
+  for (int i = 0; i < _nb_workers; i++)
+    _threads.emplace_back(&ThreadPool::work, this, i);
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    lock_guard<mutex> lock(_mutex);
+    _stop = true;
+  }
+  _job_cv.notify_all();
+  for (auto& t : _threads) t.join();
+}
+
+int ThreadPool::hardware_concurrency() {
+  return max(int(thread::hardware_concurrency()), 1);
+}
+
+void ThreadPool::run(int nb_tasks, const function<void(int, int)>& task)
+{
+  if (nb_tasks <= 0) return;
+  if (_threads.empty()) {
+    for (int i = 0; i < nb_tasks; i++) task(i, 0);
+    return;
+  }
+
+  unique_lock<mutex> lock(_mutex);
+  _task = &task;
+  _nb_tasks = nb_tasks;
+  _next_task = 0;
+  _nb_busy = _nb_workers;
+  _error = nullptr;
+  _job_id++;
+  _job_cv.notify_all();
+
+  _done_cv.wait(lock, [this] { return _nb_busy == 0; });
+  _task = nullptr;
+  if (_error) rethrow_exception(_error);
+}
+
+void ThreadPool::work(int worker_idx)
+{
+  long last_job_id = 0;
+  while (true) {
+    {
+      unique_lock<mutex> lock(_mutex);
+      _job_cv.wait(lock, [&] { return _stop || _job_id != last_job_id; });
+      if (_stop) return;
+      last_job_id = _job_id;
+    }
+
+    process(worker_idx);
+
+    {
+      lock_guard<mutex> lock(_mutex);
+      if (--_nb_busy == 0) _done_cv.notify_one();
+    }
+  }
+}
+
+void ThreadPool::process(int worker_idx)
+{
+  while (true) {
+    int task_idx;
+    {
+      lock_guard<mutex> lock(_mutex);
+      if (_next_task >= _nb_tasks) return;
+      task_idx = _next_task++;
+    }
+    try {
+      (*_task)(task_idx, worker_idx);
+    } catch (...) {
+      lock_guard<mutex> lock(_mutex);
+      if (!_error) _error = current_exception();
+    }
+  }
+}
@@ -0,0 +1,61 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+
+namespace fuzzy_coco {
+
+using namespace std;
+
+// a minimal fixed-size pool of worker threads, to run a batch of indexed tasks in parallel
+// the tasks are dispatched dynamically to the workers, so the task -> worker mapping is NOT deterministic:
+// the tasks must only write their results in slots indexed by the task index
+class ThreadPool
+{
+public:
+  // N.B: nb_threads <= 1 --> no thread is created, the tasks are run in the calling thread
+  ThreadPool(int nb_threads);
+  ~ThreadPool();
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // the number of workers, i.e. the range of the worker_idx passed to the tasks
+  int size() const { return _nb_workers; }
+
+  // run task(task_idx, worker_idx) for all task_idx in [0, nb_tasks[, and wait for their completion
+  // N.B: if some tasks throw, the first exception is rethrown, after all tasks are done
+  void run(int nb_tasks, const function<void(int, int)>& task);
+
+  // the number of hardware threads, at least 1
+  static int hardware_concurrency();
+
+private:
+  void work(int worker_idx);
+  void process(int worker_idx);
+
+private:
+  int _nb_workers;
+  vector<thread> _threads;
+
+  mutex _mutex;
+  condition_variable _job_cv;
+  condition_variable _done_cv;
+  // incremented for each new batch of tasks
+  long _job_id = 0;
+  bool _stop = false;
+
+  // current batch
+  const function<void(int, int)>* _task = nullptr;
+  int _nb_tasks = 0;
+  int _next_task = 0;
+  int _nb_busy = 0;
+  exception_ptr _error;
+};
+
+}
+#endif // THREAD_POOL_H
@@ -0,0 +1,85 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <benchmark/benchmark.h>
+
+// utilities for the micro-benchmarks: synthetic seeded data and fuzzy systems of a given shape
+#include <string>
+#include <vector>
+#include <sstream>
+
+#include "fuzzy_coco.h"
+
+using namespace std;
+using namespace fuzzy_coco;
+
+constexpr int BENCH_SEED = 123;
+
+// a DataFrame of nb_samples x nb_vars uniform values in [0, 100], with a ratio of missing values
+inline DataFrame random_dataframe(int nb_samples, int nb_vars, RandomGenerator& rng, double missing_ratio = 0) {
+  DataFrame df(nb_samples, nb_vars);
+  vector<string> names;
+  for (int j = 0; j < nb_vars; j++) {
+    names.push_back("var" + to_string(j + 1));
+    vector<double> col(nb_samples);
+    for (auto& value : col)
+      value = rng.randomReal(0, 1) < missing_ratio ? MISSING_DATA_DOUBLE : rng.randomReal(0, 100);
+    df.fillCol(j, col);
+  }
+  df.colnames(names);
+  return df;
+}
+
+// the same values as a CSV (with a header and rownames), as parsed by FileUtils::parseCSV()
+inline string random_csv(int nb_samples, int nb_vars, RandomGenerator& rng) {
+  ostringstream out;
+  out << "id";
+  for (int j = 0; j < nb_vars; j++) out << ";var" << (j + 1);
+  out << "\n";
+  for (int i = 0; i < nb_samples; i++) {
+    out << "row" << (i + 1);
+    for (int j = 0; j < nb_vars; j++) out << ";" << rng.randomReal(0, 100);
+    out << "\n";
+  }
+  return out.str();
+}
+
+inline FuzzyCocoParams bench_params(int nb_in_vars, int nb_rules, int nb_sets) {
+  FuzzyCocoParams params;
+  params.global_params.nb_rules = nb_rules;
+  params.global_params.nb_max_var_per_rule = nb_in_vars;
+  params.input_vars_params.nb_sets = nb_sets;
+  params.output_vars_params.nb_sets = nb_sets;
+  params.input_vars_params.nb_bits_pos = 8;
+  params.output_vars_params.nb_bits_pos = 8;
+  params.fitness_params.output_vars_defuzz_thresholds.push_back(50);
+  params.rules_params.pop_size = 10;
+  params.mfs_params.pop_size = 10;
+  params.evaluate_missing(nb_in_vars, 1);
+  return params;
+}
+
+// a FuzzyCoco on a random dataset, whose fuzzy system is set from random (valid) genomes
+struct BenchFuzzyCoco {
+  BenchFuzzyCoco(int nb_samples, int nb_in_vars, int nb_rules, int nb_sets) 
+    : rng(BENCH_SEED),
+      dfin(random_dataframe(nb_samples, nb_in_vars, rng)),
+      dfout(random_dataframe(nb_samples, 1, rng)),
+      coco(dfin, dfout, bench_params(nb_in_vars, nb_rules, nb_sets), rng)
+  {
+    auto& fit = coco.getFitnessMethod();
+    do {
+      rules_genome = coco.getEngine().buildRulesGenomes(1).front();
+      mfs_genome = coco.getEngine().buildMFsGenomes(1).front();
+    } while (!fit.resetFuzzySystem(rules_genome, mfs_genome));
+  }
+
+  FuzzySystem& getFuzzySystem() { return coco.getFuzzySystem(); }
+
+  RandomGenerator rng;
+  DataFrame dfin, dfout;
+  FuzzyCoco coco;
+  Genome rules_genome, mfs_genome;
+};
+
+#endif // BENCH_H
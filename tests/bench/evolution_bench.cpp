@@ -0,0 +1,78 @@
+#include "bench.h"
+#include "mutation_method.h"
+#include "crossover_method.h"
+#include "selection_method.h"
+
+// the evolution operators, on populations of rules genomes whose size depends on the number of
+// input variables, rules and sets (cf RulesCodec)
+
+static Genomes random_rules_genomes(int pop_size, int nb_vars, int nb_rules, int nb_sets) {
+  BenchFuzzyCoco bench(10, nb_vars, nb_rules, nb_sets);
+  return bench.coco.getEngine().buildRulesGenomes(pop_size);
+}
+
+static void BM_TogglingMutationMethod_mutate(benchmark::State& state) {
+  const Genomes genomes = random_rules_genomes(state.range(0), state.range(1), state.range(2), state.range(3));
+  const bool geometric = state.range(4);
+  RandomGenerator rng(BENCH_SEED);
+  EvolutionParams params;
+  TogglingMutationMethod mutation(rng, params.mut_flip_genome, params.mut_flip_bit, geometric);
+
+  Genomes pop;
+  for (auto _ : state) {
+    state.PauseTiming();
+    pop = genomes;
+    state.ResumeTiming();
+    mutation.mutate(pop);
+    benchmark::DoNotOptimize(pop.data());
+  }
+  state.SetItemsProcessed(state.iterations() * genomes.size());
+  state.counters["bits"] = genomes.front().size();
+}
+BENCHMARK(BM_TogglingMutationMethod_mutate)
+  ->ArgNames({"pop", "vars", "rules", "sets", "geometric"})
+  ->ArgsProduct({{100}, {4, 100, 1000}, {3, 20}, {3}, {0, 1}});
+
+static void BM_OnePointCrossoverMethod_reproduceAllPairsOf(benchmark::State& state) {
+  const Genomes genomes = random_rules_genomes(state.range(0), state.range(1), state.range(2), state.range(3));
+  RandomGenerator rng(BENCH_SEED);
+  OnePointCrossoverMethod crossover(rng, EvolutionParams().cx_prob);
+
+  // N.B: modified in place, but the cost does not depend on the content
+  Genomes pop = genomes;
+  for (auto _ : state) {
+    crossover.reproduceAllPairsOf(pop);
+    benchmark::DoNotOptimize(pop.data());
+  }
+  state.SetItemsProcessed(state.iterations() * genomes.size());
+  state.counters["bits"] = genomes.front().size();
+}
+BENCHMARK(BM_OnePointCrossoverMethod_reproduceAllPairsOf)
+  ->ArgNames({"pop", "vars", "rules", "sets"})
+  ->ArgsProduct({{100}, {4, 100, 1000}, {3, 20}, {3}});
+
+// select nb - elite_size entities among nb, as the evolution engine does
+template <typename Method>
+static void bench_selection(benchmark::State& state) {
+  const int nb = state.range(0);
+  const int nb_selected = max(nb - EvolutionParams().elite_size, 1);
+  RandomGenerator rng(BENCH_SEED);
+  vector<double> fitnesses(nb);
+  for (auto& fitness : fitnesses) fitness = rng.randomReal(0, 1);
+  Method selection(rng);
+  vector<int> indexes;
+  indexes.reserve(nb_selected);
+
+  for (auto _ : state) {
+    indexes.clear();
+    selection.selectEntities(nb_selected, fitnesses, indexes);
+    benchmark::DoNotOptimize(indexes.data());
+  }
+  state.SetItemsProcessed(state.iterations() * nb_selected);
+}
+
+static void BM_RankBasedSelectionMethod(benchmark::State& state) { bench_selection<RankBasedSelectionMethod>(state); }
+BENCHMARK(BM_RankBasedSelectionMethod)->ArgName("pop")->Arg(50)->Arg(500)->Arg(5000);
+
+static void BM_ElitismWithRandomMethod(benchmark::State& state) { bench_selection<ElitismWithRandomMethod>(state); }
+BENCHMARK(BM_ElitismWithRandomMethod)->ArgName("pop")->Arg(50)->Arg(500)->Arg(5000);
@@ -0,0 +1,130 @@
+#include "bench.h"
+#include <algorithm>
+
+// the fuzzy logic kernels, on random data and fuzzy systems of a given shape
+
+static void BM_FuzzyVariable_fuzzify(benchmark::State& state) {
+  const int nb_samples = state.range(0);
+  const int nb_sets = state.range(1);
+  RandomGenerator rng(BENCH_SEED);
+
+  vector<double> positions(nb_sets);
+  for (auto& pos : positions) pos = rng.randomReal(0, 100);
+  sort(positions.begin(), positions.end());
+  FuzzyVariable var("var", nb_sets);
+  for (int i = 0; i < nb_sets; i++) var.getSet(i).setPosition(positions[i]);
+
+  vector<double> values(nb_samples);
+  for (auto& value : values) value = rng.randomReal(0, 100);
+  vector<double> res;
+
+  for (auto _ : state) {
+    for (int set_idx = 0; set_idx < nb_sets; set_idx++) {
+      var.fuzzify(set_idx, values, res);
+      benchmark::DoNotOptimize(res.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * nb_samples * nb_sets);
+}
+BENCHMARK(BM_FuzzyVariable_fuzzify)
+  ->ArgNames({"samples", "sets"})
+  ->ArgsProduct({{1000, 100000}, {2, 3, 5}});
+
+// a rule that uses all the input variables
+static FuzzyRule full_rule(const FuzzySystem& fs) {
+  const int nb_vars = fs.getDB().getNbInputVars();
+  const int nb_sets = fs.getDB().getNbInputSets();
+  ConditionIndexes input_conds;
+  for (int i = 0; i < nb_vars; i++) input_conds.push_back({i, i % nb_sets});
+  return FuzzyRule(fs.getDB(), input_conds, {{0, 0}});
+}
+
+static void BM_FuzzyRule_evaluateFireLevel(benchmark::State& state) {
+  const int nb_samples = state.range(0);
+  const int nb_vars = state.range(1);
+  const int nb_sets = state.range(2);
+  BenchFuzzyCoco bench(nb_samples, nb_vars, 1, nb_sets);
+  const auto rule = full_rule(bench.getFuzzySystem());
+
+  for (auto _ : state) {
+    for (int row = 0; row < nb_samples; row++)
+      benchmark::DoNotOptimize(rule.evaluateFireLevel(bench.dfin, row));
+  }
+  state.SetItemsProcessed(state.iterations() * nb_samples);
+}
+BENCHMARK(BM_FuzzyRule_evaluateFireLevel)
+  ->ArgNames({"samples", "vars", "sets"})
+  ->ArgsProduct({{1000, 100000}, {2, 10}, {3}});
+
+// the column-wise version, as used by the fits
+static void BM_FuzzyRule_evaluateFireLevels(benchmark::State& state) {
+  const int nb_samples = state.range(0);
+  const int nb_vars = state.range(1);
+  const int nb_sets = state.range(2);
+  BenchFuzzyCoco bench(nb_samples, nb_vars, 1, nb_sets);
+  const auto rule = full_rule(bench.getFuzzySystem());
+  vector<double> fire_levels;
+
+  for (auto _ : state) {
+    rule.evaluateFireLevels(bench.dfin, fire_levels);
+    benchmark::DoNotOptimize(fire_levels.data());
+  }
+  state.SetItemsProcessed(state.iterations() * nb_samples);
+}
+BENCHMARK(BM_FuzzyRule_evaluateFireLevels)
+  ->ArgNames({"samples", "vars", "sets"})
+  ->ArgsProduct({{1000, 100000}, {2, 10}, {3}});
+
+static void BM_FuzzySystem_predictSample(benchmark::State& state) {
+  const int nb_samples = state.range(0);
+  BenchFuzzyCoco bench(nb_samples, state.range(1), state.range(2), state.range(3));
+  auto& fs = bench.getFuzzySystem();
+  vector<double> defuzzed;
+
+  for (auto _ : state) {
+    for (int row = 0; row < nb_samples; row++) {
+      fs.predictSample(row, bench.dfin, defuzzed);
+      benchmark::DoNotOptimize(defuzzed.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * nb_samples);
+}
+BENCHMARK(BM_FuzzySystem_predictSample)
+  ->ArgNames({"samples", "vars", "rules", "sets"})
+  ->ArgsProduct({{1000, 100000}, {4, 20}, {3, 10}, {3}});
+
+static void BM_FuzzySystem_predict(benchmark::State& state) {
+  const int nb_samples = state.range(0);
+  BenchFuzzyCoco bench(nb_samples, state.range(1), state.range(2), state.range(3));
+  auto& fs = bench.getFuzzySystem();
+
+  for (auto _ : state) {
+    auto predicted = fs.predict(bench.dfin);
+    benchmark::DoNotOptimize(predicted);
+  }
+  state.SetItemsProcessed(state.iterations() * nb_samples);
+}
+BENCHMARK(BM_FuzzySystem_predict)
+  ->ArgNames({"samples", "vars", "rules", "sets"})
+  ->ArgsProduct({{1000, 100000}, {4, 20}, {3, 10}, {3}});
+
+static void BM_RulesCodec_decode(benchmark::State& state) {
+  BenchFuzzyCoco bench(10, state.range(0), state.range(1), state.range(2));
+  const auto& codec = bench.coco.getEngine().getFuzzyCocoCodec().getRulesCodec();
+  const auto genomes = bench.coco.getEngine().buildRulesGenomes(100);
+  vector<int> fields;
+  vector<ConditionIndexes> rules_in, rules_out;
+  vector<int> default_rules;
+
+  for (auto _ : state) {
+    for (const auto& genome : genomes) {
+      codec.decode(genome, fields, rules_in, rules_out, default_rules);
+      benchmark::DoNotOptimize(rules_in.data());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * genomes.size());
+  state.counters["bits"] = codec.size();
+}
+BENCHMARK(BM_RulesCodec_decode)
+  ->ArgNames({"vars", "rules", "sets"})
+  ->ArgsProduct({{4, 100, 1000}, {3, 20}, {3, 5}});
@@ -0,0 +1,39 @@
+#include "bench.h"
+#include "file_utils.h"
+
+// the parsers of the input files: the datasets (CSV) and the fuzzy systems / params (JSON)
+
+static void BM_FileUtils_parseCSV(benchmark::State& state) {
+  const int nb_samples = state.range(0);
+  RandomGenerator rng(BENCH_SEED);
+  const string csv = random_csv(nb_samples, state.range(1), rng);
+  vector<vector<string>> tokens;
+
+  for (auto _ : state) {
+    tokens.clear();
+    FileUtils::parseCSV(csv, tokens);
+    benchmark::DoNotOptimize(tokens.data());
+  }
+  state.SetBytesProcessed(state.iterations() * csv.size());
+  state.SetItemsProcessed(state.iterations() * nb_samples);
+}
+BENCHMARK(BM_FileUtils_parseCSV)
+  ->ArgNames({"samples", "vars"})
+  ->ArgsProduct({{1000, 10000}, {4, 100}});
+
+// the description of a fuzzy system, with its params, as saved by a fit
+static void BM_NamedList_parse(benchmark::State& state) {
+  BenchFuzzyCoco bench(10, state.range(0), state.range(1), state.range(2));
+  ostringstream out;
+  out << bench.coco.describe();
+  const string json = out.str();
+
+  for (auto _ : state) {
+    auto desc = NamedList::parse(json);
+    benchmark::DoNotOptimize(desc);
+  }
+  state.SetBytesProcessed(state.iterations() * json.size());
+}
+BENCHMARK(BM_NamedList_parse)
+  ->ArgNames({"vars", "rules", "sets"})
+  ->ArgsProduct({{4, 100, 1000}, {3, 20}, {3}});
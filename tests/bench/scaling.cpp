@@ -0,0 +1,364 @@
+// fuzzycoco_scaling: an end-to-end scaling benchmark harness.
+// It runs full fits (fuzzycoco.exe, one process per fit) on synthetic datasets (cf SyntheticDataset) over a grid of
+// numbers of rows, of variables and of threads, and reports for each fit its evaluations per second, its time per
+// generation, its peak RSS, and its scaling efficiency w.r.t. the run with the fewest threads of the same shape.
+// The datasets are generated once in the work directory, and converted to the binary format so that the fits are not
+// dominated by the CSV parsing.
+// N.B: POSIX only (fork/exec and wait4). The timings are only meaningful on the Release version
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <cstring>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <sys/resource.h>
+
+#include "synthetic_dataset.h"
+#include "named_list.h"
+#include "file_utils.h"
+#include "profiler.h"
+#include "string_utils.h"
+#include "fuzzy_coco_params.h"
+
+using namespace fuzzy_coco;
+
+struct Params
+{
+  vector<int> nb_rows = {1000, 10000};
+  vector<int> nb_vars = {10, 100};
+  vector<int> nb_threads = {1, 2, 4};
+  int nb_generations = 10;
+  int seed = 123;
+  double na_rate = 0;
+  double class_balance = 0.5;
+  bool regression = false;
+  bool csv = false;
+  string exe = FUZZYCOCO_EXE;
+  string paramsFile;
+  string workDir = (temp_directory_path() / "fuzzycoco_scaling").string();
+  string ouputPath;
+};
+
+void showHelp()
+{
+  string help = R"(
+Usage: fuzzycoco_scaling [options]
+
+Runs fits of fuzzycoco.exe on synthetic datasets over a grid of shapes and numbers of threads,
+and reports their evaluations/s, time per generation, peak RSS and scaling efficiency.
+
+ --rows n1,n2,...    : the numbers of rows (defaults to 1000,10000)
+ --vars n1,n2,...    : the numbers of input variables (defaults to 10,100)
+ --threads n1,n2,... : the numbers of threads (defaults to 1,2,4)
+ --generations nb    : the number of generations of each fit (defaults to 10), with the built-in params
+ --seed value        : the seed of the datasets and of the fits (defaults to 123)
+ --na-rate r         : the probability of an input value to be missing (defaults to 0)
+ --balance r         : the probability of the class 1 (defaults to 0.5)
+ --regression        : use regression datasets instead of classification ones
+ --exe path          : the fuzzycoco.exe executable (defaults to the one built alongside)
+ --work-dir path     : where the datasets, params and fit results are stored (defaults to a temporary directory)
+ -p path             : a params file to use instead of the built-in params (then --generations is ignored)
+ -o path             : the report, in CSV if path ends with .csv, in JSON otherwise (defaults to JSON on stdout)
+ --csv               : report in CSV (e.g. on stdout)
+ --help              : this message
+)";
+  cerr << help;
+}
+
+void error(const string &message)
+{
+  cerr << endl << "ERROR: " << message << endl << endl;
+  showHelp();
+  exit(1);
+}
+
+vector<int> parse_ints(const string& s)
+{
+  vector<int> values;
+  istringstream in(s);
+  string token;
+  while (getline(in, token, ','))
+    values.push_back(stoi(token));
+  if (values.empty()) error("empty list of values: " + s);
+  return values;
+}
+
+Params parseArguments(int argc, char *argv[])
+{
+  Params params;
+  for (int i = 1; i < argc; i++) {
+    const string arg = argv[i];
+    if (arg == "--help") {
+      showHelp();
+      exit(0);
+    } else if (arg == "--regression") {
+      params.regression = true;
+    } else if (arg == "--csv") {
+      params.csv = true;
+    } else {
+      if (i >= argc - 1) error("parameter " + arg + " requires a value");
+      const string value = argv[++i];
+      if (arg == "--rows") params.nb_rows = parse_ints(value);
+      else if (arg == "--vars") params.nb_vars = parse_ints(value);
+      else if (arg == "--threads") params.nb_threads = parse_ints(value);
+      else if (arg == "--generations") params.nb_generations = stoi(value);
+      else if (arg == "--seed") params.seed = stoi(value);
+      else if (arg == "--na-rate") params.na_rate = stod(value);
+      else if (arg == "--balance") params.class_balance = stod(value);
+      else if (arg == "--exe") params.exe = value;
+      else if (arg == "--work-dir") params.workDir = value;
+      else if (arg == "-p") params.paramsFile = value;
+      else if (arg == "-o") params.ouputPath = value;
+      else error("invalid parameter " + arg);
+    }
+  }
+
+  if (params.nb_generations < 1) error("the number of generations must be >= 1");
+  for (int nb : params.nb_threads)
+    if (nb < 0) error("the numbers of threads must be >= 0");
+  if (!is_regular_file(params.exe)) error("fuzzycoco executable not found: " + params.exe);
+  if (!params.paramsFile.empty() && !is_regular_file(params.paramsFile))
+    error("params file not found: " + params.paramsFile);
+  if (path(params.ouputPath).extension() == ".csv") params.csv = true;
+  return params;
+}
+
+// the built-in params: a mid-sized fit whose cost is dominated by the fitness evaluations.
+// N.B: the numbers of bits of the variables are computed for each shape, cf write_params()
+string builtin_params(const Params& params)
+{
+  ostringstream out;
+  out << R"({
+  "global_params":{
+    "nb_rules":5,
+    "nb_max_var_per_rule":3,
+    "max_generations":)" << params.nb_generations << R"(,
+    "max_fitness":2.0
+  },
+  "input_vars_params":{ "nb_sets":3, "nb_bits_sets":2, "nb_bits_pos":8 },
+  "output_vars_params":{ "nb_sets":2, "nb_bits_sets":1, "nb_bits_pos":8 },
+  "rules_params":{ "pop_size":100, "elite_size":5, "cx_prob":0.5, "mut_flip_genome":0.5, "mut_flip_bit":0.025 },
+  "mfs_params":{ "pop_size":100, "elite_size":5, "cx_prob":0.5, "mut_flip_genome":0.5, "mut_flip_bit":0.025 },
+  "fitness_params":{
+    "output_vars_defuzz_thresholds":0.5,
+    "metrics_weights":)" << (params.regression ? R"({ "rmse":1.0 })" : R"({ "sensitivity":1.0, "specificity":1.0 })")
+    << R"(
+  }
+}
+)";
+  return out.str();
+}
+
+// the params for a dataset of nb_vars input variables, with their missing values evaluated
+string write_params(const Params& params, const NamedList& desc, int nb_vars)
+{
+  FuzzyCocoParams coco_params(desc);
+  coco_params.evaluate_missing(nb_vars, 1);
+  const string filename = (path(params.workDir) / ("params_" + to_string(nb_vars) + ".json")).string();
+  ofstream out(filename);
+  out << coco_params.describe();
+  if (!out) throw runtime_error("unable to write " + filename);
+  return filename;
+}
+
+struct Process {
+  int status = 0;
+  double wall_seconds = 0;
+  // in MB
+  double peak_rss = 0;
+};
+
+// runs the command (without a shell) and waits for it
+Process run(const vector<string>& command)
+{
+  vector<char*> argv;
+  for (const auto& arg : command) argv.push_back(const_cast<char*>(arg.c_str()));
+  argv.push_back(nullptr);
+
+  Process process;
+  auto start = chrono::steady_clock::now();
+  pid_t pid = fork();
+  if (pid < 0) throw runtime_error(string("fork() failed: ") + strerror(errno));
+  if (pid == 0) {
+    execv(argv[0], argv.data());
+    cerr << "execv() failed for " << command.front() << ": " << strerror(errno) << endl;
+    _exit(127);
+  }
+  struct rusage usage;
+  if (wait4(pid, &process.status, 0, &usage) < 0) throw runtime_error(string("wait4() failed: ") + strerror(errno));
+  process.wall_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+#ifdef __APPLE__
+  // in bytes
+  process.peak_rss = usage.ru_maxrss / (1024.0 * 1024.0);
+#else
+  // in kilobytes
+  process.peak_rss = usage.ru_maxrss / 1024.0;
+#endif
+  return process;
+}
+
+void check(const Process& process, const string& what)
+{
+  if (!WIFEXITED(process.status) || WEXITSTATUS(process.status) != 0)
+    throw runtime_error(what + " failed");
+}
+
+// the binary dataset of that shape, generated if needed
+string prepare_dataset(const Params& params, int nb_rows, int nb_vars)
+{
+  SyntheticDataset::Options options;
+  options.nb_rows = nb_rows;
+  options.nb_vars = nb_vars;
+  options.na_rate = params.na_rate;
+  options.class_balance = params.class_balance;
+  options.regression = params.regression;
+  options.seed = params.seed;
+
+  path bin = path(params.workDir) / options.filename(".bin");
+  if (exists(bin)) return bin.string();
+
+  path csv = path(params.workDir) / options.filename();
+  cerr << "generating " << csv.string() << endl;
+  SyntheticDataset::write(options, csv);
+  check(run({params.exe, "-d", csv.string(), "--convert", "-o", bin.string()}), "the conversion of " + csv.string());
+  remove(csv);
+  return bin.string();
+}
+
+NamedList run_fit(const Params& params, const string& dataset, const string& params_file, int nb_rows, int nb_vars,
+  int nb_threads)
+{
+  const string name = to_string(nb_rows) + "x" + to_string(nb_vars) + "_t" + to_string(nb_threads);
+  const string output = (path(params.workDir) / ("fit_" + name + ".json")).string();
+  vector<string> command = {params.exe, "-d", dataset, "-p", params_file, "--seed", to_string(params.seed),
+    "--threads", to_string(nb_threads), "-o", output};
+  if (Profiler::available()) command.push_back("--profile");
+
+  cerr << "fitting " << name << endl;
+  auto process = run(command);
+  check(process, "the fit " + name);
+  auto results = NamedList::parse(FileUtils::slurp(output));
+  const auto& fit = results.get_list("fit");
+
+  NamedList desc(name);
+  desc.add("rows", nb_rows);
+  desc.add("vars", nb_vars);
+  desc.add("threads", nb_threads);
+  desc.add("fitness", fit.get_numeric("fitness"));
+  const int nb_generations = fit.get_as_int("generations");
+  desc.add("generations", nb_generations);
+  desc.add("stop_reason", fit.has("stop_reason") ? fit.get_string("stop_reason") : string("none"));
+  desc.add("wall_s", process.wall_seconds);
+  // N.B: the fit time excludes the loading of the dataset. It needs the profiler, otherwise the wall time is used
+  double fit_seconds = process.wall_seconds;
+  // the fitness computations (i.e. the fitness cache misses) are only counted by the profiler
+  double nb_fitness_computations = MISSING_DATA_DOUBLE;
+  if (results.has("profile")) {
+    const auto& profile = results.get_list("profile");
+    fit_seconds = profile.get_numeric("elapsed_s");
+    nb_fitness_computations = profile.get_numeric("nb_evaluations");
+  }
+  // the evaluations of the engine, cached or not, cf the max_evaluations stopping criterion
+  const double nb_evaluations = fit.has("nb_evaluations") ? fit.get_numeric("nb_evaluations") : MISSING_DATA_DOUBLE;
+  desc.add("fit_s", fit_seconds);
+  desc.add("time_per_generation_s", nb_generations > 0 ? fit_seconds / nb_generations : MISSING_DATA_DOUBLE);
+  desc.add("nb_evaluations", nb_evaluations);
+  desc.add("nb_fitness_computations", nb_fitness_computations);
+  desc.add("evaluations_per_s", is_na(nb_evaluations) ? MISSING_DATA_DOUBLE : nb_evaluations / fit_seconds);
+  // the throughput in rows evaluated per second, to compare the shapes
+  desc.add("rows_per_s", is_na(nb_evaluations) ? MISSING_DATA_DOUBLE : nb_evaluations * nb_rows / fit_seconds);
+  desc.add("peak_rss_mb", process.peak_rss);
+  return desc;
+}
+
+// the speedup and the efficiency of each run w.r.t. the run with the fewest threads of the same shape
+// (i.e. the first one, cf the sorted threads): efficiency = (t_base * n_base) / (t * n)
+// N.B: 0 threads means all the cores
+void add_scaling(vector<NamedList>& runs, size_t first, size_t last)
+{
+  auto cores = [](int nb) { return nb == 0 ? max(1u, thread::hardware_concurrency()) : unsigned(nb); };
+  const auto& base = runs[first];
+  const double base_time = base.get_numeric("fit_s");
+  const double base_cores = cores(base.get_int("threads"));
+  for (size_t i = first; i < last; i++) {
+    const double time = runs[i].get_numeric("fit_s");
+    const double speedup = base_time / time;
+    runs[i].add("speedup", speedup);
+    runs[i].add("efficiency", speedup * base_cores / cores(runs[i].get_int("threads")));
+  }
+}
+
+void write_csv(ostream& out, const vector<NamedList>& runs)
+{
+  if (runs.empty()) return;
+  const auto names = runs.front().names();
+  for (size_t j = 0; j < names.size(); j++)
+    out << (j ? ";" : "") << names[j];
+  out << '\n';
+  for (const auto& run : runs) {
+    for (size_t j = 0; j < names.size(); j++) {
+      out << (j ? ";" : "");
+      const auto& value = run[names[j]].scalar();
+      if (value.is_string()) out << value.get_string();
+      else if (value.is_int()) out << value.get_int();
+      else if (is_na(value.get_double())) out << "NA";
+      else out << value.get_double();
+    }
+    out << '\n';
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  Params params = parseArguments(argc, argv);
+  sort(params.nb_threads.begin(), params.nb_threads.end(), [](int a, int b) {
+    // N.B: 0 (all the cores) last
+    return a != 0 && (b == 0 || a < b);
+  });
+  create_directories(params.workDir);
+
+  const string params_content = params.paramsFile.empty() ? builtin_params(params) : FileUtils::slurp(params.paramsFile);
+  const auto params_desc = NamedList::parse(StringUtils::stripComments(params_content));
+
+  vector<NamedList> runs;
+  for (int nb_rows : params.nb_rows)
+    for (int nb_vars : params.nb_vars) {
+      const string dataset = prepare_dataset(params, nb_rows, nb_vars);
+      const string params_file = write_params(params, params_desc, nb_vars);
+      const size_t first = runs.size();
+      for (int nb_threads : params.nb_threads)
+        runs.push_back(run_fit(params, dataset, params_file, nb_rows, nb_vars, nb_threads));
+      add_scaling(runs, first, runs.size());
+    }
+
+  ofstream file;
+  if (!params.ouputPath.empty()) {
+    FileUtils::mkdir_if_needed(params.ouputPath);
+    file.open(params.ouputPath);
+    if (!file.is_open()) error("unable to open file " + params.ouputPath);
+  }
+  ostream& out = params.ouputPath.empty() ? cout : file;
+
+  if (params.csv) {
+    write_csv(out, runs);
+  } else {
+    NamedList report;
+    NamedList settings;
+    settings.add("exe", params.exe);
+    settings.add("params", params.paramsFile.empty() ? string("built-in") : params.paramsFile);
+    settings.add("seed", params.seed);
+    settings.add("regression", params.regression);
+    settings.add("na_rate", params.na_rate);
+    settings.add("class_balance", params.class_balance);
+    settings.add("profiler", Profiler::available());
+    settings.add("hardware_concurrency", int(thread::hardware_concurrency()));
+    report.add("settings", settings);
+    NamedList lst;
+    for (auto& run : runs) lst.append(move(run));
+    report.add("runs", lst);
+    out << report;
+  }
+}
@@ -0,0 +1,150 @@
+#include "tests.h"
+#include <cstdint>
+#include <cstring>
+#include <climits>
+#include <fstream>
+#include "binary_dataframe.h"
+#include "file_utils.h"
+
+using namespace fuzzy_coco;
+using namespace FileUtils;
+
+string CSV =
+R"(ID;VAR1;VAR2;OUT
+id1;1;NA;0
+id2;2.5;3.2;1
+id3;-1e3;4;NA
+)";
+
+static string slurp_binary(const string& filename) {
+  ifstream in(filename, ios::binary);
+  return string(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+}
+
+TEST(BinaryDataFrame, save_load) {
+  string tmp = poor_man_tmpnam("BinaryDataFrame");
+  for (auto storage : {DataFrame::FLOAT64, DataFrame::FLOAT32}) {
+    for (bool rownames : {true, false}) {
+      DataFrame df(CSV, rownames);
+      df.setStorage(storage);
+      // the column of VAR1
+      const int c = rownames ? 0 : 1;
+      BinaryDataFrame::save(df, path(tmp));
+      EXPECT_TRUE(BinaryDataFrame::isBinary(tmp));
+
+      DataFrame loaded = BinaryDataFrame::load(tmp);
+      EXPECT_TRUE(loaded.isShared());
+      EXPECT_EQ(loaded.getStorage(), storage);
+      EXPECT_EQ(loaded.colnames(), df.colnames());
+      EXPECT_EQ(loaded.rownames(), df.rownames());
+      EXPECT_EQ(loaded, df);
+      EXPECT_TRUE(loaded.missing(2, c + 2));
+      // zero-copy: the columns are aligned in the mapping
+      EXPECT_EQ(reinterpret_cast<uintptr_t>(storage == DataFrame::FLOAT32 ?
+        (const void*)loaded[1].floatData() : (const void*)loaded[1].data()) % DataFrame::ALIGNMENT, 0);
+
+      // detected by DataFrame::load()
+      EXPECT_EQ(DataFrame::load(tmp, true), df);
+
+      // copy on write
+      DataFrame copy = loaded;
+      copy.set(0, c, 42);
+      EXPECT_FALSE(copy.isShared());
+      EXPECT_EQ(copy.at(0, c), 42);
+      EXPECT_EQ(copy.at(1, c), 2.5);
+      EXPECT_EQ(loaded.at(0, c), 1);
+      EXPECT_EQ(BinaryDataFrame::load(tmp), df);
+
+      // other operations on the shared values
+      EXPECT_EQ(loaded.subsetColumns(1, 2), df.subsetColumns(1, 2));
+      loaded.fillCol(c + 1, {7, 8, 9});
+      EXPECT_FALSE(loaded.isShared());
+      EXPECT_EQ(loaded.at(2, c + 1), 9);
+      EXPECT_EQ(loaded.at(2, c), -1000);
+    }
+  }
+  remove(tmp);
+}
+
+TEST(BinaryDataFrame, layout) {
+  string tmp = poor_man_tmpnam("BinaryDataFrame_layout");
+  DataFrame df(CSV, true);
+  BinaryDataFrame::save(df, path(tmp));
+
+  string content = slurp_binary(tmp);
+  BinaryDataFrame::Header header;
+  ASSERT_GE(content.size(), sizeof(header));
+  memcpy(&header, content.data(), sizeof(header));
+  EXPECT_EQ(header.version, BinaryDataFrame::VERSION);
+  EXPECT_EQ(header.storage, uint32_t(DataFrame::FLOAT64));
+  EXPECT_EQ(header.has_rownames, 1u);
+  EXPECT_EQ(header.nbrows, 3u);
+  EXPECT_EQ(header.nbcols, 3u);
+  EXPECT_EQ(header.stride, 8u);
+  EXPECT_EQ(header.values_offset % 64, 0u);
+  EXPECT_EQ(header.bitmap_offset, header.values_offset + 3 * 8 * sizeof(double));
+  EXPECT_EQ(content.size(), header.bitmap_offset + 3 * sizeof(uint64_t));
+
+  // values
+  double value;
+  memcpy(&value, content.data() + header.values_offset + (8 + 1) * sizeof(double), sizeof(double));
+  EXPECT_EQ(value, 3.2);
+
+  // NA bitmap
+  vector<uint64_t> words(3);
+  memcpy(words.data(), content.data() + header.bitmap_offset, 3 * sizeof(uint64_t));
+  EXPECT_EQ(words, vector<uint64_t>({0, 1, 4}));
+
+  remove(tmp);
+}
+
+TEST(BinaryDataFrame, errors) {
+  string tmp = poor_man_tmpnam("BinaryDataFrame_errors");
+  EXPECT_THROW(BinaryDataFrame::load(tmp), filesystem_error);
+  EXPECT_FALSE(BinaryDataFrame::isBinary(tmp));
+
+  // a CSV
+  { ofstream out(tmp); out << CSV; }
+  EXPECT_FALSE(BinaryDataFrame::isBinary(tmp));
+  EXPECT_THROW(BinaryDataFrame::load(tmp), runtime_error);
+
+  // truncated
+  DataFrame df(CSV, true);
+  BinaryDataFrame::save(df, path(tmp));
+  string content = slurp_binary(tmp);
+  for (size_t size : {size_t(10), size_t(70), content.size() - 1}) {
+    { ofstream out(tmp, ios::binary); out.write(content.data(), size); }
+    EXPECT_THROW(BinaryDataFrame::load(tmp), runtime_error) << size;
+  }
+
+  // crafted headers: too many rows or columns, sizes that wrap around
+  auto patch = [&](uint64_t nbrows, uint64_t nbcols, uint64_t stride, uint64_t bitmap_offset) {
+    BinaryDataFrame::Header header;
+    memcpy(&header, content.data(), sizeof(header));
+    header.nbrows = nbrows;
+    header.nbcols = nbcols;
+    header.stride = stride;
+    header.bitmap_offset = bitmap_offset;
+    string patched = content;
+    memcpy(&patched[0], &header, sizeof(header));
+    ofstream out(tmp, ios::binary);
+    out.write(patched.data(), patched.size());
+  };
+  BinaryDataFrame::Header header;
+  memcpy(&header, content.data(), sizeof(header));
+  // N.B: 2^61 columns of 8 rows: both the values and the bitmap sizes wrap to 0
+  patch(3, uint64_t(1) << 61, 8, header.values_offset);
+  EXPECT_THROW(BinaryDataFrame::load(tmp), runtime_error);
+  patch(uint64_t(INT_MAX) + 1, 3, DataFrame::paddedStride<double>(INT_MAX - 64) + 64, header.bitmap_offset);
+  EXPECT_THROW(BinaryDataFrame::load(tmp), runtime_error);
+  patch(3, uint64_t(INT_MAX), 8, header.values_offset + uint64_t(INT_MAX) * 8 * sizeof(double));
+  EXPECT_THROW(BinaryDataFrame::load(tmp), runtime_error);
+
+  // empty DataFrame
+  BinaryDataFrame::save(DataFrame(0, 2), path(tmp));
+  DataFrame empty = BinaryDataFrame::load(tmp);
+  EXPECT_EQ(empty.nbrows(), 0);
+  EXPECT_EQ(empty.nbcols(), 2);
+
+  remove(tmp);
+}
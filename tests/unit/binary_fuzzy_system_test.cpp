@@ -0,0 +1,156 @@
+#include "tests.h"
+#include <cstring>
+#include <fstream>
+#include "binary_fuzzy_system.h"
+#include "fuzzy_coco.h"
+#include "file_utils.h"
+
+using namespace fuzzy_coco;
+using namespace FileUtils;
+
+string FUZZY_SYSTEM_JSON = R"(
+{
+  "variables":{
+    "input":{
+      "in_1":{ "in_1.1":0.0, "in_1.2":5.0, "in_1.3":10.0 },
+      "in_2":{ "in_2.1":0.0, "in_2.2":50.0, "in_2.3":100.0 },
+      "in_3":{ "in_3.1":0.0, "in_3.2":500.0, "in_3.3":1000.0 }
+    },
+    "output":{
+      "out_1":{ "out_1.1":0.0, "out_1.2":100.0 },
+      "out_2":{ "out_2.1":0.0, "out_2.2":10.0 }
+    }
+  },
+  "rules":{
+    "rule1":{
+      "antecedents":{ "in_1":"in_1.1", "in_2":"in_2.1", "in_3":"in_3.1" },
+      "consequents":{ "out_1":"out_1.1" }
+    },
+    "rule2":{
+      "antecedents":{ "in_1":"in_1.3", "in_3":"in_3.2" },
+      "consequents":{ "out_1":"out_1.2", "out_2":"out_2.2" }
+    }
+  },
+  "default_rules":{ "out_1":"out_1.2", "out_2":"out_2.1" }
+})";
+
+string DATA =
+R"(ID;in_1;in_2;in_3
+id1;1;10;100
+id2;9;NA;450
+id3;4;60;990
+id4;NA;NA;NA
+)";
+
+TEST(BinaryFuzzySystem, save_load) {
+  string tmp = poor_man_tmpnam("BinaryFuzzySystem");
+  FuzzySystem fs = FuzzySystem::load(FUZZY_SYSTEM_JSON);
+  DataFrame df(DATA, true);
+
+  for (auto tnorm : {TNorm::MIN, TNorm::PRODUCT, TNorm::LUKASIEWICZ}) {
+    fs.setTNorm(tnorm);
+    BinaryFuzzySystem::save(fs, path(tmp));
+    EXPECT_TRUE(BinaryFuzzySystem::isBinary(tmp));
+
+    FuzzySystem loaded = BinaryFuzzySystem::load(path(tmp));
+    EXPECT_EQ(loaded.getTNorm(), tnorm);
+    EXPECT_EQ(loaded.describe(), fs.describe());
+    EXPECT_EQ(loaded.getDefaultRulesOutputSets(), fs.getDefaultRulesOutputSets());
+    EXPECT_EQ(loaded.getRule(1).getOutputConditionIndexes(), fs.getRule(1).getOutputConditionIndexes());
+    EXPECT_EQ(loaded.predict(df), fs.predict(df));
+  }
+  remove(tmp);
+}
+
+TEST(BinaryFuzzySystem, layout) {
+  FuzzySystem fs = FuzzySystem::load(FUZZY_SYSTEM_JSON);
+  ostringstream out;
+  BinaryFuzzySystem::save(fs, out);
+  string content = out.str();
+
+  BinaryFuzzySystem::Header header;
+  ASSERT_GE(content.size(), sizeof(header));
+  memcpy(&header, content.data(), sizeof(header));
+  EXPECT_EQ(header.version, BinaryFuzzySystem::VERSION);
+  EXPECT_EQ(header.nb_input_vars, 3u);
+  EXPECT_EQ(header.nb_input_sets, 3u);
+  EXPECT_EQ(header.nb_output_vars, 2u);
+  EXPECT_EQ(header.nb_output_sets, 2u);
+  EXPECT_EQ(header.nb_rules, 2u);
+  EXPECT_EQ(header.nb_input_conditions, 5u);
+  EXPECT_EQ(header.nb_output_conditions, 3u);
+  EXPECT_EQ(header.payload_size, content.size() - sizeof(header));
+
+  // the positions come first
+  double pos;
+  memcpy(&pos, content.data() + sizeof(header) + 8 * sizeof(double), sizeof(double));
+  EXPECT_EQ(pos, 1000);
+
+  // from a string_view
+  EXPECT_EQ(BinaryFuzzySystem::load(string_view(content)).describe(), fs.describe());
+}
+
+TEST(BinaryFuzzySystem, errors) {
+  string tmp = poor_man_tmpnam("BinaryFuzzySystem_errors");
+  EXPECT_THROW(BinaryFuzzySystem::load(path(tmp)), filesystem_error);
+  EXPECT_FALSE(BinaryFuzzySystem::isBinary(tmp));
+
+  // a JSON
+  EXPECT_THROW(BinaryFuzzySystem::load(string_view(FUZZY_SYSTEM_JSON)), runtime_error);
+
+  FuzzySystem fs = FuzzySystem::load(FUZZY_SYSTEM_JSON);
+  ostringstream out;
+  BinaryFuzzySystem::save(fs, out);
+  const string content = out.str();
+
+  // truncated
+  for (size_t size : {size_t(10), size_t(70), content.size() - 1})
+    EXPECT_THROW(BinaryFuzzySystem::load(string_view(content.data(), size)), runtime_error) << size;
+
+  // corrupted: bad checksum
+  for (size_t offset : {size_t(64), size_t(100), content.size() - 1}) {
+    string corrupted = content;
+    corrupted[offset] ^= 1;
+    EXPECT_THROW(BinaryFuzzySystem::load(string_view(corrupted)), runtime_error) << offset;
+  }
+
+  // bad t-norm
+  {
+    string corrupted = content;
+    const uint32_t tnorm = 42;
+    memcpy(&corrupted[offsetof(BinaryFuzzySystem::Header, tnorm)], &tnorm, sizeof(tnorm));
+    EXPECT_THROW(BinaryFuzzySystem::load(string_view(corrupted)), runtime_error);
+  }
+
+  // a valid but corrupted t-norm: MIN <-> PRODUCT, caught by the checksum of the header
+  for (auto tnorm : {TNorm::MIN, TNorm::PRODUCT}) {
+    fs.setTNorm(tnorm);
+    ostringstream out2;
+    BinaryFuzzySystem::save(fs, out2);
+    string corrupted = out2.str();
+    corrupted[offsetof(BinaryFuzzySystem::Header, tnorm)] ^= 1;
+    try {
+      BinaryFuzzySystem::load(string_view(corrupted));
+      ADD_FAILURE() << "no error";
+    } catch (const runtime_error& e) {
+      EXPECT_NE(string(e.what()).find("bad checksum"), string::npos) << e.what();
+    }
+  }
+
+  remove(tmp);
+}
+
+TEST(BinaryFuzzySystem, loadAndPredict) {
+  string json = poor_man_tmpnam("BinaryFuzzySystem_json");
+  string bin = poor_man_tmpnam("BinaryFuzzySystem_bin");
+  { ofstream out(json); out << "{ \"fuzzy_system\": " << FUZZY_SYSTEM_JSON << "}"; }
+  BinaryFuzzySystem::save(FuzzyCoco::loadFuzzySystem(json), path(bin));
+  EXPECT_TRUE(BinaryFuzzySystem::isBinary(bin));
+  EXPECT_FALSE(BinaryFuzzySystem::isBinary(json));
+
+  DataFrame df(DATA, true);
+  EXPECT_EQ(FuzzyCoco::loadAndPredict(df, bin), FuzzyCoco::loadAndPredict(df, json));
+
+  remove(json);
+  remove(bin);
+}
@@ -53,4 +53,70 @@ TEST(bitarray, randomize) {
   randomize(bits2, rng2);
   EXPECT_EQ(bits2, bits);
 
-}
\ No newline at end of file
+}
+
+TEST(bitarray, fields) {
+  // N.B: fields crossing the words boundaries
+  BitArray bits(200);
+  RandomGenerator rng(666);
+  randomize(bits, rng);
+  for (int nb_bits : {0, 1, 7, 13, 31, 64}) {
+    for (size_t pos : {0, 1, 50, 60, 63, 64, 127, 130}) {
+      if (pos + nb_bits > bits.size()) continue;
+      uint64_t expected = 0;
+      for (int i = 0; i < nb_bits; i++) 
+        expected |= uint64_t(bits[pos + i]) << i;
+      EXPECT_EQ(bits.getField(pos, nb_bits), expected);
+
+      BitArray bits2 = bits;
+      bits2.setField(pos, nb_bits, ~expected);
+      for (size_t i = 0; i < bits.size(); i++) {
+        const bool inside = i >= pos && i < pos + nb_bits;
+        EXPECT_EQ(bits2[i], inside ? !bits[i] : bits[i]);
+      }
+    }
+  }
+}
+
+TEST(bitarray, basic) {
+  BitArray bits = {true, false, true};
+  EXPECT_EQ(bits.size(), 3);
+  EXPECT_TRUE(bits[0]);
+  EXPECT_FALSE(bits[1]);
+  bits[1] = true;
+  bits.flip(2);
+  EXPECT_EQ(bits, BitArray({true, true, false}));
+
+  // resize
+  bits.resize(130, true);
+  EXPECT_EQ(bits.count(), 129);
+  bits.resize(2);
+  EXPECT_EQ(bits.count(), 2);
+  bits.resize(70);
+  EXPECT_EQ(bits.count(), 2);
+  EXPECT_TRUE(bits[0] && bits[1] && !bits[69]);
+
+  BitArray ones(100, true), zeros(100);
+  EXPECT_EQ(ones.count(), 100);
+  EXPECT_EQ(ones.hamming(zeros), 100);
+  EXPECT_EQ(hamming_distance(ones, ones), 0);
+  EXPECT_NE(ones, zeros);
+  EXPECT_NE(std::hash<BitArray>()(ones), std::hash<BitArray>()(zeros));
+}
+
+TEST(bitarray, swapTail) {
+  RandomGenerator rng(666);
+  BitArray a(150), b(150);
+  randomize(a, rng);
+  randomize(b, rng);
+  for (size_t from : {0, 1, 63, 64, 65, 149, 150}) {
+    BitArray a2 = a, b2 = b;
+    a2.swapTail(b2, from);
+    for (size_t i = 0; i < a.size(); i++) {
+      EXPECT_EQ(a2[i], i < from ? a[i] : b[i]);
+      EXPECT_EQ(b2[i], i < from ? b[i] : a[i]);
+    }
+    // the differing bits are only exchanged
+    EXPECT_EQ(a2.hamming(b2), a.hamming(b));
+  }
+}
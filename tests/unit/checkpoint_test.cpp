@@ -0,0 +1,216 @@
+#include "tests.h"
+#include <cstring>
+#include <sstream>
+#include "checkpoint.h"
+#include "island_model.h"
+#include "file_utils.h"
+
+using namespace fuzzy_coco;
+using namespace FileUtils;
+
+string CSV =
+R"(Days;Temperature;Sunshine;Tourists
+day1;19;25;55
+day2;40;99;95
+day3;24;NA;70
+day4;5;3;2
+day5;31;60;80
+day6;12;NA;20
+)";
+
+class CheckpointTest : public testing::Test {
+protected:
+  CheckpointTest() : DF(CSV, true) {}
+
+  void SetUp() override {
+    DFIN = DF.subsetColumns(0, DF.nbcols() - 2);
+    DFOUT = DF.subsetColumns(DF.nbcols() - 1, DF.nbcols() - 1);
+
+    params.global_params.nb_rules = 3;
+    params.global_params.nb_max_var_per_rule = DFIN.nbcols();
+    params.global_params.max_generations = 10;
+    params.global_params.max_fitness = 2; // never early-stop
+    params.input_vars_params.nb_bits_pos = 8;
+    params.output_vars_params.nb_bits_pos = 2;
+    params.fitness_params.output_vars_defuzz_thresholds.push_back(50);
+    params.rules_params.pop_size = 10;
+    params.mfs_params.pop_size = 20;
+    params.evaluate_missing(DFIN.nbcols(), 1);
+  }
+
+  DataFrame DF, DFIN, DFOUT;
+  FuzzyCocoParams params;
+};
+
+static void expect_same_generations(const Generation& gen1, const Generation& gen2) {
+  EXPECT_EQ(gen1.individuals, gen2.individuals);
+  EXPECT_EQ(gen1.elite, gen2.elite);
+  EXPECT_EQ(gen1.fitnesses, gen2.fitnesses);
+  EXPECT_EQ(gen1.fitness, gen2.fitness);
+  EXPECT_EQ(gen1._elite_size, gen2._elite_size);
+}
+
+TEST(RandomGenerator, state) {
+  RandomGenerator rng(123);
+  rng.random();
+  const string state = rng.getState();
+  vector<uint32_t> values;
+  for (int i = 0; i < 10; i++) values.push_back(rng.random());
+
+  RandomGenerator rng2(456);
+  rng2.setState(state);
+  for (int i = 0; i < 10; i++) EXPECT_EQ(rng2.random(), values[i]);
+
+  EXPECT_THROW(rng2.setState("foufou"), runtime_error);
+}
+
+TEST_F(CheckpointTest, save_load) {
+  RandomGenerator rng(123);
+  FuzzyCoco coco(DFIN, DFOUT, params, rng);
+  auto gen = coco.run(3, 2);
+
+  Checkpoint::State state;
+  state.params = Checkpoint::describeParams(params);
+  state.elapsed_seconds = 1.5;
+  state.last_improvement = 2;
+  state.coevolutions.push_back(coco.getState(gen));
+
+  ostringstream out;
+  Checkpoint::save(state, out);
+  const string content = out.str();
+
+  Checkpoint::Header header;
+  memcpy(&header, content.data(), sizeof(header));
+  EXPECT_EQ(header.nb_coevolutions, 1u);
+  EXPECT_EQ(header.generation_number, 3);
+  EXPECT_EQ(header.payload_size, content.size() - sizeof(header));
+
+  auto loaded = Checkpoint::load(string_view(content));
+  EXPECT_EQ(loaded.params, state.params);
+  EXPECT_TRUE(loaded.rng_state.empty());
+  EXPECT_EQ(loaded.elapsed_seconds, 1.5);
+  EXPECT_EQ(loaded.last_improvement, 2);
+  ASSERT_EQ(loaded.coevolutions.size(), 1u);
+  const auto& coev = loaded.coevolutions[0];
+  EXPECT_EQ(coev.rng_state, rng.getState());
+  EXPECT_EQ(coev.best, coco.getFitnessMethod().getBest());
+  EXPECT_EQ(coev.best_fitness, coco.getFitnessMethod().getBestFitness());
+  EXPECT_EQ(coev.nb_evaluations, coco.getFitnessMethod().getNbEvaluations());
+  EXPECT_EQ(coev.generation.generation_number, 3);
+  EXPECT_EQ(coev.generation.fitness, gen.fitness);
+  expect_same_generations(coev.generation.left_gen, gen.left_gen);
+  expect_same_generations(coev.generation.right_gen, gen.right_gen);
+
+  // params
+  EXPECT_NO_THROW(Checkpoint::checkParams(loaded, params));
+  FuzzyCocoParams other = params;
+  other.global_params.nb_threads = 4;
+  other.global_params.max_generations = 1000;
+  other.global_params.max_seconds = 60;
+  EXPECT_NO_THROW(Checkpoint::checkParams(loaded, other));
+  other.global_params.nb_rules = 4;
+  EXPECT_THROW(Checkpoint::checkParams(loaded, other), runtime_error);
+
+  // genomes that do not match the codec
+  params.global_params.nb_rules = 4;
+  RandomGenerator rng2(123);
+  FuzzyCoco coco2(DFIN, DFOUT, params, rng2);
+  EXPECT_THROW(coco2.restoreState(coev), runtime_error);
+}
+
+TEST_F(CheckpointTest, errors) {
+  string tmp = poor_man_tmpnam("Checkpoint_errors");
+  EXPECT_THROW(Checkpoint::load(path(tmp)), filesystem_error);
+
+  RandomGenerator rng(123);
+  FuzzyCoco coco(DFIN, DFOUT, params, rng);
+  auto gen = coco.run(1, 2);
+  Checkpoint::State state;
+  state.coevolutions.push_back(coco.getState(gen));
+  ostringstream out;
+  Checkpoint::save(state, out);
+  const string content = out.str();
+
+  // truncated
+  for (size_t size : {size_t(10), size_t(70), content.size() - 1})
+    EXPECT_THROW(Checkpoint::load(string_view(content.data(), size)), runtime_error) << size;
+
+  // corrupted: bad checksum
+  for (size_t offset : {size_t(64), size_t(100), content.size() - 1}) {
+    string corrupted = content;
+    corrupted[offset] ^= 1;
+    EXPECT_THROW(Checkpoint::load(string_view(corrupted)), runtime_error) << offset;
+  }
+
+  // bad magic
+  string corrupted = content;
+  corrupted[0] = 'X';
+  EXPECT_THROW(Checkpoint::load(string_view(corrupted)), runtime_error);
+}
+
+TEST_F(CheckpointTest, resume) {
+  string tmp = poor_man_tmpnam("Checkpoint_resume");
+  auto ref = FuzzyCoco::searchBestFuzzySystem(DF, DFOUT.nbcols(), params, 6423);
+
+  Checkpoint::Options checkpoint;
+  checkpoint.filename = tmp;
+  checkpoint.interval = 3;
+
+  // with checkpoints: same results
+  auto desc = FuzzyCoco::searchBestFuzzySystem(DF, DFOUT.nbcols(), params, 6423, checkpoint);
+  EXPECT_EQ(desc, ref);
+  EXPECT_EQ(Checkpoint::load(path(tmp)).coevolutions.at(0).generation.generation_number, 10);
+
+  // interrupted after generation 6 or 7, then resumed (with a different seed, that is not used)
+  for (int nb : {6, 7}) {
+    FuzzyCocoParams interrupted = params;
+    interrupted.global_params.max_generations = nb;
+    remove(tmp);
+    checkpoint.resume = false;
+    FuzzyCoco::searchBestFuzzySystem(DF, DFOUT.nbcols(), interrupted, 6423, checkpoint);
+    EXPECT_EQ(Checkpoint::load(path(tmp)).coevolutions.at(0).generation.generation_number, nb);
+
+    checkpoint.resume = true;
+    desc = FuzzyCoco::searchBestFuzzySystem(DF, DFOUT.nbcols(), params, 1, checkpoint);
+    EXPECT_EQ(desc, ref) << nb;
+  }
+
+  // different params
+  params.global_params.nb_rules = 4;
+  EXPECT_THROW(FuzzyCoco::searchBestFuzzySystem(DF, DFOUT.nbcols(), params, 6423, checkpoint), runtime_error);
+  // the island model
+  params.global_params.nb_rules = 3;
+  params.global_params.nb_islands = 2;
+  EXPECT_THROW(FuzzyCoco::searchBestFuzzySystem(DF, DFOUT.nbcols(), params, 6423, checkpoint), runtime_error);
+
+  remove(tmp);
+}
+
+TEST_F(CheckpointTest, resume_islands) {
+  string tmp = poor_man_tmpnam("Checkpoint_resume_islands");
+  params.global_params.nb_islands = 3;
+  params.global_params.migration_interval = 4;
+  params.global_params.migration_topology = "random";
+  auto ref = FuzzyCoco::searchBestFuzzySystem(DF, DFOUT.nbcols(), params, 6423);
+
+  Checkpoint::Options checkpoint;
+  checkpoint.filename = tmp;
+  checkpoint.interval = 1;
+
+  // interrupted after generation 8 (i.e. just after a migration), or after generation 6
+  for (int nb : {8, 6}) {
+    FuzzyCocoParams interrupted = params;
+    interrupted.global_params.max_generations = nb;
+    checkpoint.resume = false;
+    FuzzyCoco::searchBestFuzzySystem(DF, DFOUT.nbcols(), interrupted, 6423, checkpoint);
+    EXPECT_EQ(Checkpoint::load(path(tmp)).coevolutions.size(), 3u);
+
+    checkpoint.resume = true;
+    params.global_params.nb_threads = 2;
+    auto desc = FuzzyCoco::searchBestFuzzySystem(DF, DFOUT.nbcols(), params, 1, checkpoint);
+    EXPECT_EQ(desc["fit"], ref["fit"]) << nb;
+    EXPECT_EQ(desc["fuzzy_system"], ref["fuzzy_system"]) << nb;
+    params.global_params.nb_threads = 1;
+    remove(tmp);
+  }
+}
@@ -0,0 +1,210 @@
+#include "tests.h"
+#include <cmath>
+#include <fstream>
+#include "csv_loader.h"
+#include "mapped_file.h"
+#include "file_utils.h"
+#include "random_generator.h"
+
+using namespace fuzzy_coco;
+using namespace FileUtils;
+
+string CSV_MESSY =
+R"(ID;VAR1;VAR2;OUT
+id1;1;PI;0
+
+id2;toto; 3.2;NA
+id3;-1e3;+4;1)" "\r\n" R"(id4;;.5;nan
+)";
+
+TEST(CsvLoader, parseNumber) {
+  EXPECT_EQ(CsvLoader::parseNumber("1"), 1);
+  EXPECT_EQ(CsvLoader::parseNumber(" 2.5"), 2.5);
+  EXPECT_EQ(CsvLoader::parseNumber("+3"), 3);
+  EXPECT_EQ(CsvLoader::parseNumber("-1e3"), -1000);
+  EXPECT_EQ(CsvLoader::parseNumber(".5"), 0.5);
+  // like stod(): trailing characters are ignored
+  EXPECT_EQ(CsvLoader::parseNumber("3abc"), 3);
+  EXPECT_EQ(CsvLoader::parseNumber("0 "), 0);
+  EXPECT_TRUE(std::isnan(CsvLoader::parseNumber("nan")));
+
+  for (string na : {"", " ", "NA", "toto", "PI", "+-1", "-", "1e999"})
+    EXPECT_TRUE(is_na(CsvLoader::parseNumber(na))) << na;
+}
+
+TEST(CsvLoader, splitLine) {
+  vector<string_view> tokens;
+  auto split = [&](string_view line) {
+    CsvLoader::splitLine(line, ';', tokens);
+    return vector<string>(tokens.begin(), tokens.end());
+  };
+  EXPECT_EQ(split("a;b;c"), vector<string>({"a", "b", "c"}));
+  EXPECT_EQ(split("a;;b"), vector<string>({"a", "", "b"}));
+  EXPECT_EQ(split(";a"), vector<string>({"", "a"}));
+  EXPECT_EQ(split("a;b;"), vector<string>({"a", "b"}));
+  EXPECT_EQ(split("a;b\r"), vector<string>({"a", "b"}));
+  EXPECT_EQ(split(";"), vector<string>({""}));
+  EXPECT_TRUE(split("").empty());
+  EXPECT_TRUE(split("\r").empty());
+
+  // long lines, to exercise the SIMD scan
+  string line;
+  vector<string> ref;
+  for (int i = 0; i < 100; i++) {
+    ref.push_back(string(i % 23, 'x'));
+    line += ref.back() + ",";
+  }
+  CsvLoader::splitLine(line, ',', tokens);
+  EXPECT_EQ(vector<string>(tokens.begin(), tokens.end()), ref);
+}
+
+TEST(CsvLoader, parse) {
+  // must be the same as the parseCSV() + DataFrame::assign() path
+  vector<vector<string>> tokens;
+  parseCSV(CSV_MESSY, tokens);
+  for (bool rownames : {true, false}) {
+    DataFrame ref(tokens, rownames);
+    DataFrame df = CsvLoader::parse(CSV_MESSY, rownames);
+    EXPECT_EQ(df.colnames(), ref.colnames());
+    EXPECT_EQ(df.rownames(), ref.rownames());
+    ASSERT_EQ(df.nbrows(), 4);
+    ASSERT_EQ(df.nbcols(), ref.nbcols());
+    for (int row = 0; row < df.nbrows(); row++)
+      for (int col = 0; col < df.nbcols(); col++) {
+        // N.B: NaN != NaN
+        if (std::isnan(ref.at(row, col))) EXPECT_TRUE(std::isnan(df.at(row, col)));
+        else EXPECT_EQ(df.at(row, col), ref.at(row, col));
+      }
+  }
+
+  DataFrame df = CsvLoader::parse(CSV_MESSY, true);
+  EXPECT_EQ(df.rownames(), vector<string>({"id1", "id2", "id3", "id4"}));
+  EXPECT_EQ(df.colnames(), vector<string>({"VAR1", "VAR2", "OUT"}));
+  EXPECT_TRUE(df.missing(0, 1));
+  EXPECT_TRUE(df.missing(1, 0));
+  EXPECT_EQ(df.at(1, 1), 3.2);
+  EXPECT_TRUE(df.missing(1, 2));
+  EXPECT_EQ(df.at(2, 1), 4);
+  EXPECT_EQ(df.at(2, 2), 1);
+  EXPECT_TRUE(df.missing(3, 0));
+
+  // header only
+  df = CsvLoader::parse("A;B\n\n", false);
+  EXPECT_EQ(df.nbrows(), 0);
+  EXPECT_EQ(df.nbcols(), 2);
+
+  EXPECT_THROW(CsvLoader::parse("", true), runtime_error);
+  EXPECT_THROW(CsvLoader::parse("\n\r\n", true), runtime_error);
+  EXPECT_THROW(CsvLoader::parse("A;B\n1;2\n3\n", false), runtime_error);
+  EXPECT_THROW(CsvLoader::parse("A;B\n1;2;3\n", false), runtime_error);
+
+  // another delimiter
+  df = CsvLoader::parse("A,B\n1,2\n", false, ',');
+  EXPECT_EQ(df.at(0, 1), 2);
+}
+
+// the results must not depend on the number of threads
+TEST(CsvLoader, parse_threads) {
+  RandomGenerator rng(666);
+  const int nbrows = 1000;
+  const int nbcols = 7;
+  string csv = "ID";
+  for (int col = 0; col < nbcols; col++) csv += ";V" + to_string(col);
+  csv += "\n";
+  for (int row = 0; row < nbrows; row++) {
+    csv += "row" + to_string(row);
+    for (int col = 0; col < nbcols; col++)
+      csv += ";" + (rng.random(0, 9) == 0 ? string("NA") : to_string(rng.randomReal(-100, 100)));
+    csv += rng.random(0, 9) == 0 ? "\n\n" : "\n";
+  }
+
+  const DataFrame ref = CsvLoader::parse(csv, true, ';', 1);
+  EXPECT_EQ(ref.nbrows(), nbrows);
+  EXPECT_EQ(ref.nbcols(), nbcols);
+  vector<vector<string>> tokens;
+  parseCSV(csv, tokens);
+  EXPECT_EQ(ref, DataFrame(tokens, true));
+  for (int nb_threads : {0, 2, 3, 8, 64})
+    EXPECT_EQ(CsvLoader::parse(csv, true, ';', nb_threads), ref) << nb_threads;
+
+  // without trailing newline
+  csv.pop_back();
+  EXPECT_EQ(CsvLoader::parse(csv, true, ';', 4), ref);
+}
+
+TEST(CsvChunkReader, next) {
+  const DataFrame ref = CsvLoader::parse(CSV_MESSY, true);
+  for (int chunk_size : {1, 2, 3, 4, 10}) {
+    istringstream in(CSV_MESSY);
+    CsvChunkReader reader(in, true);
+    EXPECT_EQ(reader.colnames(), ref.colnames());
+
+    DataFrame chunk;
+    int row = 0;
+    while (reader.next(chunk_size, chunk)) {
+      EXPECT_LE(chunk.nbrows(), chunk_size);
+      EXPECT_EQ(chunk.colnames(), ref.colnames());
+      for (int i = 0; i < chunk.nbrows(); i++, row++) {
+        EXPECT_EQ(chunk.rownames()[i], ref.rownames()[row]);
+        for (int col = 0; col < ref.nbcols(); col++)
+          if (!std::isnan(ref.at(row, col))) {
+            EXPECT_EQ(chunk.at(i, col), ref.at(row, col));
+          }
+      }
+    }
+    EXPECT_EQ(row, ref.nbrows());
+    EXPECT_EQ(reader.getNbRowsRead(), ref.nbrows());
+    EXPECT_FALSE(reader.next(chunk_size, chunk));
+  }
+
+  // float32 chunks
+  {
+    istringstream in(CSV_MESSY);
+    CsvChunkReader reader(in, true);
+    reader.setStorage(DataFrame::FLOAT32);
+    DataFrame chunk;
+    ASSERT_TRUE(reader.next(2, chunk));
+    EXPECT_EQ(chunk.getStorage(), DataFrame::FLOAT32);
+    EXPECT_EQ(chunk.at(1, 1), double(float(ref.at(1, 1))));
+  }
+
+  istringstream empty("\n\n");
+  EXPECT_THROW(CsvChunkReader(empty, true), runtime_error);
+  EXPECT_THROW(CsvChunkReader(path("file_that_does_not.exist"), true), filesystem_error);
+
+  istringstream bad("A;B\n1;2\n3\n");
+  CsvChunkReader reader(bad, false);
+  DataFrame chunk;
+  EXPECT_THROW(reader.next(10, chunk), runtime_error);
+}
+
+TEST(CsvLoader, load) {
+  EXPECT_THROW(CsvLoader::load("file_that_does_not.exist", true), filesystem_error);
+
+  string tmp = poor_man_tmpnam("CsvLoader_load");
+  {
+    ofstream out(tmp);
+    out << CSV_MESSY;
+  }
+  {
+    MappedFile file(tmp);
+    EXPECT_EQ(file.view(), CSV_MESSY);
+  }
+  DataFrame ref = CsvLoader::parse(CSV_MESSY, true);
+  DataFrame df = CsvLoader::load(tmp, true, ';', 2);
+  EXPECT_EQ(df.colnames(), ref.colnames());
+  EXPECT_EQ(df.rownames(), ref.rownames());
+  EXPECT_EQ(df.at(2, 0), -1000);
+  remove(tmp.c_str());
+
+  // empty file
+  {
+    ofstream out(tmp);
+  }
+  {
+    MappedFile file(tmp);
+    EXPECT_EQ(file.size(), 0);
+  }
+  EXPECT_THROW(CsvLoader::load(tmp, true), runtime_error);
+  remove(tmp.c_str());
+}
@@ -1,5 +1,7 @@
 #include "tests.h"
+#include <climits>
 #include <cstdio>
+#include <cstdint>
 #include <fstream>
 #include "file_utils.h"
 #include "dataframe.h"
@@ -202,6 +204,83 @@ TEST(df, set_reset) {
   EXPECT_TRUE(df.missing(1, 2));
 }
 
+TEST(df, aligned_storage) {
+  DataFrame df(5, 3);
+  EXPECT_EQ(df.getStorage(), DataFrame::FLOAT64);
+  EXPECT_EQ(df.stride(), 8);
+  EXPECT_EQ(DataFrame::paddedStride<double>(8), 8);
+  EXPECT_EQ(DataFrame::paddedStride<double>(9), 16);
+  EXPECT_EQ(DataFrame::paddedStride<float>(9), 16);
+  EXPECT_EQ(DataFrame::paddedStride<float>(17), 32);
+
+  for (int col = 0; col < df.nbcols(); col++) {
+    EXPECT_EQ(df[col].size(), 5);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(df[col].data()) % DataFrame::ALIGNMENT, 0);
+  }
+
+  df.setStorage(DataFrame::FLOAT32);
+  EXPECT_EQ(df.stride(), 16);
+  for (int col = 0; col < df.nbcols(); col++)
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(df[col].floatData()) % DataFrame::ALIGNMENT, 0);
+}
+
+TEST(df, cellOffset) {
+  DataFrame df(5, 3);
+  for (int col = 0; col < df.nbcols(); col++)
+    for (int row = 0; row < df.nbrows(); row++)
+      EXPECT_EQ(df[col].data() + row, df[0].data() + DataFrame::cellOffset(row, col, df.stride()));
+
+  // N.B: beyond 2^31 padded cells, e.g. 1M rows x 2200 columns, the offsets do not fit an int
+  const int stride = DataFrame::paddedStride<double>(1000000);
+  EXPECT_EQ(DataFrame::cellOffset(7, 2199, stride), size_t(2199) * size_t(stride) + 7);
+  EXPECT_GT(DataFrame::cellOffset(0, 2199, stride), size_t(INT_MAX));
+}
+
+TEST(df, float32) {
+  DataFrame df(CSV1, true);
+  df.set(1, 2, MISSING_DATA_DOUBLE);
+  DataFrame df32 = df;
+  df32.setStorage(DataFrame::FLOAT32);
+  EXPECT_TRUE(df32.isFloat());
+  EXPECT_TRUE(df32[0].isFloat());
+  EXPECT_EQ(df32.nbrows(), df.nbrows());
+  EXPECT_EQ(df32.nbcols(), df.nbcols());
+  EXPECT_EQ(df32.colnames(), df.colnames());
+
+  // the values are rounded to the float precision, the missing values are kept
+  for (int row = 0; row < df.nbrows(); row++)
+    for (int col = 0; col < df.nbcols(); col++) {
+      if (df.missing(row, col)) {
+        EXPECT_TRUE(df32.missing(row, col));
+      } else {
+        EXPECT_EQ(df32.at(row, col), double(float(df.at(row, col))));
+      }
+    }
+  EXPECT_TRUE(df32.missing(1, 2));
+  EXPECT_EQ(df32[2][1], MISSING_DATA_DOUBLE);
+
+  // back to doubles: same rounded values
+  DataFrame df64 = df32;
+  df64.setStorage(DataFrame::FLOAT64);
+  EXPECT_FALSE(df64.isFloat());
+  EXPECT_EQ(df64, df32);
+  EXPECT_NE(df64, df);
+
+  // the operations keep the storage
+  DataFrame sub = df32.subsetColumns(1, 2);
+  EXPECT_TRUE(sub.isFloat());
+  EXPECT_EQ(sub[0], df32[1]);
+  EXPECT_EQ(sub[1], df32[2]);
+
+  df32.fillCol(0, {1.5, MISSING_DATA_DOUBLE, 0.1, 4});
+  EXPECT_EQ(df32.at(0, 0), 1.5);
+  EXPECT_TRUE(df32.missing(1, 0));
+  EXPECT_EQ(df32.at(2, 0), double(0.1f));
+
+  df32.reset(2, 2);
+  EXPECT_TRUE(df32.isFloat());
+  EXPECT_EQ(df32.at(1, 1), 0);
+}
 
 TEST(df, fillRowCol) {
   DataFrame df(CSV1, true);
@@ -213,7 +292,7 @@ TEST(df, fillRowCol) {
   EXPECT_EQ(df.fetchRow(1), row);
 
   // fill Col
-  auto col2 = df[2];
+  NumColumn col2 = df[2];
   for (auto& e : col2) e+= 10;
  
   df.fillCol(0, col2);
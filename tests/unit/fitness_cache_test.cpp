@@ -0,0 +1,106 @@
+#include "tests.h"
+#include "fitness_cache.h"
+#include "coevolution_fitness.h"
+
+using namespace fuzzy_coco;
+
+TEST(FitnessCache, basic) {
+  Genome g1 = {true, false, true}, g2 = {false, false, true}, g3 = {true, true, true};
+  double fit = -1;
+
+  // disabled
+  FitnessCache disabled;
+  EXPECT_FALSE(disabled.enabled());
+  disabled.insert(g1, g2, 0.5);
+  EXPECT_EQ(disabled.size(), 0);
+  EXPECT_FALSE(disabled.lookup(g1, g2, fit));
+  EXPECT_EQ(disabled.getNbMisses(), 0);
+
+  FitnessCache cache(2);
+  EXPECT_TRUE(cache.enabled());
+  EXPECT_EQ(cache.capacity(), 2);
+
+  EXPECT_FALSE(cache.lookup(g1, g2, fit));
+  EXPECT_EQ(cache.getNbMisses(), 1);
+  cache.insert(g1, g2, 0.5);
+  EXPECT_EQ(cache.size(), 1);
+
+  EXPECT_TRUE(cache.lookup(g1, g2, fit));
+  EXPECT_EQ(fit, 0.5);
+  EXPECT_EQ(cache.getNbHits(), 1);
+  // order matters
+  EXPECT_FALSE(cache.lookup(g2, g1, fit));
+  EXPECT_EQ(cache.getNbMisses(), 2);
+
+  cache.insert(g2, g1, 0.7);
+  // g1,g2 is now the least recently used
+  EXPECT_TRUE(cache.lookup(g2, g1, fit));
+  EXPECT_EQ(fit, 0.7);
+
+  // evict g1,g2
+  cache.insert(g3, g3, 1);
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_FALSE(cache.lookup(g1, g2, fit));
+  EXPECT_TRUE(cache.lookup(g2, g1, fit));
+  EXPECT_TRUE(cache.lookup(g3, g3, fit));
+  EXPECT_EQ(fit, 1);
+
+  // shrink: keep the most recently used
+  cache.setCapacity(1);
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_TRUE(cache.lookup(g3, g3, fit));
+  EXPECT_FALSE(cache.lookup(g2, g1, fit));
+
+  cache.resetCounters();
+  EXPECT_EQ(cache.getNbHits(), 0);
+  EXPECT_EQ(cache.getNbMisses(), 0);
+
+  cache.clear();
+  EXPECT_EQ(cache.size(), 0);
+  EXPECT_FALSE(cache.lookup(g3, g3, fit));
+}
+
+TEST(FitnessCache, hash) {
+  Genome g1 = {true, false, true}, g2 = {false, false, true};
+  EXPECT_EQ(FitnessCache::hash(g1, g2), FitnessCache::hash(g1, g2));
+  EXPECT_NE(FitnessCache::hash(g1, g2), FitnessCache::hash(g2, g1));
+}
+
+class CountingFitness : public CoopCoevolutionFitnessMethod {
+public:
+  double fitnessImpl(const Genome& genome1, const Genome& genome2) override {
+    nb_calls++;
+    int aligned = 0;
+    int nb = genome1.size();
+    for (int i = 0; i < nb; i++)
+      aligned += (genome1[i] == genome2[i]);
+    return double(aligned) / nb; 
+  }
+  int nb_calls = 0;
+};
+
+TEST(FitnessCache, CoevolutionFitnessMethod) {
+  Genome g1 = {true, false, true, true}, g2 = {false, false, true, true}, g3 = {true, false, true, false};
+  Genomes cooperators = {g2, g3};
+
+  CountingFitness nocache;
+  double fit = nocache.coopFitness(true, g1, cooperators);
+  nocache.coopFitness(true, g1, cooperators);
+  EXPECT_EQ(nocache.nb_calls, 4);
+
+  CountingFitness fitter;
+  fitter.getFitnessCache().setCapacity(10);
+  EXPECT_EQ(fitter.coopFitness(true, g1, cooperators), fit);
+  EXPECT_EQ(fitter.nb_calls, 2);
+  EXPECT_EQ(fitter.coopFitness(true, g1, cooperators), fit);
+  EXPECT_EQ(fitter.nb_calls, 2);
+  EXPECT_EQ(fitter.getFitnessCache().getNbHits(), 2);
+  EXPECT_EQ(fitter.getFitnessCache().getNbMisses(), 2);
+
+  // other side
+  fitter.coopFitness(false, g1, cooperators);
+  EXPECT_EQ(fitter.nb_calls, 4);
+
+  EXPECT_EQ(fitter.getBestFitness(), nocache.getBestFitness());
+  EXPECT_EQ(fitter.getBest(), nocache.getBest());
+}
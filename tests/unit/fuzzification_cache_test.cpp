@@ -0,0 +1,98 @@
+#include "tests.h"
+#include <cstring>
+#include "fuzzification_cache.h"
+#include "fuzzy_system.h"
+#include "random_generator.h"
+
+using namespace fuzzy_coco;
+
+TEST(FuzzificationCache, fetch) {
+  FuzzyVariablesDB db(2, 3, 1, 2);
+  db.setPositions(Matrix<double>{{0, 5, 10}, {1, 2, 3}}, Matrix<double>{{0, 1}});
+  DataFrame df(4, 2);
+  df.fillCol(0, {-1, 2.5, MISSING_DATA_DOUBLE, 10});
+  df.fillCol(1, {1, 1.5, 2, 4});
+
+  FuzzificationCache cache(df);
+  EXPECT_EQ(&cache.getData(), &df);
+  EXPECT_EQ(cache.getNbCachedColumns(), 0);
+
+  const auto& col = cache.fetch(db, 0, 0);
+  EXPECT_EQ(cache.getNbCachedColumns(), 1);
+  ASSERT_EQ(col.size(), 4U);
+  EXPECT_DOUBLE_EQ(col[0], 1);
+  EXPECT_DOUBLE_EQ(col[1], 0.5);
+  EXPECT_TRUE(is_na(col[2]));
+  EXPECT_DOUBLE_EQ(col[3], 0);
+
+  // cached
+  cache.fetch(db, 0, 0);
+  EXPECT_EQ(cache.getNbCachedColumns(), 1);
+  EXPECT_EQ(cache.getNbComputedColumns(), 1);
+
+  for (int var_idx = 0; var_idx < 2; var_idx++)
+    for (int set_idx = 0; set_idx < 3; set_idx++) {
+      const auto& values = cache.fetch(db, var_idx, set_idx);
+      const auto& var = db.getInputVariable(var_idx);
+      for (int row = 0; row < df.nbrows(); row++) {
+        double value = df.at(row, var_idx);
+        double expected = is_na(value) ? MISSING_DATA_DOUBLE : var.fuzzify(set_idx, value);
+        EXPECT_EQ(values[row], expected);
+      }
+    }
+  EXPECT_EQ(cache.getNbCachedColumns(), 6);
+  EXPECT_EQ(cache.getNbComputedColumns(), 6);
+
+  // change the positions of var 1 only --> its columns are recomputed
+  db.setPositions(Matrix<double>{{0, 5, 10}, {1, 2, 5}}, Matrix<double>{{0, 1}});
+  cache.fetch(db, 0, 1);
+  EXPECT_EQ(cache.getNbComputedColumns(), 6);
+  EXPECT_DOUBLE_EQ(cache.fetch(db, 1, 2)[3], 2.0 / 3);
+  EXPECT_EQ(cache.getNbCachedColumns(), 4);
+  EXPECT_EQ(cache.getNbComputedColumns(), 7);
+
+  // invalidate
+  cache.invalidate();
+  EXPECT_EQ(cache.getNbCachedColumns(), 0);
+  cache.fetch(db, 0, 1);
+  EXPECT_EQ(cache.getNbCachedColumns(), 1);
+
+  // copy: not shared
+  FuzzificationCache cache2(cache);
+  EXPECT_EQ(&cache2.getData(), &df);
+  EXPECT_EQ(cache2.getNbCachedColumns(), 0);
+}
+
+TEST(FuzzificationCache, predict) {
+  const int nb_in_vars = 4, nb_sets = 3, nb_samples = 100;
+  RandomGenerator rng(123);
+  FuzzySystem fs(nb_in_vars, nb_sets, 1, nb_sets);
+
+  auto set_random_positions = [&]() {
+    Matrix<double> inpos(nb_in_vars, nb_sets), outpos(1, nb_sets);
+    for (auto& row : inpos) for (auto& pos : row) pos = rng.randomReal(0, 10);
+    for (auto& row : outpos) for (auto& pos : row) pos = rng.randomReal(0, 1);
+    fs.setVariablesSetPositions(inpos, outpos);
+  };
+
+  DataFrame df(nb_samples, nb_in_vars);
+  for (int row = 0; row < nb_samples; row++)
+    for (int col = 0; col < nb_in_vars; col++) 
+      df.set(row, col, rng.random(0, 19) == 0 ? MISSING_DATA_DOUBLE : rng.randomReal(0, 10));
+
+  FuzzificationCache cache(df);
+  for (int i = 0; i < 5; i++) {
+    fs.resetRules();
+    fs.addRule(FuzzyRule(fs.getDB(), {{0, 1}, {1, 2}}, {{0, 0}}));
+    fs.addRule(FuzzyRule(fs.getDB(), {{1, 2}, {3, rng.random(0, 2)}, {0, 1}}, {{0, 2}}));
+    fs.addRule(FuzzyRule(fs.getDB(), {{2, rng.random(0, 2)}}, {{0, 1}}));
+    set_random_positions();
+
+    auto ref = fs.predict(df);
+    auto predicted = fs.predict(cache);
+    // only the used (var, set) pairs are computed
+    EXPECT_LE(cache.getNbCachedColumns(), 5);
+    for (int row = 0; row < nb_samples; row++)
+      EXPECT_EQ(memcmp(ref[0].data() + row, predicted[0].data() + row, sizeof(double)), 0);
+  }
+}
@@ -0,0 +1,111 @@
+#include "tests.h"
+#include <cstring>
+#include <cmath>
+#include "fuzzify_kernels.h"
+#include "fuzzy_variable.h"
+#include "random_generator.h"
+
+using namespace fuzzy_coco;
+using namespace FuzzifyKernels;
+
+TEST(FuzzifyKernels, implementations) {
+  EXPECT_TRUE(is_supported(SCALAR));
+  EXPECT_TRUE(is_supported(best_implementation()));
+  EXPECT_EQ(implementation_name(SCALAR), "scalar");
+  EXPECT_EQ(implementation_name(AVX2), "avx2");
+  cerr << "best fuzzify implementation: " << implementation_name(best_implementation()) << endl;
+
+  EXPECT_EQ(set_kind(0, 3), FIRST_SET);
+  EXPECT_EQ(set_kind(1, 3), MIDDLE_SET);
+  EXPECT_EQ(set_kind(2, 3), LAST_SET);
+  EXPECT_EQ(set_kind(1, 2), LAST_SET);
+}
+
+// all implementations must give exactly the same results as FuzzyVariable::fuzzify()
+TEST(FuzzifyKernels, fuzzify) {
+  RandomGenerator rng(42);
+  const int nb_sets = 4;
+  FuzzyVariable var("var", nb_sets);
+
+  // N.B: odd size to test the remainders
+  const int nb = 101;
+  vector<double> values(nb), res(nb);
+  for (int iter = 0; iter < 50; iter++) {
+    // positions: possibly unsorted, duplicated or missing
+    for (int set_idx = 0; set_idx < nb_sets; set_idx++) {
+      double pos = rng.random(0, 9) == 0 ? MISSING_DATA_DOUBLE : rng.randomReal(0, 10);
+      if (set_idx > 0 && rng.random(0, 9) == 0) pos = var.getSet(set_idx - 1).getPosition();
+      var.getSet(set_idx).setPosition(pos);
+    }
+    for (int i = 0; i < nb; i++) {
+      const int pick = rng.random(0, 19);
+      if (pick == 0) values[i] = MISSING_DATA_DOUBLE;
+      else if (pick == 1) values[i] = NAN;
+      else if (pick == 2) values[i] = var.getSet(rng.random(0, nb_sets - 1)).getPosition();
+      else values[i] = rng.randomReal(-1, 11);
+    }
+
+    for (int set_idx = 0; set_idx < nb_sets; set_idx++) {
+      const double before = set_idx > 0 ? var.getSet(set_idx - 1).getPosition() : MISSING_DATA_DOUBLE;
+      const double after = set_idx < nb_sets - 1 ? var.getSet(set_idx + 1).getPosition() : MISSING_DATA_DOUBLE;
+      const double pos = var.getSet(set_idx).getPosition();
+
+      for (auto impl : {SCALAR, SSE41, AVX2}) {
+        if (!is_supported(impl)) continue;
+        fuzzify(impl, set_kind(set_idx, nb_sets), before, pos, after, values.data(), nb, res.data());
+        for (int i = 0; i < nb; i++) {
+          const double expected = is_na(values[i]) ? MISSING_DATA_DOUBLE : var.fuzzify(set_idx, values[i]);
+          EXPECT_EQ(memcmp(&expected, &res[i], sizeof(double)), 0) 
+            << implementation_name(impl) << " set=" << set_idx << " value=" << values[i] << " res=" << res[i] << " expected=" << expected;
+        }
+      }
+
+      // column-wise FuzzyVariable::fuzzify()
+      vector<double> res2;
+      var.fuzzify(set_idx, values, res2);
+      ASSERT_EQ(res2.size(), values.size());
+      for (int i = 0; i < nb; i++) {
+        const double expected = is_na(values[i]) ? MISSING_DATA_DOUBLE : var.fuzzify(set_idx, values[i]);
+        EXPECT_EQ(memcmp(&expected, &res2[i], sizeof(double)), 0);
+      }
+    }
+  }
+}
+
+// the float overloads must give exactly the same results as the double ones on the float-rounded values
+TEST(FuzzifyKernels, fuzzify_float) {
+  RandomGenerator rng(43);
+  const int nb_sets = 3;
+  FuzzyVariable var("var", nb_sets);
+  for (int set_idx = 0; set_idx < nb_sets; set_idx++)
+    var.getSet(set_idx).setPosition(1 + 4 * set_idx);
+
+  // N.B: odd size to test the remainders
+  const int nb = 37;
+  vector<float> fvalues(nb);
+  vector<double> values(nb), res(nb), expected(nb);
+  for (int i = 0; i < nb; i++) {
+    const int pick = rng.random(0, 9);
+    fvalues[i] = pick == 0 ? MISSING_DATA_FLOAT : (pick == 1 ? float(NAN) : float(rng.randomReal(-1, 11)));
+    values[i] = ColumnView::toDouble(fvalues[i]);
+  }
+  
+  for (int set_idx = 0; set_idx < nb_sets; set_idx++) {
+    const double before = set_idx > 0 ? var.getSet(set_idx - 1).getPosition() : MISSING_DATA_DOUBLE;
+    const double after = set_idx < nb_sets - 1 ? var.getSet(set_idx + 1).getPosition() : MISSING_DATA_DOUBLE;
+    const double pos = var.getSet(set_idx).getPosition();
+    const auto kind = set_kind(set_idx, nb_sets);
+    fuzzify(SCALAR, kind, before, pos, after, values.data(), nb, expected.data());
+
+    for (auto impl : {SCALAR, SSE41, AVX2}) {
+      if (!is_supported(impl)) continue;
+      fuzzify(impl, kind, before, pos, after, fvalues.data(), nb, res.data());
+      EXPECT_EQ(memcmp(expected.data(), res.data(), nb * sizeof(double)), 0) << implementation_name(impl);
+    }
+
+    // FuzzyVariable::fuzzify() on a float column
+    vector<double> res2;
+    var.fuzzify(set_idx, ColumnView(fvalues.data(), nb), res2);
+    EXPECT_EQ(memcmp(expected.data(), res2.data(), nb * sizeof(double)), 0);
+  }
+}
@@ -163,6 +163,9 @@ TEST(FuzzyCocoFitnessMethod, fitnessImpl) {
   EXPECT_TRUE(coco.getFitnessMethod().getBestFitness() < 0); // no fitness computed yet
 
   double fit = coco.getFitnessMethod().fitnessImpl();
+  // the fused metrics are identical to those computed from the predictions
+  auto& fitter = coco.getFitnessMethod();
+  EXPECT_EQ(fitter.fitMetrics(), fitter.computeMetrics(fs.predict(DFIN), DFOUT));
   // double fit = coco.getFitnessMethod().fitnessImpl(rules_geno, vars_geno);
   EXPECT_DOUBLE_EQ(fit, 1);
 
@@ -205,6 +208,7 @@ TEST(FuzzyCocoFitnessMethod, fitnessImpl) {
   fs.setDefaultRule(FuzzyDefaultRule::load(R"("Tourists":"High")", db));
 
   fit = coco.getFitnessMethod().fitnessImpl();
+  EXPECT_EQ(fitter.fitMetrics(), fitter.computeMetrics(fs.predict(DFIN), DFOUT));
 
   cerr << "fit=" << fit << endl;
 
@@ -92,6 +92,7 @@ TEST(EvolutionParams, IO) {
   p.pop_size = 1000;
   p.mut_flip_genome = 0.000001;
   p.mut_flip_bit = MISSING_DATA_DOUBLE;
+  p.mut_geometric_sampling = true;
 
   auto desc = p.describe();
   EvolutionParams p2(desc);
@@ -131,6 +132,16 @@ TEST(GlobalParams, IO) {
   p.nb_max_var_per_rule = -1;
   p.influence_rules_initial_population = true; 
   p.influence_evolving_ratio = -1.5;
+  p.fitness_cache_size = 7;
+  p.nb_threads = 3;
+  p.t_norm = "product";
+  p.nb_islands = 4;
+  p.migration_interval = 3;
+  p.migration_topology = "random";
+  p.nb_migrants = 2;
+  p.max_seconds = 1.5;
+  p.max_evaluations = 1e6;
+  p.stagnation_generations = 20;
 
   auto desc = p.describe();
   cerr << desc;
@@ -148,6 +159,41 @@ TEST(GlobalParams, IO) {
   EXPECT_EQ(p3, expected);
 }
 
+TEST(GlobalParams, bad_t_norm) {
+  NamedList desc;
+  desc.add("t_norm", "max");
+  EXPECT_THROW(GlobalParams p(desc), runtime_error);
+}
+
+TEST(GlobalParams, bad_islands) {
+  for (auto name : {"nb_islands", "migration_interval"}) {
+    NamedList desc;
+    desc.add(name, 0);
+    EXPECT_THROW(GlobalParams p(desc), runtime_error) << name;
+  }
+  NamedList desc;
+  desc.add("migration_topology", "star");
+  EXPECT_THROW(GlobalParams p(desc), runtime_error);
+
+  EXPECT_EQ(parseMigrationTopology("ring"), MigrationTopology::RING);
+  EXPECT_EQ(parseMigrationTopology("random"), MigrationTopology::RANDOM);
+}
+
+TEST(GlobalParams, bad_stopping_criteria) {
+  for (auto name : {"max_seconds", "max_evaluations", "stagnation_generations"}) {
+    NamedList desc;
+    desc.add(name, -1);
+    EXPECT_THROW(GlobalParams p(desc), runtime_error) << name;
+  }
+  // integers are accepted for the numeric params
+  NamedList desc;
+  desc.add("max_seconds", 10);
+  desc.add("max_evaluations", 1000);
+  GlobalParams p(desc);
+  EXPECT_EQ(p.max_seconds, 10);
+  EXPECT_EQ(p.max_evaluations, 1000);
+}
+
 TEST(FitnessParams, convertFeaturesWeights) {
   vector<string> input_vars = { "toto", "titi", "tata" };
   
@@ -169,6 +169,29 @@ TEST_F(FuzzyCocoTest, searchBestFuzzySystem) {
 
 }
 
+TEST_F(FuzzyCocoTest, nb_threads) {
+  FuzzyCocoParams params = GET_SAMPLE_PARAMS(DFIN.nbcols());
+  params.global_params.max_generations = 20;
+  params.global_params.max_fitness = 2; // never early-stop
+
+  auto ref = FuzzyCoco::searchBestFuzzySystem(DF, DFOUT.nbcols(), params, 6423);
+
+  // the results must not depend on the number of threads
+  for (int nb_threads : {2, 4, 0}) {
+    params.global_params.nb_threads = nb_threads;
+    auto desc = FuzzyCoco::searchBestFuzzySystem(DF, DFOUT.nbcols(), params, 6423);
+    EXPECT_EQ(desc["fit"], ref["fit"]);
+    EXPECT_EQ(desc["fuzzy_system"], ref["fuzzy_system"]);
+  }
+
+  // also without the fitness cache
+  params.global_params.fitness_cache_size = 0;
+  params.global_params.nb_threads = 3;
+  auto desc = FuzzyCoco::searchBestFuzzySystem(DF, DFOUT.nbcols(), params, 6423);
+  EXPECT_EQ(desc["fit"], ref["fit"]);
+  EXPECT_EQ(desc["fuzzy_system"], ref["fuzzy_system"]);
+}
+
 TEST_F(FuzzyCocoTest, predict_save_load) {
   FuzzyCocoParams params = GET_SAMPLE_PARAMS(DFIN.nbcols());
   RandomGenerator rng(6423);
@@ -210,6 +233,29 @@ cerr << temp_fuzzy_system << endl;
     auto df2 = FuzzyCoco::loadAndPredict(DFIN, temp_fuzzy_system);
     EXPECT_EQ(df2, FuzzyCoco::loadAndPredict(DFIN, loaded));
 
+    // ================== loadAndPredictByChunks ===========================
+    ostringstream ref;
+    writeCSV(ref, FuzzyCoco::loadAndPredict(DF, loaded));
+    string temp_data = poor_man_tmpnam("predict_by_chunks");
+    {
+      ofstream data_out(temp_data);
+      data_out << CSV;
+    }
+    for (int chunk_size : {1, 3, 100})
+      for (int nb_threads : {1, 3}) {
+        ostringstream out;
+        EXPECT_EQ(FuzzyCoco::loadAndPredictByChunks(temp_data, temp_fuzzy_system, out, chunk_size, nb_threads), DF.nbrows());
+        EXPECT_EQ(out.str(), ref.str()) << chunk_size << "," << nb_threads;
+      }
+    // float32: same as predicting the whole float32 dataset
+    DataFrame df32 = DF;
+    df32.setStorage(DataFrame::FLOAT32);
+    ostringstream ref32, out32;
+    writeCSV(ref32, FuzzyCoco::loadAndPredict(df32, loaded));
+    FuzzyCoco::loadAndPredictByChunks(temp_data, temp_fuzzy_system, out32, 3, 2, DataFrame::FLOAT32);
+    EXPECT_EQ(out32.str(), ref32.str());
+    remove(temp_data);
+
     // ================== evalAndSave ===========================
     ostringstream oss;
     FuzzyCoco::evalAndSave(DF, temp_fuzzy_system, oss);
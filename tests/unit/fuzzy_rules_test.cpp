@@ -64,6 +64,34 @@ TEST(FuzzyOperatorAND, operate) {
     EXPECT_DOUBLE_EQ(op.operate(MISSING_DATA_DOUBLE, MISSING_DATA_DOUBLE), MISSING_DATA_DOUBLE);
 }
 
+TEST(TNorm, operate) {
+    EXPECT_DOUBLE_EQ(TNormMin::operate(0.2, 0.5), 0.2);
+    EXPECT_DOUBLE_EQ(TNormProduct::operate(0.2, 0.5), 0.1);
+    EXPECT_DOUBLE_EQ(TNormLukasiewicz::operate(0.7, 0.5), 0.2);
+    EXPECT_DOUBLE_EQ(TNormLukasiewicz::operate(0.2, 0.5), 0);
+
+    // missing data: same behaviour for all t-norms
+    EXPECT_DOUBLE_EQ(TNormProduct::operate(MISSING_DATA_DOUBLE, 0.4), 0.4);
+    EXPECT_DOUBLE_EQ(TNormProduct::operate(0.4, MISSING_DATA_DOUBLE), 0.4);
+    EXPECT_DOUBLE_EQ(TNormLukasiewicz::operate(MISSING_DATA_DOUBLE, 0.4), 0.4);
+    EXPECT_DOUBLE_EQ(TNormLukasiewicz::operate(0.4, MISSING_DATA_DOUBLE), 0.4);
+    EXPECT_TRUE(is_na(TNormProduct::operate(MISSING_DATA_DOUBLE, MISSING_DATA_DOUBLE)));
+    EXPECT_TRUE(is_na(TNormLukasiewicz::operate(MISSING_DATA_DOUBLE, MISSING_DATA_DOUBLE)));
+
+    // names
+    for (auto tnorm : {TNorm::MIN, TNorm::PRODUCT, TNorm::LUKASIEWICZ})
+        EXPECT_EQ(parseTNorm(toString(tnorm)), tnorm);
+    EXPECT_THROW(parseTNorm("max"), runtime_error);
+}
+
+TEST(FuzzyRule, combineFireLevels) {
+    vector<double> levels = {0.8, 0.5, MISSING_DATA_DOUBLE, 0.9};
+    EXPECT_DOUBLE_EQ(FuzzyRule::combineFireLevels(levels), 0.5);
+    EXPECT_DOUBLE_EQ(FuzzyRule::combineFireLevels(levels, TNorm::MIN), 0.5);
+    EXPECT_DOUBLE_EQ(FuzzyRule::combineFireLevels(levels, TNorm::PRODUCT), 0.8 * 0.5 * 0.9);
+    EXPECT_DOUBLE_EQ(FuzzyRule::combineFireLevels(levels, TNorm::LUKASIEWICZ), max(0.0, 0.8 + 0.5 - 1 + 0.9 - 1));
+}
+
 // cf coco book pp26 fig 1.12
 string FUZZY_SYSTEM_112 = R"(
 {
@@ -276,6 +304,39 @@ TEST_F(FuzzyRuleTest112, fuzzify_evaluateFireLevel)
   EXPECT_DOUBLE_EQ(rule2.evaluateFireLevel(df, 1), rule2.evaluateFireLevel({df.at(1, 0), df.at(1, 1)}));
 }
 
+TEST_F(FuzzyRuleTest112, evaluateFireLevels_tnorms)
+{
+  ConditionIndexes cis = {{0, 1}, {1, 1}};
+  auto range = FuzzyRulesTable::asRange(cis);
+  // input vars fuzzy values: 2/3 and 0.8
+  vector<double> values = {19, 60};
+  EXPECT_DOUBLE_EQ(FuzzyRule::evaluateFireLevel(DB, range, values, TNorm::MIN), 2.0 / 3);
+  EXPECT_DOUBLE_EQ(FuzzyRule::evaluateFireLevel(DB, range, values, TNorm::PRODUCT), 2.0 / 3 * 0.8);
+  EXPECT_DOUBLE_EQ(FuzzyRule::evaluateFireLevel(DB, range, values, TNorm::LUKASIEWICZ), 2.0 / 3 + 0.8 - 1);
+
+  DataFrame df;
+  df.reset(3, 2);
+  df.set(0, 0, 19);
+  df.set(0, 1, 60);
+  df.set(1, 0, 25);
+  df.set(1, 1, 37);
+  df.set(2, 0, MISSING_DATA_DOUBLE);
+  df.set(2, 1, 45);
+
+  // the batch kernels give the same results as the row by row evaluation
+  FuzzificationCache cache(df);
+  for (auto tnorm : {TNorm::MIN, TNorm::PRODUCT, TNorm::LUKASIEWICZ}) {
+    vector<double> levels, cached_levels;
+    FuzzyRule::evaluateFireLevels(DB, range, df, levels, tnorm);
+    FuzzyRule::evaluateFireLevels(DB, range, cache, cached_levels, tnorm);
+    ASSERT_EQ(levels.size(), 3);
+    for (int row = 0; row < 3; row++) {
+      EXPECT_DOUBLE_EQ(levels[row], FuzzyRule::evaluateFireLevel(DB, range, df, row, tnorm));
+      EXPECT_DOUBLE_EQ(cached_levels[row], levels[row]);
+    }
+  }
+}
+
 TEST_F(FuzzyRuleTest112, missingData) {
     // ========= missing data with only one input condition
     FuzzyRule rule1(DB);
@@ -342,3 +403,50 @@ TEST(FuzzyRule, filterConditionIndexesWhenFixedVars) {
     auto good2 = FuzzyRule::filterConditionIndexesWhenFixedVars(2, good);
     EXPECT_EQ(good2.size(), 1);
 }
+
+TEST(FuzzyRulesTable, basic) {
+    FuzzyRulesTable table;
+    EXPECT_EQ(table.getNbRules(), 0);
+    EXPECT_EQ(table.getNbInputConditions(), 0);
+
+    table.addRule({{0, 1}, {2, 0}}, {{0, 2}});
+    table.addRule({{1, 1}}, {{0, 0}, {1, 1}});
+    EXPECT_EQ(table.getNbRules(), 2);
+    EXPECT_EQ(table.getNbInputConditions(), 3);
+    EXPECT_EQ(table.getInputConditions(0).toConditionIndexes(), ConditionIndexes({{0, 1}, {2, 0}}));
+    EXPECT_EQ(table.getOutputConditions(0).toConditionIndexes(), ConditionIndexes({{0, 2}}));
+    EXPECT_EQ(table.getInputConditions(1).toConditionIndexes(), ConditionIndexes({{1, 1}}));
+    EXPECT_EQ(table.getOutputConditions(1).toConditionIndexes(), ConditionIndexes({{0, 0}, {1, 1}}));
+
+    // setRule
+    table.setRule(0, {{2, 2}}, {{1, 0}, {0, 1}});
+    EXPECT_EQ(table.getInputConditions(0).toConditionIndexes(), ConditionIndexes({{2, 2}}));
+    EXPECT_EQ(table.getOutputConditions(0).toConditionIndexes(), ConditionIndexes({{1, 0}, {0, 1}}));
+    EXPECT_EQ(table.getInputConditions(1).toConditionIndexes(), ConditionIndexes({{1, 1}}));
+    EXPECT_EQ(table.getOutputConditions(1).toConditionIndexes(), ConditionIndexes({{0, 0}, {1, 1}}));
+
+    table.clear();
+    EXPECT_EQ(table.getNbRules(), 0);
+    EXPECT_EQ(table.getNbInputConditions(), 0);
+}
+
+TEST(FuzzyRulesTable, addFilteredRule) {
+    FuzzyRulesTable table;
+    // same filtering as FuzzyRule::filterConditionIndexes()
+    ConditionIndexes cis = {{2, 1}, {0, 2}, {2, 1}, {0, 1}, {-1, 0}, {5, 0}, {0, -1}, {0, 4}, {4, 4}};
+    EXPECT_TRUE(table.addFilteredRule(cis, 3, 3, cis, 3, 3));
+    EXPECT_EQ(table.getInputConditions(0).toConditionIndexes(), FuzzyRule::filterConditionIndexes(3, 3, cis));
+    EXPECT_EQ(table.getOutputConditions(0).toConditionIndexes(), FuzzyRule::filterConditionIndexes(3, 3, cis));
+
+    // no good output condition: the rule is not added
+    EXPECT_FALSE(table.addFilteredRule(cis, 3, 3, {{-1, 0}, {5, 0}}, 3, 3));
+    // no good input condition
+    EXPECT_FALSE(table.addFilteredRule({{0, 4}}, 3, 3, cis, 3, 3));
+    EXPECT_EQ(table.getNbRules(), 1);
+    EXPECT_EQ(table.getNbInputConditions(), 2);
+
+    EXPECT_TRUE(table.addFilteredRule({{1, 0}, {1, 2}}, 3, 3, {{0, 0}}, 1, 3));
+    EXPECT_EQ(table.getNbRules(), 2);
+    EXPECT_EQ(table.getInputConditions(1).toConditionIndexes(), ConditionIndexes({{1, 0}}));
+    EXPECT_EQ(table.getOutputConditions(1).toConditionIndexes(), ConditionIndexes({{0, 0}}));
+}
@@ -1,13 +1,28 @@
 #include "tests.h"
 #include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <thread>
 #include "file_utils.h"
 #include "fuzzy_system.h"
+#include "random_generator.h"
 #include "logging_logger.h"
 
 using namespace fuzzy_coco;
 using namespace FileUtils;
 using namespace logging;
 
+// count the heap allocations, cf predictSample_no_alloc
+static atomic<long> NB_ALLOCS(0);
+void* operator new(size_t size) {
+  NB_ALLOCS++;
+  if (void* p = malloc(size ? size : 1)) return p;
+  throw bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
 string CSV = 
 R"(Days;Temperature;Sunshine;Tourists
 day1;19;20;17
@@ -243,9 +258,11 @@ TEST_F(FuzzySystemTestNoThreshold, computeRulesImplications) {
   EXPECT_EQ(res, expected);
 
   // === now let's change the output rules so that they all use the same output set
-  fs.getRule(0).setOutputConditions({{0, 1}});
-  fs.getRule(1).setOutputConditions({{0, 1}});
-  fs.getRule(2).setOutputConditions({{0, 1}});
+  for (int i = 0; i < 3; i++) {
+    FuzzyRule rule = fs.getRule(i);
+    rule.setOutputConditions({{0, 1}});
+    fs.setRule(i, rule);
+  }
 
   // now all rules impact the SAME output set
   fire_levels = { 0.2, 0.4, 1};
@@ -337,8 +354,12 @@ TEST(FuzzySystem, computeOutputVarsMaxFireLevels) {
   EXPECT_TRUE(is_na(res[1]));
 
   // change the rules out conditions
-  fs.getRule(0).setOutputConditions( {{0, 0}, {0, 1}} );
-  fs.getRule(1).setOutputConditions( {{1, 1}, {1, 0}} );
+  FuzzyRule rule0 = fs.getRule(0);
+  rule0.setOutputConditions( {{0, 0}, {0, 1}} );
+  fs.setRule(0, rule0);
+  FuzzyRule rule1 = fs.getRule(1);
+  rule1.setOutputConditions( {{1, 1}, {1, 0}} );
+  fs.setRule(1, rule1);
 
   fire_levels = { 0.2, 0.4 };
   fs.computeOutputVarsMaxFireLevels(fire_levels, res);
@@ -473,6 +494,101 @@ TEST_F(FuzzySystemTestNoThreshold, predict) {
     EXPECT_DOUBLE_EQ(predicted[0][i], expected[i]);
 }
 
+// the batch predict() must give exactly the same results as predictSample()
+TEST(FuzzySystem, predict_vs_predictSample) {
+  const int nb_in_vars = 5, nb_in_sets = 3, nb_out_vars = 2, nb_out_sets = 3;
+  const int nb_samples = 200;
+  RandomGenerator rng(666);
+  auto random_or_na = [&rng](double min, double max) {
+    return rng.random(0, 9) == 0 ? MISSING_DATA_DOUBLE : rng.randomReal(min, max);
+  };
+
+  FuzzySystem fs(nb_in_vars, nb_in_sets, nb_out_vars, nb_out_sets);
+  Matrix<double> inpos(nb_in_vars, nb_in_sets), outpos(nb_out_vars, nb_out_sets);
+  // N.B: unsorted positions, some missing
+  for (auto& row : inpos) for (auto& pos : row) pos = random_or_na(0, 10);
+  for (auto& row : outpos) for (auto& pos : row) pos = random_or_na(0, 1);
+  // make some positions coincide with the data
+  inpos[0][1] = 5;
+  fs.setVariablesSetPositions(inpos, outpos);
+
+  const int nb_rules = 8;
+  fs.resetRules(nb_rules);
+  for (int i = 0; i < nb_rules; i++) {
+    ConditionIndexes in, out;
+    for (int j = rng.random(1, 3); j > 0; j--) in.push_back({rng.random(0, nb_in_vars - 1), rng.random(0, nb_in_sets - 1)});
+    for (int j = rng.random(1, 2); j > 0; j--) out.push_back({rng.random(0, nb_out_vars - 1), rng.random(0, nb_out_sets - 1)});
+    fs.addRule(FuzzyRule(fs.getDB(), in, out, true));
+  }
+  fs.setDefaultRulesConditions({1, 2});
+
+  DataFrame df(nb_samples, nb_in_vars);
+  for (int row = 0; row < nb_samples; row++)
+    for (int col = 0; col < nb_in_vars; col++) 
+      df.set(row, col, row % 17 == 0 ? 5 : random_or_na(-1, 11));
+
+  auto predicted = fs.predict(df);
+  ASSERT_EQ(predicted.nbrows(), nb_samples);
+  ASSERT_EQ(predicted.nbcols(), nb_out_vars);
+
+  vector<double> defuzzed;
+  for (int row = 0; row < nb_samples; row++) {
+    fs.predictSample(row, df, defuzzed);
+    for (int col = 0; col < nb_out_vars; col++) {
+      // N.B: bitwise equality
+      EXPECT_EQ(memcmp(&defuzzed[col], predicted[col].data() + row, sizeof(double)), 0) << row << "," << col;
+    }
+  }
+
+  // no samples
+  predicted = fs.predict(DataFrame(0, nb_in_vars));
+  EXPECT_EQ(predicted.nbrows(), 0);
+  EXPECT_EQ(predicted.nbcols(), nb_out_vars);
+}
+
+// once warmed-up, predictSample() must not allocate any memory
+TEST_F(FuzzySystemTestNoThreshold, predictSample_no_alloc) {
+  FuzzySystem fs = FS_NO_THRESHOLD;
+  vector<double> defuzzed;
+  // warm-up
+  fs.predictSample(0, DFIN, defuzzed);
+  auto expected = fs.predict(DFIN);
+
+  vector<double> res(DFIN.nbrows());
+  const long nb_allocs = NB_ALLOCS;
+  for (int row = 0; row < DFIN.nbrows(); row++) {
+    fs.predictSample(row, DFIN, defuzzed);
+    res[row] = defuzzed[0];
+  }
+  EXPECT_EQ(NB_ALLOCS - nb_allocs, 0);
+
+  for (int row = 0; row < DFIN.nbrows(); row++)
+    EXPECT_DOUBLE_EQ(res[row], expected[0][row]);
+}
+
+// the fused prediction: defuzzified values produced without building a DataFrame, nor allocating once warmed-up
+TEST_F(FuzzySystemTestNoThreshold, defuzzifyVariableBatch_no_alloc) {
+  FuzzySystem fs = FS_NO_THRESHOLD;
+  FuzzificationCache cache(DFIN);
+  auto expected = fs.predict(DFIN);
+  const int nb = DFIN.nbrows();
+
+  vector<double> res(nb);
+  const auto& results = fs.getState().batch_output_sets_results;
+  auto store = [&](int i, double value) { res[i] = value; };
+  // warm-up
+  EXPECT_EQ(fs.computeOutputSetsResultsBatch(cache), nb);
+  fs.defuzzifyVariableBatch(results, 0, nb, store);
+
+  const long nb_allocs = NB_ALLOCS;
+  EXPECT_EQ(fs.computeOutputSetsResultsBatch(cache), nb);
+  fs.defuzzifyVariableBatch(results, 0, nb, store);
+  EXPECT_EQ(NB_ALLOCS - nb_allocs, 0);
+
+  for (int row = 0; row < nb; row++)
+    EXPECT_DOUBLE_EQ(res[row], expected[0][row]);
+}
+
 TEST_F(FuzzySystemTestNoThreshold, smartPredict) {
   FuzzySystem fs = FS_NO_THRESHOLD;
 
@@ -517,4 +633,53 @@ TEST_F(FuzzySystemTestNoThreshold, load) {
 
   auto fs3 = FuzzySystem::load(fs2.describe());
   EXPECT_EQ(fs3.describe(), desc);
+
+  // t-norm: only described if not the default
+  EXPECT_FALSE(desc.has("t_norm"));
+  fs.setTNorm(TNorm::PRODUCT);
+  auto fs4 = FuzzySystem::load(fs.describe());
+  EXPECT_EQ(fs4.getTNorm(), TNorm::PRODUCT);
+  EXPECT_EQ(fs4.describe(), fs.describe());
+  EXPECT_FALSE(fs4.describe() == desc);
+}
+
+TEST_F(FuzzySystemTestNoThreshold, describe_shared) {
+  // a const FuzzySystem shared by several threads (cf PredictionServer): describe() must not modify it
+  const FuzzySystem fs = FS_NO_THRESHOLD;
+  const auto ref = fs.describe();
+  vector<NamedList> descs(4);
+  vector<thread> threads;
+  for (size_t i = 0; i < descs.size(); i++)
+    threads.emplace_back([&, i] { descs[i] = fs.describe(); });
+  for (auto& t : threads) t.join();
+  for (const auto& desc : descs)
+    EXPECT_EQ(desc, ref);
+  EXPECT_EQ(fs.getRule(1), fs.getRules()[1]);
+}
+
+TEST(FuzzySystem, tnorm_predict) {
+  FuzzySystem fs({"Temperature", "Sunshine"}, {"Tourists"}, 3, 3);
+  fs.getDB().setPositions({{17, 20, 29}, {30, 50, 100}}, {{0, 50, 100}});
+  fs.addRule(FuzzyRule(fs.getDB(), {{0, 1}, {1, 1}}, {{0, 1}}));
+  fs.setDefaultRulesConditions({0});
+
+  DataFrame df(1, 2);
+  df.fillRow(0, {19, 60});
+  // fire levels 2/3 and 0.8
+  const double min_level = fs.computeRulesFireLevels({19, 60})[0];
+  EXPECT_DOUBLE_EQ(min_level, 2.0 / 3);
+  auto min_pred = fs.predict(df);
+
+  fs.setTNorm(TNorm::PRODUCT);
+  EXPECT_DOUBLE_EQ(fs.computeRulesFireLevels({19, 60})[0], 2.0 / 3 * 0.8);
+  auto prod_pred = fs.predict(df);
+  EXPECT_NE(prod_pred.at(0, 0), min_pred.at(0, 0));
+
+  // the batch and sample predictions agree for each t-norm
+  for (auto tnorm : {TNorm::MIN, TNorm::PRODUCT, TNorm::LUKASIEWICZ}) {
+    fs.setTNorm(tnorm);
+    vector<double> defuzzed;
+    fs.predictSample(0, df, defuzzed);
+    EXPECT_DOUBLE_EQ(fs.predict(df).at(0, 0), defuzzed[0]);
+  }
 }
\ No newline at end of file
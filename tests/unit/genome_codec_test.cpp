@@ -204,6 +204,29 @@ TEST(RulesCodec, basic) {
   EXPECT_EQ(res1, rules_in);
   EXPECT_EQ(res2, rules_out);
   EXPECT_EQ(res3, default_rules);
+
+  // using the precomputed fields table
+  EXPECT_EQ(codec.getFieldsDecoder().size(), codec.size());
+  EXPECT_EQ(codec.getFieldsDecoder().getNbFields(), (3 * 2 + 2 * 2) * nb_rules + 2);
+  vector<int> fields;
+  vector<ConditionIndexes> res4, res5;
+  vector<int> res6;
+  codec.decode(bits, fields, res4, res5, res6);
+  EXPECT_EQ(res4, rules_in);
+  EXPECT_EQ(res5, rules_out);
+  EXPECT_EQ(res6, default_rules);
+
+  // random genomes
+  RandomGenerator rng(666);
+  for (int i = 0; i < 10; i++) {
+    randomize(bits, rng);
+    auto cit = bits.cbegin();
+    codec.decode(cit, res1, res2, res3);
+    codec.decode(bits, fields, res4, res5, res6);
+    EXPECT_EQ(res4, res1);
+    EXPECT_EQ(res5, res2);
+    EXPECT_EQ(res6, res3);
+  }
 }
 
 TEST(DiscretizedFuzzySystemSetPositionsCodec, basic) {
@@ -267,4 +290,22 @@ TEST(DiscretizedFuzzySystemSetPositionsCodec, basic) {
 
   EXPECT_EQ(res1, pos_in2);
   EXPECT_EQ(res2, pos_out2);
+
+  // using the precomputed fields table
+  vector<int> fields;
+  Matrix<double> res3, res4;
+  codec.decode(bits, fields, res3, res4);
+  EXPECT_EQ(res3, pos_in2);
+  EXPECT_EQ(res4, pos_out2);
+
+  // random genomes
+  RandomGenerator rng(666);
+  for (int i = 0; i < 10; i++) {
+    randomize(bits, rng);
+    auto cit = bits.cbegin();
+    codec.decode(cit, res1, res2);
+    codec.decode(bits, fields, res3, res4);
+    EXPECT_EQ(res3, res1);
+    EXPECT_EQ(res4, res2);
+  }
 }
@@ -0,0 +1,110 @@
+#include "tests.h"
+#include "island_model.h"
+
+using namespace fuzzy_coco;
+
+string CSV =
+R"(Days;Temperature;Sunshine;Tourists
+day1;19;25;55
+day2;40;99;95
+day3;24;NA;70
+day4;5;3;2
+day5;31;60;80
+day6;12;NA;20
+)";
+
+class IslandModelTest : public testing::Test {
+protected:
+  IslandModelTest() : DF(CSV, true) {}
+
+  void SetUp() override {
+    DFIN = DF.subsetColumns(0, DF.nbcols() - 2);
+    DFOUT = DF.subsetColumns(DF.nbcols() - 1, DF.nbcols() - 1);
+
+    params.global_params.nb_rules = 3;
+    params.global_params.nb_max_var_per_rule = DFIN.nbcols();
+    params.global_params.max_generations = 12;
+    params.global_params.max_fitness = 2; // never early-stop
+    params.global_params.nb_islands = 3;
+    params.global_params.migration_interval = 4;
+    params.input_vars_params.nb_bits_pos = 8;
+    params.output_vars_params.nb_bits_pos = 2;
+    params.fitness_params.output_vars_defuzz_thresholds.push_back(50);
+    params.rules_params.pop_size = 10;
+    params.mfs_params.pop_size = 20;
+    params.evaluate_missing(DFIN.nbcols(), 1);
+  }
+
+  DataFrame DF, DFIN, DFOUT;
+  FuzzyCocoParams params;
+};
+
+TEST(IslandModel, replaceWorst) {
+  Genomes genomes(5, Genome(4, false));
+  Generation gen(genomes, 2);
+  gen.fitnesses = {0.5, 0.1, 0.9, 0.1, 0.3};
+
+  Genomes immigrants(3, Genome(4, true));
+  IslandModel::replaceWorst(gen, immigrants);
+  // the 2 ties (1 and 3) then the next worst (4)
+  for (int i : {1, 3, 4}) EXPECT_EQ(gen.individuals[i], Genome(4, true)) << i;
+  for (int i : {0, 2}) EXPECT_EQ(gen.individuals[i], Genome(4, false)) << i;
+}
+
+TEST_F(IslandModelTest, selectDestinations) {
+  IslandModel ring(DFIN, DFOUT, params, 123);
+  EXPECT_EQ(ring.selectDestinations(), vector<int>({1, 2, 0}));
+
+  params.global_params.migration_topology = "random";
+  params.global_params.nb_islands = 5;
+  IslandModel random(DFIN, DFOUT, params, 123);
+  for (int k = 0; k < 20; k++) {
+    auto dst = random.selectDestinations();
+    for (int i = 0; i < 5; i++) {
+      EXPECT_NE(dst[i], i);
+      EXPECT_GE(dst[i], 0);
+      EXPECT_LT(dst[i], 5);
+    }
+  }
+}
+
+TEST_F(IslandModelTest, migrate) {
+  IslandModel model(DFIN, DFOUT, params, 123);
+  ASSERT_EQ(model.getNbIslands(), 3);
+  model.start();
+  model.evolve(2, params.global_params.max_fitness);
+
+  vector<Genome> best_rules;
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(model.getGeneration(i).generation_number, 2);
+    best_rules.push_back(model.getGeneration(i).left_gen.elite[0]);
+  }
+
+  model.migrate();
+  // ring: the best rules genome of island i is now in island i + 1
+  for (int i = 0; i < 3; i++) {
+    const auto& individuals = model.getGeneration((i + 1) % 3).left_gen.individuals;
+    EXPECT_NE(find(individuals.begin(), individuals.end(), best_rules[i]), individuals.end()) << i;
+  }
+}
+
+TEST_F(IslandModelTest, deterministic) {
+  auto ref = FuzzyCoco::searchBestFuzzySystem(DF, DFOUT.nbcols(), params, 6423);
+  ASSERT_FALSE(ref.empty());
+  EXPECT_EQ(ref["fit"].get_int("generations"), 12);
+  EXPECT_EQ(ref["params"]["global_params"].get_int("nb_islands"), 3);
+
+  // the results must not depend on the number of threads
+  for (int nb_threads : {2, 3, 0}) {
+    params.global_params.nb_threads = nb_threads;
+    auto desc = FuzzyCoco::searchBestFuzzySystem(DF, DFOUT.nbcols(), params, 6423);
+    EXPECT_EQ(desc["fit"], ref["fit"]) << nb_threads;
+    EXPECT_EQ(desc["fuzzy_system"], ref["fuzzy_system"]) << nb_threads;
+  }
+
+  params.global_params.migration_topology = "random";
+  auto random1 = FuzzyCoco::searchBestFuzzySystem(DF, DFOUT.nbcols(), params, 6423);
+  params.global_params.nb_threads = 1;
+  auto random2 = FuzzyCoco::searchBestFuzzySystem(DF, DFOUT.nbcols(), params, 6423);
+  EXPECT_EQ(random1["fuzzy_system"], random2["fuzzy_system"]);
+}
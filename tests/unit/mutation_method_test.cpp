@@ -65,3 +65,44 @@ TEST(TogglingMutationMethod, mutate_genomes) {
 
 }
 
+
+TEST(TogglingMutationMethod, mutateGeometric) {
+  RandomGenerator rng(123);
+  const int nb = 10000;
+  Genome gen(nb);
+
+  // very small prob (but not 0) ==> we do not expect any change
+  TogglingMutationMethod(rng, 1, 1e-9, true).mutate(gen);
+  EXPECT_EQ(gen.count(), 0);
+
+  // 0 prob --> one single mutation, as the legacy sampling
+  TogglingMutationMethod(rng, 1, 0, true).mutate(gen);
+  EXPECT_EQ(gen.count(), 1);
+
+  // prob == 1 --> all flipped
+  gen = Genome(nb);
+  TogglingMutationMethod(rng, 1, 1, true).mutate(gen);
+  EXPECT_EQ(gen.count(), nb);
+
+  // the number of flips follows a binomial(nb, p) distribution
+  for (double p : {0.01, 0.2, 0.5}) {
+    gen = Genome(nb);
+    TogglingMutationMethod(rng, 1, p, true).mutate(gen);
+    const double expected = nb * p, sd = sqrt(nb * p * (1 - p));
+    EXPECT_LT(fabs(double(gen.count()) - expected), 5 * sd) << p;
+  }
+
+  // the flips are uniformly spread
+  gen = Genome(nb);
+  TogglingMutationMethod(rng, 1, 0.1, true).mutate(gen);
+  size_t first_half = 0;
+  for (int i = 0; i < nb / 2; i++) first_half += gen[i];
+  EXPECT_LT(fabs(double(first_half) / gen.count() - 0.5), 0.05);
+
+  // reproducible
+  Genome gen1(nb), gen2(nb);
+  RandomGenerator rng1(666), rng2(666);
+  TogglingMutationMethod(rng1, 1, 0.05, true).mutate(gen1);
+  TogglingMutationMethod(rng2, 1, 0.05, true).mutate(gen2);
+  EXPECT_EQ(gen1, gen2);
+}
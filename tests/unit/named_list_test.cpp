@@ -688,3 +688,88 @@ TEST(NamedList, add_map__as_string_numeric_map) {
 
 }
 
+
+TEST(NamedList, index) {
+  const int nb = 100;
+  NamedList lst;
+  for (int i = 0; i < nb; i++) {
+    lst.add("elt" + std::to_string(i), i);
+    EXPECT_EQ(lst.is_indexed(), lst.size() >= NamedList::INDEX_MIN_SIZE);
+  }
+  for (int i = 0; i < nb; i++)
+    EXPECT_EQ(lst.get_int("elt" + std::to_string(i)), i);
+  EXPECT_FALSE(lst.has("elt100"));
+  EXPECT_THROW(lst.fetch("elt100"), runtime_error);
+
+  // the first matching name is returned
+  lst.add("elt5", 42);
+  EXPECT_EQ(lst.get_int("elt5"), 5);
+  EXPECT_EQ(lst.find_first_idx("elt5"), 5);
+
+  // copy on write of the index
+  NamedList copy = lst;
+  copy.add("new", 1);
+  EXPECT_TRUE(copy.has("new"));
+  EXPECT_FALSE(lst.has("new"));
+  lst.add("other", 2);
+  EXPECT_FALSE(copy.has("other"));
+
+  // parsed lists are indexed
+  auto parsed = NamedList::parse(lst.to_string());
+  EXPECT_TRUE(parsed.is_indexed());
+  EXPECT_EQ(parsed, lst);
+  EXPECT_EQ(parsed.get_int("elt99"), 99);
+  EXPECT_EQ(parsed.get_int("other"), 2);
+
+  // a child renamed through the non-const accessors: the stale index falls back on the linear scan
+  parsed[10] = NamedList("renamed", 10);
+  ASSERT_TRUE(parsed.is_indexed());
+  EXPECT_EQ(parsed.find_first_idx("renamed"), 10);
+  EXPECT_EQ(parsed.get_int("renamed"), 10);
+  EXPECT_FALSE(parsed.has("elt10"));
+  *(parsed.begin() + 20) = NamedList("renamed_too", 20);
+  EXPECT_EQ(parsed.find_first_idx("renamed_too"), 20);
+  EXPECT_FALSE(parsed.has("elt20"));
+}
+
+TEST(NamedList, parse_strings_and_numbers) {
+  NamedList lst;
+  lst.add("with spaces", "a b  c");
+  lst.add("with \"quotes\"", "back\\slash \"and\" quotes");
+  lst.add("comma,brace}", ",}{");
+  NamedList l2 = NamedList::parse(lst.to_string());
+  EXPECT_EQ(l2, lst);
+
+  auto l3 = NamedList::parse(R"({"a":1e3, "b":-2.5E-1, "c":1.0e2, "d" :  12})");
+  EXPECT_EQ(l3.fetch_scalar("a"), 1000.0);
+  EXPECT_EQ(l3.fetch_scalar("b"), -0.25);
+  EXPECT_EQ(l3.fetch_scalar("c"), 100.0);
+  EXPECT_EQ(l3.fetch_scalar("d"), 12);
+}
+
+TEST(NamedList, parse_deeply_nested) {
+  // N.B: parsed without recursion
+  const int depth = 2000;
+  string content = "{";
+  for (int i = 0; i < depth - 1; i++) content += "\"l\":{";
+  content += "\"l\":1";
+  for (int i = 0; i < depth; i++) content += "}";
+
+  auto lst = NamedList::parse(content);
+  const NamedList* node = &lst;
+  int nb = 0;
+  while (node->is_list()) {
+    node = &(*node)[0];
+    nb++;
+  }
+  EXPECT_EQ(nb, depth);
+  EXPECT_EQ(node->get_int(), 1);
+}
+
+TEST(NamedList, parse_errors) {
+  EXPECT_THROW(NamedList::parse(R"({"a":1)"), runtime_error);
+  EXPECT_THROW(NamedList::parse(R"({"a" 1})"), runtime_error);
+  EXPECT_THROW(NamedList::parse(R"({1})"), runtime_error);
+  EXPECT_THROW(NamedList::parse(R"({"a":"unterminated})"), runtime_error);
+  EXPECT_THROW(NamedList::parse(R"({"a":99999999999})"), out_of_range);
+}
@@ -0,0 +1,240 @@
+#include "tests.h"
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <cstring>
+#include "prediction_server.h"
+#include "fuzzy_coco.h"
+#include "file_utils.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+using namespace fuzzy_coco;
+using namespace FileUtils;
+
+string FUZZY_FILE_JSON = R"(
+{ "fuzzy_system": {
+  "variables":{
+    "input":{
+      "in_1":{ "in_1.1":0.0, "in_1.2":5.0, "in_1.3":10.0 },
+      "in_2":{ "in_2.1":0.0, "in_2.2":50.0, "in_2.3":100.0 }
+    },
+    "output":{
+      "out_1":{ "out_1.1":0.0, "out_1.2":100.0 }
+    }
+  },
+  "rules":{
+    "rule1":{
+      "antecedents":{ "in_1":"in_1.1", "in_2":"in_2.1" },
+      "consequents":{ "out_1":"out_1.1" }
+    },
+    "rule2":{
+      "antecedents":{ "in_1":"in_1.3" },
+      "consequents":{ "out_1":"out_1.2" }
+    }
+  },
+  "default_rules":{ "out_1":"out_1.2" }
+}})";
+
+string ROWS =
+R"(ID;in_2;in_1;other
+id1;10;1;0
+id2;NA;9;0
+id3;60;4;0
+)";
+
+static string expected_csv(const string& fuzzy_file, const string& rows) {
+  ostringstream out;
+  writeCSV(out, FuzzyCoco::loadAndPredict(DataFrame(rows, true), fuzzy_file));
+  return out.str();
+}
+
+TEST(PredictionServer, serve) {
+  string fuzzy_file = poor_man_tmpnam("PredictionServer_serve");
+  { ofstream out(fuzzy_file); out << FUZZY_FILE_JSON; }
+
+  PredictionServer server;
+  stringstream in, out;
+  in << "PREDICT 3 " << fuzzy_file << "\n" << ROWS;
+  in << "\nLOAD " << fuzzy_file << "\n";
+  in << "UNKNOWN\n";
+  in << "PREDICT 1 /does/not/exist\n" << "ID;in_1;in_2\nid1;1;2\n";
+  in << "PREDICT 1 " << fuzzy_file << "\n" << "ID;in_1\nid1;1\n";
+  in << "QUIT\n";
+  in << "PREDICT 3 " << fuzzy_file << "\n" << ROWS;
+  server.serve(in, out);
+
+  string line;
+  getline(out, line);
+  EXPECT_EQ(line, "OK 4");
+  string csv;
+  for (int i = 0; i < 4; i++) {
+    getline(out, line);
+    csv += line + "\n";
+  }
+  EXPECT_EQ(csv, expected_csv(fuzzy_file, ROWS));
+
+  getline(out, line);
+  EXPECT_EQ(line, "OK 0");
+  getline(out, line);
+  EXPECT_EQ(line.substr(0, 6), "ERROR ");
+  // missing file
+  getline(out, line);
+  EXPECT_EQ(line.substr(0, 6), "ERROR ");
+  // missing column
+  getline(out, line);
+  EXPECT_EQ(line.substr(0, 6), "ERROR ");
+  // QUIT, the next requests are ignored
+  getline(out, line);
+  EXPECT_EQ(line, "OK 0");
+  EXPECT_FALSE(getline(out, line));
+
+  auto stats = server.stats();
+  EXPECT_EQ(stats.get_int("nb_requests"), 1);
+  EXPECT_EQ(stats.get_double("nb_rows"), 3);
+  EXPECT_EQ(stats.get_int("nb_errors"), 3);
+  EXPECT_EQ(stats.get_int("nb_fuzzy_systems"), 1);
+  EXPECT_GT(stats.get_double("latency_p99_ms"), 0);
+
+  remove(fuzzy_file);
+}
+
+TEST(PredictionServer, concurrent_requests) {
+  string fuzzy_file = poor_man_tmpnam("PredictionServer_concurrent");
+  { ofstream out(fuzzy_file); out << FUZZY_FILE_JSON; }
+
+  PredictionServer::Options options;
+  options.nb_workers = 2;
+  options.max_batch_rows = 10;
+  PredictionServer server(options);
+
+  DataFrame df(ROWS, true);
+  const DataFrame expected = FuzzyCoco::loadAndPredict(df, fuzzy_file);
+
+  const int nb_threads = 8, nb_requests = 50;
+  vector<thread> clients;
+  vector<int> nb_ok(nb_threads, 0);
+  for (int t = 0; t < nb_threads; t++) {
+    clients.emplace_back([&, t] {
+      for (int i = 0; i < nb_requests; i++)
+        if (server.predict(fuzzy_file, df) == expected) nb_ok[t]++;
+    });
+  }
+  for (auto& client : clients) client.join();
+  for (int t = 0; t < nb_threads; t++)
+    EXPECT_EQ(nb_ok[t], nb_requests);
+
+  auto stats = server.stats();
+  EXPECT_EQ(stats.get_int("nb_requests"), nb_threads * nb_requests);
+  EXPECT_EQ(stats.get_double("nb_rows"), nb_threads * nb_requests * 3);
+  EXPECT_LE(stats.get_int("nb_batches"), nb_threads * nb_requests);
+  EXPECT_GT(stats.get_int("nb_batches"), 0);
+
+  remove(fuzzy_file);
+}
+
+TEST(PredictionServer, cache) {
+  string fuzzy_file = poor_man_tmpnam("PredictionServer_cache");
+  { ofstream out(fuzzy_file); out << FUZZY_FILE_JSON; }
+
+  PredictionServer server;
+  auto fs1 = server.getFuzzySystem(fuzzy_file);
+  EXPECT_EQ(server.getFuzzySystem(fuzzy_file), fs1);
+  EXPECT_EQ(server.getNbCachedFuzzySystems(), 1);
+
+  // modified --> reloaded
+  string content = FUZZY_FILE_JSON;
+  content.replace(content.find("\"out_1.2\":100.0"), 15, "\"out_1.2\":200.0");
+  { ofstream out(fuzzy_file); out << content; }
+  filesystem::last_write_time(fuzzy_file, filesystem::last_write_time(fuzzy_file) + chrono::seconds(10));
+  auto fs2 = server.getFuzzySystem(fuzzy_file);
+  EXPECT_NE(fs2, fs1);
+  EXPECT_EQ(fs2->getDB().getOutputVariable(0).getSet(1).getPosition(), 200);
+  EXPECT_EQ(server.getNbCachedFuzzySystems(), 1);
+
+  EXPECT_THROW(server.getFuzzySystem(fuzzy_file + ".missing"), filesystem::filesystem_error);
+
+  remove(fuzzy_file);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+// connect to the server socket, retrying while it is not listening yet. Returns the fd, or -1
+static int connect_socket(const string& socket_path) {
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) return -1;
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, socket_path.c_str());
+  for (int i = 0; i < 100; i++) {
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0) return fd;
+    this_thread::sleep_for(chrono::milliseconds(20));
+  }
+  close(fd);
+  return -1;
+}
+
+// send the request and read the response until the server closes the connection
+static string send_request(int fd, const string& request) {
+  if (write(fd, request.data(), request.size()) != ssize_t(request.size())) return "";
+  string response;
+  char buffer[4096];
+  ssize_t nb;
+  while ((nb = read(fd, buffer, sizeof(buffer))) > 0)
+    response.append(buffer, nb);
+  return response;
+}
+
+TEST(PredictionServer, unix_socket) {
+  string fuzzy_file = poor_man_tmpnam("PredictionServer_socket_fs");
+  string socket_path = poor_man_tmpnam("PredictionServer_socket");
+  { ofstream out(fuzzy_file); out << FUZZY_FILE_JSON; }
+
+  PredictionServer server;
+  thread listener([&] { server.serveUnixSocket(socket_path); });
+
+  int fd = connect_socket(socket_path);
+  ASSERT_GE(fd, 0);
+  string response = send_request(fd, "PREDICT 3 " + fuzzy_file + "\n" + ROWS + "QUIT\n");
+  close(fd);
+
+  EXPECT_EQ(response, "OK 4\n" + expected_csv(fuzzy_file, ROWS) + "OK 0\n");
+
+  server.stop();
+  listener.join();
+  EXPECT_FALSE(filesystem::exists(socket_path));
+  remove(fuzzy_file);
+}
+
+TEST(PredictionServer, unix_socket_reaps_connections) {
+  string fuzzy_file = poor_man_tmpnam("PredictionServer_reap_fs");
+  string socket_path = poor_man_tmpnam("PredictionServer_reap");
+  { ofstream out(fuzzy_file); out << FUZZY_FILE_JSON; }
+
+  PredictionServer server;
+  thread listener([&] { server.serveUnixSocket(socket_path); });
+
+  // many sequential connections: the finished connection threads must be joined as the server goes
+  const string expected = "OK 4\n" + expected_csv(fuzzy_file, ROWS) + "OK 0\n";
+  const int nb_connections = 50;
+  for (int i = 0; i < nb_connections; i++) {
+    int fd = connect_socket(socket_path);
+    ASSERT_GE(fd, 0);
+    EXPECT_EQ(send_request(fd, "PREDICT 3 " + fuzzy_file + "\n" + ROWS + "QUIT\n"), expected);
+    close(fd);
+  }
+
+  // N.B: the finished threads are joined by the accept loop, at the latest within its poll timeout.
+  // Without reaping, all the nb_connections threads would remain
+  for (int i = 0; i < 250 && server.getNbConnectionThreads() > 0; i++)
+    this_thread::sleep_for(chrono::milliseconds(20));
+  EXPECT_EQ(server.getNbConnectionThreads(), 0);
+
+  server.stop();
+  listener.join();
+  remove(fuzzy_file);
+}
+#endif
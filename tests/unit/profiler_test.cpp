@@ -0,0 +1,113 @@
+#include "tests.h"
+#include "profiler.h"
+#include "thread_pool.h"
+#include "fuzzy_coco.h"
+
+using namespace fuzzy_coco;
+
+TEST(Profiler, record) {
+  Profiler::enable();
+  Profiler::record(Profiler::DECODE, 10);
+  Profiler::record(Profiler::DECODE, 30);
+  Profiler::record(Profiler::DECODE, 20);
+  auto stats = Profiler::getStats(Profiler::DECODE);
+  EXPECT_EQ(stats.nb_calls, 3);
+  EXPECT_EQ(stats.total_ns, 60u);
+  EXPECT_EQ(stats.max_ns, 30u);
+  EXPECT_EQ(Profiler::getStats(Profiler::MUTATION).nb_calls, 0);
+
+  // threads
+  ThreadPool pool(4);
+  pool.run(1000, [](int i, int) { Profiler::record(Profiler::MUTATION, i); });
+  stats = Profiler::getStats(Profiler::MUTATION);
+  EXPECT_EQ(stats.nb_calls, 1000);
+  EXPECT_EQ(stats.total_ns, 999u * 1000 / 2);
+  EXPECT_EQ(stats.max_ns, 999u);
+
+  Profiler::reset();
+  EXPECT_EQ(Profiler::getStats(Profiler::DECODE).nb_calls, 0);
+  Profiler::enable(false);
+}
+
+TEST(Profiler, ScopedTimer) {
+  Profiler::enable(false);
+  { Profiler::ScopedTimer timer(Profiler::CROSSOVER); }
+  EXPECT_EQ(Profiler::getStats(Profiler::CROSSOVER).nb_calls, 0);
+
+  Profiler::enable();
+  { Profiler::ScopedTimer timer(Profiler::CROSSOVER); }
+  { Profiler::ScopedTimer timer(Profiler::CROSSOVER); }
+  EXPECT_EQ(Profiler::getStats(Profiler::CROSSOVER).nb_calls, 2);
+  Profiler::enable(false);
+
+  // enabling resets
+  Profiler::enable();
+  EXPECT_EQ(Profiler::getStats(Profiler::CROSSOVER).nb_calls, 0);
+  Profiler::enable(false);
+}
+
+TEST(Profiler, describe) {
+  Profiler::enable();
+  Profiler::record(Profiler::EVALUATION, 1000);
+  Profiler::record(Profiler::EVALUATION, 3000);
+  Profiler::enable(false);
+
+  auto desc = Profiler::describe();
+  EXPECT_EQ(desc.get_bool("compiled"), Profiler::available());
+  EXPECT_EQ(desc.get_double("nb_evaluations"), 2);
+  EXPECT_GE(desc.get_double("elapsed_s"), 0);
+  // N.B: stopped when disabled
+  EXPECT_EQ(Profiler::describe().get_double("elapsed_s"), desc.get_double("elapsed_s"));
+
+  const auto& phases = desc["phases"];
+  EXPECT_EQ(phases.size(), size_t(Profiler::NB_PHASES));
+  const auto& eval = phases["evaluation"];
+  EXPECT_EQ(eval.get_double("nb_calls"), 2);
+  EXPECT_EQ(eval.get_double("total_ns"), 4000);
+  EXPECT_EQ(eval.get_double("max_ns"), 3000);
+  EXPECT_DOUBLE_EQ(eval.get_double("mean_ns"), 2000);
+  EXPECT_DOUBLE_EQ(eval.get_double("calls_per_s"), 2 / 4e-6);
+  EXPECT_EQ(phases["selection"].get_double("calls_per_s"), 0);
+
+  for (int i = 0; i < Profiler::NB_PHASES; i++) 
+    EXPECT_TRUE(phases.has(Profiler::phaseName(Profiler::Phase(i))));
+}
+
+TEST(Profiler, fit) {
+  if (!Profiler::available()) GTEST_SKIP() << "built without FUZZYCOCO_PROFILE";
+
+  DataFrame df(R"(Days;Temperature;Sunshine;Tourists
+day1;19;25;55
+day2;40;99;95
+day3;24;NA;70
+day4;5;3;2
+day5;31;60;80
+day6;12;NA;20
+)", true);
+  FuzzyCocoParams params;
+  params.global_params.nb_rules = 3;
+  params.global_params.nb_max_var_per_rule = 2;
+  params.global_params.max_generations = 5;
+  params.global_params.max_fitness = 2;
+  params.input_vars_params.nb_bits_pos = 8;
+  params.output_vars_params.nb_bits_pos = 2;
+  params.fitness_params.output_vars_defuzz_thresholds.push_back(50);
+  params.rules_params.pop_size = 10;
+  params.mfs_params.pop_size = 20;
+  params.evaluate_missing(2, 1);
+
+  Profiler::enable();
+  auto ref = FuzzyCoco::searchBestFuzzySystem(df, 1, params, 123);
+  Profiler::enable(false);
+
+  const long nb_evaluations = Profiler::getStats(Profiler::EVALUATION).nb_calls;
+  EXPECT_GT(nb_evaluations, 0);
+  // N.B: the best fuzzy system is also decoded
+  EXPECT_GE(Profiler::getStats(Profiler::DECODE).nb_calls, 2 * nb_evaluations);
+  for (auto phase : {Profiler::FIRE_LEVELS, Profiler::IMPLICATION, Profiler::DEFUZZIFICATION, Profiler::METRICS,
+      Profiler::SELECTION, Profiler::CROSSOVER, Profiler::MUTATION})
+    EXPECT_GT(Profiler::getStats(phase).nb_calls, 0) << Profiler::phaseName(phase);
+
+  // the profiler does not change the results
+  EXPECT_EQ(FuzzyCoco::searchBestFuzzySystem(df, 1, params, 123), ref);
+}
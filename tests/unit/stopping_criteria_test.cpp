@@ -0,0 +1,224 @@
+#include "tests.h"
+#include <thread>
+#include "stopping_criteria.h"
+#include "island_model.h"
+#include "file_utils.h"
+
+using namespace fuzzy_coco;
+using namespace FileUtils;
+
+string CSV =
+R"(Days;Temperature;Sunshine;Tourists
+day1;19;25;55
+day2;40;99;95
+day3;24;NA;70
+day4;5;3;2
+day5;31;60;80
+day6;12;NA;20
+)";
+
+class StoppingCriteriaTest : public testing::Test {
+protected:
+  StoppingCriteriaTest() : DF(CSV, true) {}
+
+  void SetUp() override {
+    DFIN = DF.subsetColumns(0, DF.nbcols() - 2);
+    DFOUT = DF.subsetColumns(DF.nbcols() - 1, DF.nbcols() - 1);
+
+    params.global_params.nb_rules = 3;
+    params.global_params.nb_max_var_per_rule = DFIN.nbcols();
+    params.global_params.max_generations = 20;
+    params.global_params.max_fitness = 2; // never early-stop
+    params.input_vars_params.nb_bits_pos = 8;
+    params.output_vars_params.nb_bits_pos = 2;
+    params.fitness_params.output_vars_defuzz_thresholds.push_back(50);
+    params.rules_params.pop_size = 10;
+    params.mfs_params.pop_size = 20;
+    params.evaluate_missing(DFIN.nbcols(), 1);
+  }
+
+  DataFrame DF, DFIN, DFOUT;
+  FuzzyCocoParams params;
+};
+
+TEST(StopReason, toString) {
+  EXPECT_EQ(toString(StopReason::NONE), "none");
+  EXPECT_EQ(toString(StopReason::MAX_GENERATIONS), "max_generations");
+  EXPECT_EQ(toString(StopReason::MAX_FITNESS), "max_fitness");
+  EXPECT_EQ(toString(StopReason::MAX_SECONDS), "max_seconds");
+  EXPECT_EQ(toString(StopReason::MAX_EVALUATIONS), "max_evaluations");
+  EXPECT_EQ(toString(StopReason::STAGNATION), "stagnation");
+}
+
+TEST(StoppingCriteria, check) {
+  GlobalParams p;
+  p.max_generations = 100;
+  p.max_fitness = 0.9;
+
+  // defaults: only max_generations and max_fitness
+  StoppingCriteria criteria(p);
+  criteria.start(0, 0);
+  EXPECT_EQ(criteria.check(1, 0.5, 0.5, 1e9), StopReason::NONE);
+  EXPECT_EQ(criteria.check(50, 0.5, 0.5, 1e12), StopReason::NONE);
+  EXPECT_EQ(criteria.check(100, 0.5, 0.5, 0), StopReason::MAX_GENERATIONS);
+  // the fitness first
+  EXPECT_EQ(criteria.check(100, 0.95, 0.95, 0), StopReason::MAX_FITNESS);
+
+  // evaluations
+  p.max_evaluations = 1000;
+  StoppingCriteria evals(p);
+  evals.start(0, 0);
+  EXPECT_EQ(evals.check(1, 0.5, 0.5, 999), StopReason::NONE);
+  EXPECT_EQ(evals.check(2, 0.5, 0.5, 1000), StopReason::MAX_EVALUATIONS);
+
+  // time
+  p.max_evaluations = 0;
+  p.max_seconds = 0.05;
+  StoppingCriteria time(p);
+  time.start(0, 0);
+  EXPECT_FALSE(time.isTimeExceeded());
+  EXPECT_EQ(time.check(1, 0.5, 0.5, 0), StopReason::NONE);
+  this_thread::sleep_for(chrono::milliseconds(60));
+  EXPECT_TRUE(time.isTimeExceeded());
+  EXPECT_EQ(time.check(2, 0.5, 0.5, 0), StopReason::MAX_SECONDS);
+  // the time already spent
+  time.start(2, 0.5, 1);
+  EXPECT_GE(time.getElapsedSeconds(), 1);
+  EXPECT_EQ(time.check(3, 0.5, 0.5, 0), StopReason::MAX_SECONDS);
+}
+
+TEST(StoppingCriteria, stagnation) {
+  GlobalParams p;
+  p.max_generations = 100;
+  p.max_fitness = 1;
+  p.stagnation_generations = 3;
+
+  StoppingCriteria criteria(p);
+  criteria.start(0, 0.1);
+  EXPECT_EQ(criteria.check(1, 0.2, 0.2, 0), StopReason::NONE);
+  EXPECT_EQ(criteria.getLastImprovement(), 1);
+  EXPECT_EQ(criteria.check(2, 0.1, 0.2, 0), StopReason::NONE);
+  EXPECT_EQ(criteria.check(3, 0.1, 0.2, 0), StopReason::NONE);
+  // improvement: reset
+  EXPECT_EQ(criteria.check(4, 0.3, 0.3, 0), StopReason::NONE);
+  EXPECT_EQ(criteria.getLastImprovement(), 4);
+  EXPECT_EQ(criteria.check(5, 0.1, 0.3, 0), StopReason::NONE);
+  EXPECT_EQ(criteria.check(6, 0.1, 0.3, 0), StopReason::NONE);
+  EXPECT_EQ(criteria.check(7, 0.1, 0.3, 0), StopReason::STAGNATION);
+
+  // restarted, e.g. from a checkpoint
+  criteria.start(5, 0.3);
+  EXPECT_EQ(criteria.check(7, 0.1, 0.3, 0), StopReason::NONE);
+  EXPECT_EQ(criteria.check(8, 0.1, 0.3, 0), StopReason::STAGNATION);
+}
+
+TEST_F(StoppingCriteriaTest, nb_evaluations) {
+  RandomGenerator rng(123);
+  FuzzyCoco coco(DFIN, DFOUT, params, rng);
+  auto& fit = coco.getFitnessMethod();
+  EXPECT_EQ(fit.getNbEvaluations(), 0);
+
+  auto gen = coco.run(1, 2);
+  const long nb = fit.getNbEvaluations();
+  EXPECT_GT(nb, 0);
+  // N.B: the cached pairs are counted too
+  coco.run(1, 2, gen);
+  EXPECT_GT(fit.getNbEvaluations(), nb);
+}
+
+TEST_F(StoppingCriteriaTest, searchBestFuzzySystem) {
+  // max_generations
+  auto desc = FuzzyCoco::searchBestFuzzySystem(DF, DFOUT.nbcols(), params, 123);
+  EXPECT_EQ(desc["fit"].get_string("stop_reason"), "max_generations");
+  EXPECT_EQ(desc["fit"].get_int("generations"), 20);
+
+  // the default params: the same results as before
+  RandomGenerator rng(123);
+  FuzzyCocoParams fixed = params;
+  fixed.fitness_params.fix_output_thresholds(1);
+  FuzzyCoco coco(DFIN, DFOUT, fixed, rng);
+  auto gen = coco.run(20, 2);
+  EXPECT_EQ(gen.generation_number, 20);
+  EXPECT_EQ(desc["fit"].get_double("fitness"), coco.describe()["fit"].get_double("fitness"));
+
+  // stagnation
+  FuzzyCocoParams p = params;
+  p.global_params.max_generations = 1000;
+  p.global_params.stagnation_generations = 5;
+  desc = FuzzyCoco::searchBestFuzzySystem(DF, DFOUT.nbcols(), p, 123);
+  EXPECT_EQ(desc["fit"].get_string("stop_reason"), "stagnation");
+  EXPECT_LT(desc["fit"].get_int("generations"), 1000);
+
+  // evaluations
+  p = params;
+  p.global_params.max_generations = 1000;
+  p.global_params.max_evaluations = 100;
+  desc = FuzzyCoco::searchBestFuzzySystem(DF, DFOUT.nbcols(), p, 123);
+  EXPECT_EQ(desc["fit"].get_string("stop_reason"), "max_evaluations");
+  EXPECT_LT(desc["fit"].get_int("generations"), 1000);
+  // N.B: the evaluations of the engine, cached or not
+  EXPECT_GE(desc["fit"].get_numeric("nb_evaluations"), 100);
+
+  // max_fitness
+  p = params;
+  p.global_params.max_fitness = 0;
+  desc = FuzzyCoco::searchBestFuzzySystem(DF, DFOUT.nbcols(), p, 123);
+  EXPECT_EQ(desc["fit"].get_string("stop_reason"), "max_fitness");
+  EXPECT_EQ(desc["fit"].get_int("generations"), 1);
+
+  // time: N.B: the time is checked after each generation
+  p = params;
+  p.global_params.max_generations = 1000000;
+  p.global_params.max_seconds = 0.1;
+  desc = FuzzyCoco::searchBestFuzzySystem(DF, DFOUT.nbcols(), p, 123);
+  EXPECT_EQ(desc["fit"].get_string("stop_reason"), "max_seconds");
+  EXPECT_LT(desc["fit"].get_int("generations"), 1000000);
+}
+
+TEST_F(StoppingCriteriaTest, islands) {
+  params.global_params.nb_islands = 3;
+  params.global_params.migration_interval = 4;
+  params.global_params.max_generations = 1000;
+  params.global_params.stagnation_generations = 8;
+
+  auto desc = FuzzyCoco::searchBestFuzzySystem(DF, DFOUT.nbcols(), params, 123);
+  EXPECT_EQ(desc["fit"].get_string("stop_reason"), "stagnation");
+  // N.B: checked after each epoch
+  EXPECT_EQ(desc["fit"].get_int("generations") % 4, 0);
+
+  params.global_params.stagnation_generations = 0;
+  params.global_params.max_evaluations = 500;
+  IslandModel islands(DFIN, DFOUT, params, 123);
+  islands.run();
+  EXPECT_EQ(islands.getStopReason(), StopReason::MAX_EVALUATIONS);
+  long nb = 0;
+  for (int i = 0; i < islands.getNbIslands(); i++) nb += islands.getIsland(i).getFitnessMethod().getNbEvaluations();
+  EXPECT_GE(nb, 500);
+}
+
+TEST_F(StoppingCriteriaTest, resume) {
+  string tmp = poor_man_tmpnam("StoppingCriteria_resume");
+  params.global_params.max_generations = 1000;
+  params.global_params.stagnation_generations = 5;
+  auto ref = FuzzyCoco::searchBestFuzzySystem(DF, DFOUT.nbcols(), params, 6423);
+  const int nb_generations = ref["fit"].get_int("generations");
+  ASSERT_GT(nb_generations, 3);
+
+  Checkpoint::Options checkpoint;
+  checkpoint.filename = tmp;
+  checkpoint.interval = 1;
+
+  // interrupted, then resumed: the stagnation and the evaluations carry over
+  FuzzyCocoParams interrupted = params;
+  interrupted.global_params.max_generations = nb_generations - 2;
+  FuzzyCoco::searchBestFuzzySystem(DF, DFOUT.nbcols(), interrupted, 6423, checkpoint);
+  auto state = Checkpoint::load(path(tmp));
+  EXPECT_GT(state.coevolutions.at(0).nb_evaluations, 0);
+  EXPECT_GT(state.elapsed_seconds, 0);
+
+  checkpoint.resume = true;
+  auto desc = FuzzyCoco::searchBestFuzzySystem(DF, DFOUT.nbcols(), params, 1, checkpoint);
+  EXPECT_EQ(desc, ref);
+
+  remove(tmp);
+}
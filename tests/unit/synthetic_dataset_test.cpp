@@ -0,0 +1,128 @@
+#include "tests.h"
+#include <sstream>
+#include "synthetic_dataset.h"
+#include "file_utils.h"
+
+using namespace fuzzy_coco;
+
+static string to_csv(const SyntheticDataset::Options& options) {
+  ostringstream out;
+  SyntheticDataset::write(options, out);
+  return out.str();
+}
+
+TEST(SyntheticDataset, shape) {
+  SyntheticDataset::Options options;
+  options.nb_rows = 50;
+  options.nb_vars = 7;
+  DataFrame df = SyntheticDataset::generate(options);
+  EXPECT_EQ(df.nbrows(), 50);
+  EXPECT_EQ(df.nbcols(), 8);
+  EXPECT_EQ(df.colnames(), SyntheticDataset::colnames(options));
+  EXPECT_EQ(df.colnames().front(), "x1");
+  EXPECT_EQ(df.colnames().back(), "y");
+  EXPECT_EQ(df.rownames().front(), "row1");
+  EXPECT_EQ(df.rownames().back(), "row50");
+
+  for (int i = 0; i < df.nbrows(); i++) {
+    for (int j = 0; j < options.nb_vars; j++) {
+      EXPECT_GE(df.at(i, j), 0);
+      EXPECT_LE(df.at(i, j), 100);
+    }
+    double y = df.at(i, options.nb_vars);
+    EXPECT_TRUE(y == 0 || y == 1);
+  }
+
+  EXPECT_EQ(options.filename(), "synthetic_50x7_s123.csv");
+}
+
+TEST(SyntheticDataset, seeded) {
+  SyntheticDataset::Options options;
+  options.nb_rows = 100;
+  options.na_rate = 0.1;
+
+  EXPECT_EQ(SyntheticDataset::generate(options), SyntheticDataset::generate(options));
+  EXPECT_EQ(to_csv(options), to_csv(options));
+
+  auto other = options;
+  other.seed = 456;
+  EXPECT_FALSE(SyntheticDataset::generate(options) == SyntheticDataset::generate(other));
+  EXPECT_NE(options.filename(), other.filename());
+}
+
+TEST(SyntheticDataset, write) {
+  // the written dataset loads exactly as the generated one
+  for (bool regression : {false, true}) {
+    SyntheticDataset::Options options;
+    options.nb_rows = 200;
+    options.nb_vars = 5;
+    options.na_rate = 0.2;
+    options.regression = regression;
+    DataFrame df(to_csv(options), true);
+    EXPECT_EQ(df, SyntheticDataset::generate(options));
+  }
+
+  string tmp = FileUtils::poor_man_tmpnam("SyntheticDataset");
+  SyntheticDataset::Options options;
+  options.nb_rows = 10;
+  SyntheticDataset::write(options, path(tmp));
+  EXPECT_EQ(DataFrame::load(tmp, true), SyntheticDataset::generate(options));
+  remove(tmp);
+}
+
+TEST(SyntheticDataset, na_rate_and_balance) {
+  SyntheticDataset::Options options;
+  options.nb_rows = 4000;
+  options.nb_vars = 5;
+  options.na_rate = 0.25;
+  options.class_balance = 0.2;
+  DataFrame df = SyntheticDataset::generate(options);
+
+  int nb_na = 0, nb_ones = 0;
+  for (int i = 0; i < df.nbrows(); i++) {
+    for (int j = 0; j < options.nb_vars; j++)
+      nb_na += df.missing(i, j);
+    // no NA in the output
+    ASSERT_FALSE(df.missing(i, options.nb_vars));
+    nb_ones += df.at(i, options.nb_vars) == 1;
+  }
+  EXPECT_NEAR(double(nb_na) / (df.nbrows() * options.nb_vars), 0.25, 0.02);
+  EXPECT_NEAR(double(nb_ones) / df.nbrows(), 0.2, 0.02);
+
+  // informative variables: separated by class
+  options.na_rate = 0;
+  df = SyntheticDataset::generate(options);
+  for (int i = 0; i < df.nbrows(); i++) {
+    if (df.at(i, options.nb_vars) == 1)
+      EXPECT_GE(df.at(i, 0), 40);
+    else
+      EXPECT_LE(df.at(i, 0), 60);
+  }
+}
+
+TEST(SyntheticDataset, regression) {
+  SyntheticDataset::Options options;
+  options.nb_rows = 500;
+  options.nb_vars = 4;
+  options.nb_informative = 2;
+  options.regression = true;
+  DataFrame df = SyntheticDataset::generate(options);
+  for (int i = 0; i < df.nbrows(); i++) {
+    double mean = (df.at(i, 0) + df.at(i, 1)) / 2;
+    EXPECT_NEAR(df.at(i, options.nb_vars), mean, 5.01);
+  }
+  EXPECT_EQ(options.filename(".bin"), "synthetic_500x4_reg_s123.bin");
+}
+
+TEST(SyntheticDataset, bad_options) {
+  SyntheticDataset::Options options;
+  options.nb_rows = 0;
+  EXPECT_THROW(SyntheticDataset::generate(options), runtime_error);
+  options.nb_rows = 10;
+  options.na_rate = 1;
+  EXPECT_THROW(SyntheticDataset::generate(options), runtime_error);
+  options.na_rate = 0;
+  options.class_balance = 1.5;
+  ostringstream out;
+  EXPECT_THROW(SyntheticDataset::write(options, out), runtime_error);
+}
@@ -0,0 +1,46 @@
+#include "tests.h"
+#include <atomic>
+#include "thread_pool.h"
+
+using namespace fuzzy_coco;
+
+TEST(ThreadPool, run) {
+  EXPECT_GE(ThreadPool::hardware_concurrency(), 1);
+
+  for (int nb_threads : {0, 1, 2, 4}) {
+    ThreadPool pool(nb_threads);
+    EXPECT_EQ(pool.size(), max(nb_threads, 1));
+
+    // several batches with the same pool
+    for (int nb_tasks : {0, 1, 3, 100}) {
+      vector<int> res(nb_tasks, -1);
+      atomic<int> nb_bad_workers(0);
+      pool.run(nb_tasks, [&](int task_idx, int worker_idx) {
+        if (worker_idx < 0 || worker_idx >= pool.size()) nb_bad_workers++;
+        res[task_idx] = task_idx * task_idx;
+      });
+      EXPECT_EQ(nb_bad_workers, 0);
+      for (int i = 0; i < nb_tasks; i++)
+        EXPECT_EQ(res[i], i * i);
+    }
+  }
+}
+
+TEST(ThreadPool, exceptions) {
+  for (int nb_threads : {1, 3}) {
+    ThreadPool pool(nb_threads);
+    atomic<int> nb_done(0);
+    EXPECT_THROW(pool.run(50, [&](int task_idx, int) { 
+      nb_done++; 
+      if (task_idx % 10 == 7) throw runtime_error("task error"); 
+    }), runtime_error);
+    if (nb_threads > 1) {
+      EXPECT_EQ(nb_done, 50); // all tasks are run anyway
+    }
+
+    // the pool is still usable
+    vector<int> res(10, 0);
+    pool.run(10, [&](int task_idx, int) { res[task_idx] = 1; });
+    EXPECT_EQ(res, vector<int>(10, 1));
+  }
+}